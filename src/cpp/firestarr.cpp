@@ -16,6 +16,7 @@
 #include "fs/TimeUtil.h"
 #include "fs/Util.h"
 #include "fs/Weather.h"
+#include "fs/WeatherFile.h"
 #include "version.h"
 namespace fs
 {
@@ -58,6 +59,13 @@ int main(const int argc, const char* const argv[])
       logging::debug("Compiled on: {:s}", COMPILED_ON);
       parser.show_help_and_exit();
     }
+    if (settings.is_convert_weather())
+    {
+      // just converting so don't need output directory or log file
+      return fs::convert_weather(
+        settings.wx_file_name.canonical(), settings.wx_output_file_name
+      );
+    }
     // HACK: know saving settings made output_directory already
     static const auto dir_out = settings.output_directory;
     static const auto dir_log = settings.log_directory();
@@ -80,6 +88,13 @@ int main(const int argc, const char* const argv[])
     logging::debug("Compiled on: {:s}", COMPILED_ON);
     logging::note("Output directory is {:s}", settings.output_directory);
     logging::note("Output log is {:s}", settings.log_file);
+    if (settings.is_merge())
+    {
+      parser.log_args();
+      result = Model::mergeShards(settings.output_directory, settings.shard_files);
+      logging::close_log_file();
+      return result;
+    }
     // at this point we've parsed positional args and know we're not in test mode
     if (!parser.was_parsed("--apcp_prev"))
     {
@@ -0,0 +1,70 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#include "Arena.h"
+namespace fs
+{
+Arena::Blocks::Blocks(const size_t block_size) noexcept
+  : block_size_(block_size)
+{ }
+void* Arena::Blocks::do_allocate(const size_t bytes, const size_t alignment)
+{
+  while (current_ < blocks_.size())
+  {
+    auto& block = blocks_[current_];
+    void* p = block.data.get() + offset_;
+    auto space = block.size - offset_;
+    if (nullptr != std::align(alignment, bytes, p, space))
+    {
+      offset_ = block.size - space + bytes;
+      return p;
+    }
+    // doesn't fit so move on and leave rest of this block unused until release()
+    ++current_;
+    offset_ = 0;
+  }
+  // double each time so the number of blocks stays small
+  const auto size =
+    max(bytes + alignment, blocks_.empty() ? block_size_ : blocks_.back().size * 2);
+  blocks_.push_back(Block{make_unique<std::byte[]>(size), size});
+  capacity_ += size;
+  current_ = blocks_.size() - 1;
+  void* p = blocks_.back().data.get();
+  auto space = size;
+  p = std::align(alignment, bytes, p, space);
+  offset_ = size - space + bytes;
+  return p;
+}
+void Arena::Blocks::release() noexcept
+{
+  current_ = 0;
+  offset_ = 0;
+}
+Arena::Arena(const size_t block_size) noexcept
+  : blocks_(block_size), pool_(&blocks_)
+{ }
+void* Arena::do_allocate(const size_t bytes, const size_t alignment)
+{
+  ++allocations_;
+  bytes_ += bytes;
+  peak_bytes_ = max(peak_bytes_, bytes_);
+  return pool_.allocate(bytes, alignment);
+}
+void Arena::do_deallocate(void* p, const size_t bytes, const size_t alignment)
+{
+  bytes_ -= bytes;
+  pool_.deallocate(p, bytes, alignment);
+}
+void Arena::release() noexcept
+{
+  // pool gives its memory back to blocks, which just forget about it
+  pool_.release();
+  blocks_.release();
+  allocations_ = 0;
+  bytes_ = 0;
+  peak_bytes_ = 0;
+}
+size_t Arena::allocations() const noexcept { return allocations_; }
+size_t Arena::bytes() const noexcept { return bytes_; }
+size_t Arena::peakBytes() const noexcept { return peak_bytes_; }
+size_t Arena::blocks() const noexcept { return blocks_.count(); }
+size_t Arena::capacity() const noexcept { return blocks_.capacity(); }
+}
@@ -0,0 +1,157 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#ifndef FS_ARENA_H
+#define FS_ARENA_H
+#include "stdafx.h"
+namespace fs
+{
+/**
+ * \brief Memory resource for one Scenario that reuses freed memory and keeps its blocks until
+ * destroyed.
+ *
+ * Memory comes from a pool so nodes that get freed during a run are reused, and the pool takes
+ * its memory from blocks that are never returned to the heap. release() makes all blocks
+ * available again at once, so once the blocks are large enough for the most that is in use at
+ * one time nothing more needs to come from the heap. Only the thread running the Scenario uses
+ * this, so nothing is locked.
+ */
+class Arena final : public std::pmr::memory_resource
+{
+public:
+  /**
+   * \brief Size of first block (bytes)
+   */
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+  /**
+   * \brief Constructor
+   * \param block_size Size of first block (bytes)
+   */
+  explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE) noexcept;
+  ~Arena() override = default;
+  Arena(const Arena& rhs) = delete;
+  Arena(Arena&& rhs) = delete;
+  Arena& operator=(const Arena& rhs) = delete;
+  Arena& operator=(Arena&& rhs) = delete;
+  /**
+   * \brief Make all memory available again without returning any blocks to the heap
+   *
+   * Anything using memory from this must already be destroyed or empty.
+   */
+  void release() noexcept;
+  /**
+   * \brief Number of allocations since last release()
+   * \return Number of allocations since last release()
+   */
+  [[nodiscard]] size_t allocations() const noexcept;
+  /**
+   * \brief Number of bytes allocated and not freed yet
+   * \return Number of bytes allocated and not freed yet
+   */
+  [[nodiscard]] size_t bytes() const noexcept;
+  /**
+   * \brief Most bytes that were allocated and not freed yet at once since last release()
+   * \return Most bytes that were allocated and not freed yet at once since last release()
+   */
+  [[nodiscard]] size_t peakBytes() const noexcept;
+  /**
+   * \brief Number of blocks that have been allocated from the heap
+   * \return Number of blocks that have been allocated from the heap
+   */
+  [[nodiscard]] size_t blocks() const noexcept;
+  /**
+   * \brief Number of bytes in blocks that have been allocated from the heap
+   * \return Number of bytes in blocks that have been allocated from the heap
+   */
+  [[nodiscard]] size_t capacity() const noexcept;
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+  /**
+   * \brief Memory resource that hands out memory from blocks and never frees anything
+   */
+  class Blocks final : public std::pmr::memory_resource
+  {
+  public:
+    /**
+     * \brief Constructor
+     * \param block_size Size of first block (bytes)
+     */
+    explicit Blocks(size_t block_size) noexcept;
+    /**
+     * \brief Make all blocks available again without returning any to the heap
+     */
+    void release() noexcept;
+    /**
+     * \brief Number of blocks that have been allocated from the heap
+     * \return Number of blocks that have been allocated from the heap
+     */
+    [[nodiscard]] size_t count() const noexcept { return blocks_.size(); }
+    /**
+     * \brief Number of bytes in blocks that have been allocated from the heap
+     * \return Number of bytes in blocks that have been allocated from the heap
+     */
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+  private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override { }
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+      return this == &other;
+    }
+    /**
+     * \brief Memory allocated from the heap
+     */
+    struct Block
+    {
+      uptr<std::byte[]> data;
+      size_t size;
+    };
+    /**
+     * \brief Size of first block (bytes)
+     */
+    size_t block_size_;
+    /**
+     * \brief Blocks that have been allocated from the heap
+     */
+    vector<Block> blocks_{};
+    /**
+     * \brief Index of block currently being allocated from
+     */
+    size_t current_{0};
+    /**
+     * \brief Offset of first free byte in current block
+     */
+    size_t offset_{0};
+    /**
+     * \brief Number of bytes in all blocks
+     */
+    size_t capacity_{0};
+  };
+  /**
+   * \brief Blocks that the pool gets memory from
+   */
+  Blocks blocks_;
+  /**
+   * \brief Pool that reuses memory that gets freed
+   */
+  std::pmr::unsynchronized_pool_resource pool_;
+  /**
+   * \brief Number of allocations since last release()
+   */
+  size_t allocations_{0};
+  /**
+   * \brief Number of bytes allocated and not freed yet
+   */
+  size_t bytes_{0};
+  /**
+   * \brief Most bytes that were allocated and not freed yet at once since last release()
+   */
+  size_t peak_bytes_{0};
+};
+}
+#endif
@@ -439,7 +439,21 @@ static const Usage USAGE_TEST{
   "Run test cases and save output in the specified directory",
   "test <output_dir>"
 };
-static const vector<Usage> DEFAULT_USAGES{USAGE_MAIN, USAGE_SURFACE, USAGE_TEST};
+static const Usage USAGE_CONVERT_WEATHER{
+  "Convert weather .csv into binary format that can be read without parsing",
+  "convert-wx <wx.csv> <wx.fsw>"
+};
+static const Usage USAGE_MERGE{
+  "Merge shards of a run into outputs in the specified directory",
+  "merge <output_dir> <shard.fsp> [<shard.fsp> ...]"
+};
+static const vector<Usage> DEFAULT_USAGES{
+  USAGE_MAIN,
+  USAGE_SURFACE,
+  USAGE_TEST,
+  USAGE_CONVERT_WEATHER,
+  USAGE_MERGE
+};
 Settings& SettingsArgumentParser::parse_args() { return ArgumentParser::parse_args(); }
 MainArgumentParser::MainArgumentParser(const int argc, const char* const argv[])
   : SettingsArgumentParser(DEFAULT_USAGES, argc, argv)
@@ -461,6 +475,18 @@ MainArgumentParser::MainArgumentParser(const int argc, const char* const argv[])
     cur_arg_ += 1;
     skipped_args_ = 1;
   }
+  if (arguments_.size() > 1 && 0 == strcmp(arguments_.at(1).c_str(), "convert-wx"))
+  {
+    settings.mode = Mode::ConvertWeather;
+    cur_arg_ += 1;
+    skipped_args_ = 1;
+  }
+  if (arguments_.size() > 1 && 0 == strcmp(arguments_.at(1).c_str(), "merge"))
+  {
+    settings.mode = Mode::Merge;
+    cur_arg_ += 1;
+    skipped_args_ = 1;
+  }
   if (Mode::Test == settings.mode)
   {
     // defaults for test mode - no way to specify others right now
@@ -502,6 +528,21 @@ MainArgumentParser::MainArgumentParser(const int argc, const char* const argv[])
       settings.force_no_greenup, true, "--force-no-greenup", "Force no green up for all fires"
     );
   }
+  else if (Mode::ConvertWeather == settings.mode)
+  {
+    logging::note("Converting weather file");
+  }
+  else if (Mode::Merge == settings.mode)
+  {
+    logging::note("Merging shards");
+    register_flag(
+      settings.save_intensity, false, "--no-intensity", "Do not output intensity grids"
+    );
+    register_flag(
+      settings.save_probability, false, "--no-probability", "Do not output probability grids"
+    );
+    register_flag(settings.save_occurrence, true, "--occurrence", "Output occurrence grids");
+  }
   else
   {
     register_flag(settings.save_individual, true, "-i", "Save individual maps for simulations");
@@ -546,6 +587,34 @@ MainArgumentParser::MainArgumentParser(const int argc, const char* const argv[])
       false,
       &parse_size_t
     );
+    register_setter<size_t>(
+      settings.offset_memo_size,
+      "--offset-memo",
+      "Remember specified number of spread offset sets per thread",
+      false,
+      &parse_size_t
+    );
+    register_setter<MathSize>(
+      settings.offset_memo_step,
+      "--offset-memo-step",
+      "Quantize spread inputs to specified relative step before reusing offsets",
+      false,
+      &parse_value<MathSize>
+    );
+    register_setter<size_t>(
+      settings.spread_rate_classes,
+      "--rate-classes",
+      "Let specified number of spread rate classes advance with their own step",
+      false,
+      &parse_size_t
+    );
+    register_setter<size_t>(
+      settings.memory_limit_mb,
+      "--memory-limit",
+      "Only start scenarios while running ones are estimated to use less than specified MB",
+      false,
+      &parse_size_t
+    );
     if (Mode::Surface == settings.mode)
     {
       logging::note("Running in probability surface mode");
@@ -566,8 +635,68 @@ MainArgumentParser::MainArgumentParser(const int argc, const char* const argv[])
         "--deterministic",
         "Run deterministically (100% chance of spread & survival)"
       );
+      register_flag(
+        settings.travel_time,
+        true,
+        "--travel-time",
+        "Find arrival times as shortest paths through grid (only with --deterministic)"
+      );
       register_setter<
         ThresholdSize>(settings.confidence_level, "--confidence", "Use specified confidence level", false, &parse_value<ThresholdSize>);
+      register_setter<ThresholdSize>(
+        settings.maximum_probability_error,
+        "--probability-error",
+        "Stop when standard error of burn probability for last date is below specified value",
+        false,
+        &parse_value<ThresholdSize>
+      );
+      register_flag(
+        settings.probability_error_mean,
+        true,
+        "--probability-error-mean",
+        "Use root mean square instead of maximum error over burned cells"
+      );
+      register_setter<string>(
+        [&](const auto v) {
+          const auto strata = stol(v);
+          logging::check_fatal(strata < 1, "Strata must be at least 1 but got {:s}", v);
+          settings.threshold_strata = static_cast<size_t>(strata);
+        },
+        "--strata",
+        "Stratify scenario and daily thresholds into specified number of strata",
+        false,
+        &parse_string
+      );
+      register_setter<size_t>(
+        settings.checkpoint_interval_seconds,
+        "--checkpoint",
+        "Save checkpoint that run can be resumed from every specified number of seconds",
+        false,
+        &parse_size_t
+      );
+      register_path_setter(
+        settings.resume, "--resume", "Continue run from specified checkpoint", false
+      );
+      register_setter<string>(
+        [&](const auto v) {
+          const auto slash = v.find('/');
+          logging::check_fatal(string::npos == slash, "Shard must be given as i/n but got {:s}", v);
+          settings.shard_index = stoul(v.substr(0, slash));
+          settings.shard_count = stoul(v.substr(slash + 1));
+          logging::check_fatal(
+            settings.shard_index >= settings.shard_count,
+            "Shard {:d} is not one of {:d} shards",
+            settings.shard_index,
+            settings.shard_count
+          );
+        },
+        "--shard",
+        "Only run shard i (0 based) of n shards of iterations and save counts (as i/n). Shards "
+        "always run until MAXIMUM_SIMULATIONS, so merged outputs only match a run that isn't "
+        "split if it also runs until then",
+        false,
+        &parse_string
+      );
       register_path_setter(settings.perimeter, "--perim", "Start from perimeter", false);
       register_setter<size_t>(
         settings.initial_size, "--size", "Start from size", false, &parse_size_t
@@ -599,6 +728,20 @@ Settings& MainArgumentParser::parse_args()
   {
     return settings;
   }
+  if (settings.is_convert_weather())
+  {
+    // "./firestarr convert-wx <wx.csv> <wx.fsw> [-v | -q]"
+    // HACK: don't call done_positional() since there's no output directory to save settings to
+    settings.wx_file_name =
+      LazyPath{std::filesystem::current_path().generic_string(), get_positional()};
+    settings.wx_output_file_name = get_positional();
+    if (has_positional())
+    {
+      logging::error("Too many positional arguments");
+      show_usage_and_exit();
+    }
+    return settings;
+  }
   // fs::show_debug_settings();
   // parse positional arguments
   // output directory is always the first thing
@@ -616,12 +759,33 @@ Settings& MainArgumentParser::parse_args()
   // if name starts with "/" then it's an absolute path, otherwise append to working directory
   settings.log_file = (settings.log_file_name.starts_with("/") ? "" : settings.output_directory)
                     + settings.log_file_name;
+  if (settings.is_merge())
+  {
+    // "./firestarr merge <output_dir> <shard.fsp> [<shard.fsp> ...] [-v | -q]"
+    while (has_positional())
+    {
+      settings.shard_files.push_back(get_positional());
+    }
+    if (settings.shard_files.empty())
+    {
+      logging::error("No shards to merge");
+      show_usage_and_exit();
+    }
+    done_positional();
+    return settings;
+  }
   // HACK: ensure settings initialized before doing this
   // probabalistic surface is computationally impossible at this point
   if (settings.is_surface())
   {
     settings.deterministic = true;
   }
+  // travel time doesn't use spread thresholds or survival, so it can't be probabilistic
+  // (test mode is always deterministic)
+  logging::check_fatal(
+    settings.travel_time && !settings.deterministic && !settings.is_test(),
+    "Finding arrival times by travel time only works with --deterministic"
+  );
   if (!settings.is_test())
   {
     // handle surface/simulation positional arguments
@@ -5,15 +5,22 @@ namespace fs
 {
 BurnedData::BurnedData(const CellGrid& cells) noexcept
   : data_{from_grid(cells, [](const auto& v) { return fuel_by_code(v.fuelCode()); })},
-    cell_size_{cells.cellSize()}, unburnable_(data_->count()), height_{cells.height()},
-    width_{cells.width()}
+    cell_size_{cells.cellSize()}, height_{cells.height()}, width_{cells.width()}
 { }
 BurnedData::BurnedData(const FuelGrid& fuel) noexcept
   : data_{from_grid(fuel, [](const auto& v) { return v; })}, cell_size_{fuel.cellSize()},
-    unburnable_(data_->count()), height_{fuel.height()}, width_{fuel.width()}
+    height_{fuel.height()}, width_{fuel.width()}
 { }
 bool BurnedData::at(const XYIdx& xy) const noexcept { return (*data_)[to_index(xy)]; }
-void BurnedData::set(const XYIdx& xy) noexcept { data_->set(to_index(xy)); }
+void BurnedData::set(const XYIdx& xy) noexcept
+{
+  const auto i = to_index(xy);
+  if (!(*data_)[i])
+  {
+    data_->set(i);
+    set_.push_back(i);
+  }
+}
 void BurnedData::clear() noexcept
 {
   if (nullptr == data_)
@@ -24,26 +31,43 @@ void BurnedData::clear() noexcept
   {
     data_->reset();
   }
-  unburnable_ = data_->count();
+  source_ = nullptr;
+  set_.clear();
+}
+void BurnedData::revert(const BurnedData& rhs) noexcept
+{
+  if (nullptr == data_ || nullptr == rhs.data_ || source_ != rhs.origin())
+  {
+    *this = rhs;
+    return;
+  }
+  // only cells that were set can be different, so no need to copy the whole grid
+  for (const auto i : set_)
+  {
+    (*data_)[i] = (*rhs.data_)[i];
+  }
+  set_ = rhs.set_;
 }
 BurnedData::BurnedData(const BurnedData& rhs) noexcept
   : data_{nullptr == rhs.data_ ? nullptr : make_unique<dtype>(*rhs.data_)},
-    cell_size_{rhs.cell_size_}, unburnable_{rhs.unburnable_}, height_{rhs.height_},
+    cell_size_{rhs.cell_size_}, source_{rhs.origin()}, set_{rhs.set_}, height_{rhs.height_},
     width_{rhs.width_}
 { }
 BurnedData::BurnedData(BurnedData&& rhs) noexcept
   : data_(nullptr == rhs.data_ ? nullptr : std::move(rhs.data_)), cell_size_{rhs.cell_size_},
-    unburnable_{rhs.unburnable_}, height_{rhs.height_}, width_{rhs.width_}
+    source_{rhs.source_}, set_{std::move(rhs.set_)}, height_{rhs.height_}, width_{rhs.width_}
 {
   rhs.data_ = nullptr;
-  rhs.unburnable_ = 0;
+  rhs.source_ = nullptr;
+  rhs.set_.clear();
   rhs.height_ = 0;
   rhs.width_ = 0;
 }
 BurnedData& BurnedData::operator=(const BurnedData& rhs) noexcept
 {
   cell_size_ = rhs.cell_size_;
-  unburnable_ = rhs.unburnable_;
+  source_ = rhs.origin();
+  set_ = rhs.set_;
   height_ = rhs.height_;
   width_ = rhs.width_;
   if (nullptr == rhs.data_)
@@ -61,7 +85,8 @@ BurnedData& BurnedData::operator=(const BurnedData& rhs) noexcept
 BurnedData& BurnedData::operator=(BurnedData&& rhs) noexcept
 {
   cell_size_ = rhs.cell_size_;
-  unburnable_ = rhs.unburnable_;
+  source_ = rhs.source_;
+  set_ = std::move(rhs.set_);
   height_ = rhs.height_;
   width_ = rhs.width_;
   if (nullptr == rhs.data_)
@@ -71,7 +96,8 @@ BurnedData& BurnedData::operator=(BurnedData&& rhs) noexcept
   }
   data_ = std::move(rhs.data_);
   rhs.data_ = nullptr;
-  rhs.unburnable_ = 0;
+  rhs.source_ = nullptr;
+  rhs.set_.clear();
   rhs.height_ = 0;
   rhs.width_ = 0;
   return *this;
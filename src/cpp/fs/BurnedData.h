@@ -14,6 +14,11 @@ public:
   bool at(const XYIdx& h) const noexcept;
   void set(const XYIdx& h) noexcept;
   void clear() noexcept;
+  /**
+   * \brief Undo everything set since this was a copy of rhs, copying all of rhs if it never was
+   * \param rhs BurnedData that this was copied from
+   */
+  void revert(const BurnedData& rhs) noexcept;
   BurnedData() noexcept = default;
   BurnedData(const BurnedData& rhs) noexcept;
   BurnedData(BurnedData&& rhs) noexcept;
@@ -30,7 +35,16 @@ public:
     // we know that every cell is a key, so we convert that to hectares
     const MathSize per_width = (cell_size_ / 100.0);
     // size of fire is number of bits set * cell size
-    return static_cast<MathSize>(data_->count() - unburnable_) * per_width * per_width;
+    return static_cast<MathSize>(set_.size()) * per_width * per_width;
+  }
+  /**
+   * \brief Estimate of memory used by this (bytes)
+   * \return Estimate of memory used by this (bytes)
+   */
+  [[nodiscard]] size_t memoryUsed() const noexcept
+  {
+    // only has its own bitset if it isn't a copy of something else
+    return (nullptr == data_ ? 0 : sizeof(dtype)) + set_.capacity() * sizeof(size_t);
   }
 
 private:
@@ -39,7 +53,21 @@ private:
   uptr<dtype> data_{nullptr};
   static uptr<dtype> from_grid(auto& grid, auto fct);
   MathSize cell_size_{-1};
-  size_t unburnable_{0};
+  /**
+   * \brief Data that this is a copy of, aside from what is in set_
+   */
+  [[nodiscard]] const dtype* origin() const noexcept
+  {
+    return nullptr == source_ ? data_.get() : source_;
+  }
+  /**
+   * \brief Data that this was copied from, or nullptr if it wasn't
+   */
+  const dtype* source_{nullptr};
+  /**
+   * \brief Indices set since origin(), so they can be counted and undone
+   */
+  vector<size_t> set_{};
   Idx height_{};
   Idx width_{};
 };
@@ -450,6 +450,13 @@ class CellPointsMap
 {
 public:
   CellPointsMap() noexcept = default;
+  /**
+   * \brief Construct empty CellPointsMap that allocates from the given memory resource
+   * \param resource Memory resource to allocate from
+   */
+  explicit CellPointsMap(std::pmr::memory_resource* resource) noexcept
+    : cells_(resource)
+  { }
   CellPointsMap& merge(const BurnedData& unburnable, const CellPointsMap& rhs) noexcept
   {
     // FIX: if we iterate through both they should be sorted
@@ -491,7 +498,7 @@ public:
     }
     return r;
   }
-  using map_type = std::map<XYIdx, CellPoints>;
+  using map_type = std::pmr::map<XYIdx, CellPoints>;
   using map_value = map_type::value_type;
   // apply function to each CellPoints within and remove matches
   void remove_if(std::function<bool(const map_value&)> F) noexcept { std::erase_if(cells_, F); }
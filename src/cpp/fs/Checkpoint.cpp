@@ -0,0 +1,20 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#include "Checkpoint.h"
+namespace fs::checkpoint
+{
+void write_engine(ostream& out, const mt19937_64& engine)
+{
+  // use the text form the standard defines so state is the same on every platform
+  ostringstream text{};
+  text << engine;
+  const auto state = text.str();
+  write_values(out, vector<char>{state.begin(), state.end()});
+}
+void read_engine(std::istream& in, mt19937_64* engine)
+{
+  const auto state = read_values<char>(in);
+  istringstream text{string{state.begin(), state.end()}};
+  text >> *engine;
+  logging::check_fatal(text.fail(), "Invalid random number state in checkpoint");
+}
+}
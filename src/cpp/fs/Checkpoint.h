@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#ifndef FS_CHECKPOINT_H
+#define FS_CHECKPOINT_H
+#include "stdafx.h"
+#include "Log.h"
+namespace fs::checkpoint
+{
+/**
+ * \brief Write a value to a checkpoint as its bytes
+ * \param out Stream to write to
+ * \param value Value to write
+ */
+template <class T>
+void write_value(ostream& out, const T& value)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  out.write(reinterpret_cast<const char*>(&value), sizeof value);
+}
+/**
+ * \brief Read a value that was written by write_value()
+ * \param in Stream to read from
+ * \return Value that was read
+ */
+template <class T>
+[[nodiscard]] T read_value(std::istream& in)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  T value{};
+  in.read(reinterpret_cast<char*>(&value), sizeof value);
+  logging::check_fatal(in.fail(), "Checkpoint ended unexpectedly");
+  return value;
+}
+/**
+ * \brief Write number of values and then all the values to a checkpoint
+ * \param out Stream to write to
+ * \param values Values to write
+ */
+template <class T>
+void write_values(ostream& out, const vector<T>& values)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  write_value<uint64_t>(out, values.size());
+  out.write(reinterpret_cast<const char*>(values.data()), sizeof(T) * values.size());
+}
+/**
+ * \brief Read values that were written by write_values()
+ * \param in Stream to read from
+ * \return Values that were read
+ */
+template <class T>
+[[nodiscard]] vector<T> read_values(std::istream& in)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  vector<T> values(static_cast<size_t>(read_value<uint64_t>(in)));
+  in.read(reinterpret_cast<char*>(values.data()), sizeof(T) * values.size());
+  logging::check_fatal(in.fail(), "Checkpoint ended unexpectedly");
+  return values;
+}
+/**
+ * \brief Write state of a random number engine to a checkpoint
+ * \param out Stream to write to
+ * \param engine Engine to write state of
+ */
+void write_engine(ostream& out, const mt19937_64& engine);
+/**
+ * \brief Read state of a random number engine that was written by write_engine()
+ * \param in Stream to read from
+ * \param engine Engine to restore state of
+ */
+void read_engine(std::istream& in, mt19937_64* engine);
+}
+#endif
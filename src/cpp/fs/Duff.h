@@ -68,12 +68,30 @@ struct Duff
    * \return Probability of survival (% / 100) [eq Ig-1]
    */
   [[nodiscard]] ThresholdSize probabilityOfSurvival(const MathSize mc_pct) const noexcept
+  {
+    return survivalFromExp(exp(survivalExponent(mc_pct)));
+  }
+  /**
+   * \brief Exponent in probability of survival equation [eq Ig-1]
+   * \param mc_pct Moisture content, percentage dry oven weight
+   * \return Exponent in probability of survival equation [eq Ig-1]
+   */
+  [[nodiscard]] MathSize survivalExponent(const MathSize mc_pct) const noexcept
   {
     /**
      * \brief Constant part of ignition probability equation [eq Ig-1]
      */
     const auto ConstantPart = b0 + b2 * ash + b3 * rho;
-    const auto d = 1 + exp(-(b1 * mc_pct + ConstantPart));
+    return -(b1 * mc_pct + ConstantPart);
+  }
+  /**
+   * \brief Probability of survival (% / 100) from e raised to survivalExponent() [eq Ig-1]
+   * \param exp_value e raised to survivalExponent()
+   * \return Probability of survival (% / 100) [eq Ig-1]
+   */
+  [[nodiscard]] static ThresholdSize survivalFromExp(const MathSize exp_value) noexcept
+  {
+    const auto d = 1 + exp_value;
     if (0 == d)
     {
       return 1.0;
@@ -1183,6 +1183,15 @@ public:
    * \brief Is fuel a valid fuel type
    */
   [[nodiscard]] bool isValid() const override { return true; }
+  /**
+   * \brief Fuel to use for calculations depending on green-up
+   * \param nd Difference between date and the date of minimum foliar moisture content
+   * \return Fuel to use for calculations depending on green-up
+   */
+  [[nodiscard]] const FuelType& forSeason(const int nd) const noexcept override
+  {
+    return find_fuel_by_season(nd, *this);
+  }
   /**
    * \brief BUI Effect on surface fire rate of spread [ST-X-3 eq 54]
    * \param bui Build-up Index
@@ -1327,6 +1336,17 @@ public:
   {
     return spring().survivalProbability(wx);
   }
+  /**
+   * \brief Survival probability for many FwiWeather at once
+   * \param wx FwiWeather to calculate survival probability for
+   * \param count Number of FwiWeather
+   * \param results Array to put chance of survival (% / 100) for each FwiWeather into
+   */
+  void survivalProbabilities(const FwiWeather* wx, const size_t count, ThresholdSize* results)
+    const noexcept override
+  {
+    spring().survivalProbabilities(wx, count, results);
+  }
   /**
    * \brief Fuel to use before green-up
    * \return Fuel to use before green-up
@@ -131,11 +131,18 @@ static MathSize day_length(const MathSize latitude, const int month) noexcept
   }
   exit(logging::fatal("Unable to calculate DayLength"));
 }
-MathSize find_m(
+// daily and hourly methods only differ by how fast moisture changes and how much rain is
+// intercepted by the canopy
+static constexpr MathSize RATE_DAILY = 0.581;
+static constexpr MathSize RATE_HOURLY = 0.0579;
+static constexpr MathSize INTERCEPTED_DAILY = 0.5;
+static constexpr MathSize INTERCEPTED_HOURLY = 0.0;
+static MathSize find_m(
   const Temperature temperature,
   const RelativeHumidity rh,
   const Speed wind,
-  const MathSize mo
+  const MathSize mo,
+  const MathSize rate
 ) noexcept
 {
   //'''/* 4  '*/
@@ -147,7 +154,7 @@ MathSize find_m(
     const auto ko = 0.424 * (1.0 - pow(rh.value / 100.0, 1.7))
                   + 0.0694 * sqrt(wind.value) * (1.0 - pow_int<8>(rh.value / 100.0));
     //'''/* 6b '*/
-    const auto kd = ko * 0.581 * exp(0.0365 * temperature.value);
+    const auto kd = ko * rate * exp(0.0365 * temperature.value);
     //'''/* 8  '*/
     return ed + (mo - ed) * pow(10.0, -kd);
   }
@@ -160,12 +167,37 @@ MathSize find_m(
     const auto kl = 0.424 * (1.0 - pow((100.0 - rh.value) / 100.0, 1.7))
                   + 0.0694 * sqrt(wind.value) * (1 - pow_int<8>((100.0 - rh.value) / 100.0));
     //'''/* 7b '*/
-    const auto kw = kl * 0.581 * exp(0.0365 * temperature.value);
+    const auto kw = kl * rate * exp(0.0365 * temperature.value);
     //'''/* 9  '*/
     return ew - (ew - mo) * pow(10.0, -kw);
   }
   return mo;
 }
+static MathSize wet_moisture(
+  const MathSize mo,
+  const Precipitation rain,
+  const MathSize intercepted
+) noexcept
+{
+  if (rain.value > intercepted)
+  {
+    //'''/* 2  '*/
+    const auto rf = rain.value - intercepted;
+    //'''/* 3a '*/
+    auto mr = mo + 42.5 * rf * (exp(-100.0 / (251.0 - mo))) * (1 - exp(-6.93 / rf));
+    if (mo > 150.0)
+    {
+      //'''/* 3b '*/
+      mr += 0.0015 * pow_int<2>(mo - 150.0) * sqrt(rf);
+    }
+    if (mr > 250.0)
+    {
+      mr = 250.0;
+    }
+    return mr;
+  }
+  return mo;
+}
 //******************************************************************************************
 // Function Name: FFMC
 // Description: Calculates today's Fine Fuel Moisture Code
@@ -185,29 +217,23 @@ Ffmc::Ffmc(
 ) noexcept
   : Ffmc{[=]() {
       //'''/* 1  '*/
-      auto mo = ffmc_to_moisture(ffmc_previous);
-      if (rain.value > 0.5)
-      {
-        //'''/* 2  '*/
-        const auto rf = rain.value - 0.5;
-        //'''/* 3a '*/
-        auto mr = mo + 42.5 * rf * (exp(-100.0 / (251.0 - mo))) * (1 - exp(-6.93 / rf));
-        if (mo > 150.0)
-        {
-          //'''/* 3b '*/
-          mr += 0.0015 * pow_int<2>(mo - 150.0) * sqrt(rf);
-        }
-        if (mr > 250.0)
-        {
-          mr = 250.0;
-        }
-        mo = mr;
-      }
-      const auto m = find_m(temperature, rh, wind, mo);
+      const auto mo = wet_moisture(ffmc_to_moisture(ffmc_previous), rain, INTERCEPTED_DAILY);
+      const auto m = find_m(temperature, rh, wind, mo, RATE_DAILY);
       //'''/* 10 '*/
       return moisture_to_ffmc(m).value;
     }()}
 { }
+Ffmc hourly_ffmc(
+  const Temperature temperature,
+  const RelativeHumidity rh,
+  const Speed wind,
+  const Precipitation rain,
+  const Ffmc ffmc_previous
+) noexcept
+{
+  const auto mo = wet_moisture(ffmc_to_moisture(ffmc_previous), rain, INTERCEPTED_HOURLY);
+  return moisture_to_ffmc(find_m(temperature, rh, wind, mo, RATE_HOURLY));
+}
 //******************************************************************************************
 // Function Name: DMC
 // Description: Calculates today's Duff Moisture Code
@@ -509,4 +535,266 @@ Dsr::Dsr(const Fwi fwi) noexcept
 {
   return exp((dmc.value - 244.72) / -43.43) + 20;
 }
+FwiColumns::FwiColumns(const size_t members)
+  : temperature(members), rh(members), wind(members), prec(members), ffmc(members),
+    dmc(members), dc(members), isi(members), bui(members), fwi(members)
+{ }
+// Batch versions of the equations above do each step for every member before the next step.
+// exp(), log() and pow() go through the vector kernels for all members, so they get
+// calculated for both sides of a branch and each member picks the one it uses. Inputs for
+// the side that isn't used are replaced with something harmless so nothing overflows. The
+// rest still branches for each member, and every step makes new vectors for its results.
+/**
+ * \brief Calculate a value for every member
+ * \param count Number of members
+ * \param fct Function that calculates value for member at index
+ * \return Value for every member
+ */
+template <class F>
+static vector<MathSize> each(const size_t count, F fct)
+{
+  vector<MathSize> results(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    results[i] = fct(i);
+  }
+  return results;
+}
+static vector<MathSize> exp_of(const vector<MathSize>& values)
+{
+  vector<MathSize> results(values.size());
+  vector_exp(values.data(), results.data(), values.size());
+  return results;
+}
+static vector<MathSize> log_of(const vector<MathSize>& values)
+{
+  vector<MathSize> results(values.size());
+  vector_log(values.data(), results.data(), values.size());
+  return results;
+}
+static vector<MathSize> pow_of(const vector<MathSize>& bases, const vector<MathSize>& exponents)
+{
+  vector<MathSize> results(bases.size());
+  vector_pow(bases.data(), exponents.data(), results.data(), bases.size());
+  return results;
+}
+static vector<MathSize> pow_of(const vector<MathSize>& bases, const MathSize exponent)
+{
+  return pow_of(bases, vector<MathSize>(bases.size(), exponent));
+}
+static vector<MathSize> wet_moisture(const FwiColumns& c, const MathSize intercepted)
+{
+  const auto n = c.size();
+  //'''/* 1  '*/
+  const auto mo = each(n, [&](const size_t i) { return ffmc_to_moisture(c.ffmc[i]); });
+  const auto is_wet = [&](const size_t i) { return c.prec[i] > intercepted; };
+  //'''/* 2  '*/
+  const auto rf = each(n, [&](const size_t i) {
+    return is_wet(i) ? c.prec[i] - intercepted : 1.0;
+  });
+  const auto e_mo = exp_of(each(n, [&](const size_t i) { return -100.0 / (251.0 - mo[i]); }));
+  const auto e_rf = exp_of(each(n, [&](const size_t i) { return -6.93 / rf[i]; }));
+  return each(n, [&](const size_t i) {
+    //'''/* 3a '*/
+    auto mr = mo[i] + 42.5 * rf[i] * e_mo[i] * (1 - e_rf[i]);
+    if (mo[i] > 150.0)
+    {
+      //'''/* 3b '*/
+      mr += 0.0015 * pow_int<2>(mo[i] - 150.0) * sqrt(rf[i]);
+    }
+    return is_wet(i) ? min(mr, 250.0) : mo[i];
+  });
+}
+static vector<MathSize> find_m(
+  const FwiColumns& c,
+  const vector<MathSize>& mo,
+  const MathSize rate
+)
+{
+  const auto n = c.size();
+  const auto rh_dry = each(n, [&](const size_t i) { return c.rh[i] / 100.0; });
+  const auto rh_wet = each(n, [&](const size_t i) { return (100.0 - c.rh[i]) / 100.0; });
+  const auto p_ed = pow_of(c.rh, 0.679);
+  const auto p_ew = pow_of(c.rh, 0.753);
+  const auto p_dry = pow_of(rh_dry, 1.7);
+  const auto p_wet = pow_of(rh_wet, 1.7);
+  const auto e_rh = exp_of(each(n, [&](const size_t i) { return (c.rh[i] - 100.0) / 10.0; }));
+  const auto e_rh_temp = exp_of(each(n, [&](const size_t i) { return -0.115 * c.rh[i]; }));
+  const auto e_temp = exp_of(each(n, [&](const size_t i) { return 0.0365 * c.temperature[i]; }));
+  //'''/* 4  '*/
+  const auto ed = each(n, [&](const size_t i) {
+    return 0.942 * p_ed[i] + 11.0 * e_rh[i]
+         + 0.18 * (21.1 - c.temperature[i]) * (1.0 - e_rh_temp[i]);
+  });
+  //'''/* 5  '*/
+  const auto ew = each(n, [&](const size_t i) {
+    return 0.618 * p_ew[i] + 10.0 * e_rh[i]
+         + 0.18 * (21.1 - c.temperature[i]) * (1.0 - e_rh_temp[i]);
+  });
+  // drying or wetting rate, or 0 if moisture doesn't change
+  const auto k = each(n, [&](const size_t i) {
+    //'''/* 6a '*/
+    const auto ko = 0.424 * (1.0 - p_dry[i])
+                  + 0.0694 * sqrt(c.wind[i]) * (1.0 - pow_int<8>(rh_dry[i]));
+    //'''/* 7a '*/
+    const auto kl = 0.424 * (1.0 - p_wet[i])
+                  + 0.0694 * sqrt(c.wind[i]) * (1 - pow_int<8>(rh_wet[i]));
+    //'''/* 6b, 7b '*/
+    return ((mo[i] > ed[i]) ? ko : ((mo[i] < ew[i]) ? kl : 0.0)) * rate * e_temp[i];
+  });
+  const auto p_k = pow_of(
+    vector<MathSize>(n, 10.0), each(n, [&](const size_t i) { return -k[i]; })
+  );
+  return each(n, [&](const size_t i) {
+    //'''/* 8, 9  '*/
+    return (mo[i] > ed[i])   ? ed[i] + (mo[i] - ed[i]) * p_k[i]
+         : (mo[i] < ew[i]) ? ew[i] - (ew[i] - mo[i]) * p_k[i]
+                             : mo[i];
+  });
+}
+static void calculate_ffmc(
+  FwiColumns* columns,
+  const MathSize intercepted,
+  const MathSize rate
+)
+{
+  auto& c = *columns;
+  const auto m = find_m(c, wet_moisture(c, intercepted), rate);
+  //'''/* 10 '*/
+  c.ffmc = each(c.size(), [&](const size_t i) { return moisture_to_ffmc(m[i]).value; });
+}
+static void calculate_dmc(FwiColumns* columns, const int month, const MathSize latitude)
+{
+  auto& c = *columns;
+  const auto n = c.size();
+  const auto is_wet = [&](const size_t i) { return c.prec[i] > 1.5; };
+  const auto e_previous = exp_of(each(n, [&](const size_t i) { return 0.023 * c.dmc[i]; }));
+  const auto log_previous = log_of(c.dmc);
+  const auto mr = each(n, [&](const size_t i) {
+    const auto previous = c.dmc[i];
+    //'''/* 11  '*/
+    const auto re = 0.92 * c.prec[i] - 1.27;
+    //'''/* 12  '*/
+    const auto mo = 20 + 280 / e_previous[i];
+    const auto b = (previous <= 33.0) ?   //'''/* 13a '*/
+                     100.0 / (0.5 + 0.3 * previous)
+                                      : ((previous <= 65.0) ?   //'''/* 13b '*/
+                                           14.0 - 1.3 * log_previous[i]
+                                                            :   //'''/* 13c '*/
+                                           6.2 * log_previous[i] - 17.2);
+    //'''/* 14  '*/
+    return is_wet(i) ? mo + 1000.0 * re / (48.77 + b * re) : 21.0;
+  });
+  const auto log_mr = log_of(each(n, [&](const size_t i) { return mr[i] - 20; }));
+  const auto length = day_length(latitude, month);
+  c.dmc = each(n, [&](const size_t i) {
+    //'''/* 15  '*/
+    const auto pr = 43.43 * (5.6348 - log_mr[i]);
+    const auto previous = is_wet(i) ? max(pr, 0.0) : c.dmc[i];
+    const auto k = (c.temperature[i] > -1.1)
+                   ? 1.894 * (c.temperature[i] + 1.1) * (100.0 - c.rh[i]) * length * 0.0001
+                   : 0.0;
+    //'''/* 17  '*/
+    return previous + k;
+  });
+}
+static void calculate_dc(FwiColumns* columns, const int month, const MathSize latitude)
+{
+  auto& c = *columns;
+  const auto n = c.size();
+  const auto is_wet = [&](const size_t i) { return c.prec[i] > 2.8; };
+  //'/* 19  */
+  const auto e_previous = exp_of(each(n, [&](const size_t i) { return -c.dc[i] / 400.0; }));
+  const auto log_q = log_of(each(n, [&](const size_t i) {
+    //'/* 18  */
+    const auto rd = 0.83 * (c.prec[i]) - 1.27;
+    const auto qo = 800.0 * e_previous[i];
+    //'/* 20  */
+    const auto qr = qo + 3.937 * rd;
+    return is_wet(i) ? 800.0 / qr : 1.0;
+  }));
+  const auto lf = day_length_factor(latitude, month - 1);
+  c.dc = each(n, [&](const size_t i) {
+    //'/* 21  */
+    const auto dr = 400.0 * log_q[i];
+    const auto previous = is_wet(i) ? ((dr > 0.0) ? dr : 0.0) : c.dc[i];
+    //'/* 22  */
+    const auto v =
+      max(0.0, (c.temperature[i] > -2.8) ? 0.36 * (c.temperature[i] + 2.8) + lf : lf);
+    //'/* 23  */
+    // HACK: don't allow negative values
+    return max(0.0, previous + 0.5 * v);
+  });
+}
+static void calculate_isi(FwiColumns* columns)
+{
+  auto& c = *columns;
+  const auto n = c.size();
+  //'''/* 1   '*/
+  const auto mc = each(n, [&](const size_t i) { return ffmc_to_moisture(c.ffmc[i]); });
+  //'''/* 24  '*/
+  const auto f_wind = exp_of(each(n, [&](const size_t i) { return 0.05039 * c.wind[i]; }));
+  const auto e_mc = exp_of(each(n, [&](const size_t i) { return -0.1386 * mc[i]; }));
+  const auto p_mc = pow_of(mc, 5.31);
+  c.isi = each(n, [&](const size_t i) {
+    //'''/* 25  '*/
+    const auto f_f = 91.9 * e_mc[i] * (1 + p_mc[i] / 49300000.0);
+    //'''/* 26  '*/
+    return (0.208 * f_wind[i] * f_f);
+  });
+}
+static void calculate_bui(FwiColumns* columns)
+{
+  auto& c = *columns;
+  const auto n = c.size();
+  const auto p_dmc = pow_of(each(n, [&](const size_t i) { return 0.0114 * c.dmc[i]; }), 1.7);
+  c.bui = each(n, [&](const size_t i) {
+    const auto dmc = c.dmc[i];
+    const auto dc = c.dc[i];
+    if (dmc <= 0.4 * dc)
+    {
+      // HACK: this isn't normally part of it, but it's division by 0 without this
+      //'''/* 27a '*/
+      return (0 == dc) ? 0.0 : max(0.0, 0.8 * dmc * dc / (dmc + 0.4 * dc));
+    }
+    //'''/* 27b '*/
+    return max(0.0, dmc - (1.0 - 0.8 * dc / (dmc + 0.4 * dc)) * (0.92 + p_dmc[i]));
+  });
+}
+static void calculate_fwi(FwiColumns* columns)
+{
+  auto& c = *columns;
+  const auto n = c.size();
+  const auto p_bui = pow_of(c.bui, 0.809);
+  const auto e_bui = exp_of(each(n, [&](const size_t i) { return -0.023 * c.bui[i]; }));
+  const auto b = each(n, [&](const size_t i) {
+    const auto f_d = (c.bui[i] <= 80.0) ?   //'''/* 28a '*/
+                       0.626 * p_bui[i] + 2.0
+                                        :   //'''/* 28b '*/
+                       1000.0 / (25.0 + 108.64 * e_bui[i]);
+    //'''/* 29  '*/
+    return 0.1 * c.isi[i] * f_d;
+  });
+  const auto log_b = log_of(each(n, [&](const size_t i) { return (b[i] > 1.0) ? b[i] : 1.0; }));
+  const auto p_b = pow_of(each(n, [&](const size_t i) { return 0.434 * log_b[i]; }), 0.647);
+  //'''/* 30a '*/
+  const auto e_b = exp_of(each(n, [&](const size_t i) { return 2.72 * p_b[i]; }));
+  //'''/* 30b '*/
+  c.fwi = each(n, [&](const size_t i) { return (b[i] > 1.0) ? e_b[i] : b[i]; });
+}
+void calculate_daily(FwiColumns* columns, const int month, const MathSize latitude)
+{
+  calculate_ffmc(columns, INTERCEPTED_DAILY, RATE_DAILY);
+  calculate_dmc(columns, month, latitude);
+  calculate_dc(columns, month, latitude);
+  calculate_isi(columns);
+  calculate_bui(columns);
+  calculate_fwi(columns);
+}
+void calculate_hourly(FwiColumns* columns)
+{
+  calculate_ffmc(columns, INTERCEPTED_HOURLY, RATE_HOURLY);
+  calculate_isi(columns);
+  calculate_fwi(columns);
+}
 }
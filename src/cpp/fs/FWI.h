@@ -27,6 +27,23 @@ struct Ffmc : public StrictType<Ffmc>
     const Ffmc ffmc_previous
   ) noexcept;
 };
+/**
+ * \brief Calculate Fine Fuel Moisture Code one hour later using the hourly method
+ * from Van Wagner (1977)
+ * \param temperature Temperature (Celsius)
+ * \param rh Relative Humidity (%)
+ * \param ws Wind Speed (km/h)
+ * \param prec Precipitation (1hr accumulated) (mm)
+ * \param ffmc_previous Fine Fuel Moisture Code for previous hour
+ * \return Fine Fuel Moisture Code for this hour
+ */
+[[nodiscard]] Ffmc hourly_ffmc(
+  const Temperature temperature,
+  const RelativeHumidity rh,
+  const Speed ws,
+  const Precipitation prec,
+  const Ffmc ffmc_previous
+) noexcept;
 /**
  * \brief Duff Moisture Code value.
  */
@@ -272,5 +289,83 @@ constexpr Ffmc moisture_to_ffmc(const MathSize m) noexcept
   return Ffmc{(59.5 * (250.0 - m) / (FFMC_MOISTURE_CONSTANT + m))};
 }
 constexpr Ffmc ffmc_from_moisture(const MathSize m) noexcept { return Ffmc(moisture_to_ffmc(m)); }
+/**
+ * \brief Weather and indices for many ensemble members at the same time, with one array
+ * per value.
+ *
+ * Member i is at index i of every array. Results are within a few ulp of calculating each
+ * member by itself, and don't depend on how many members there are or what they are. Weather
+ * files still use the FwiWeather constructors for each stream, so this doesn't change what
+ * simulations use.
+ */
+struct FwiColumns
+{
+  /**
+   * \brief Temperature (Celsius)
+   */
+  vector<MathSize> temperature{};
+  /**
+   * \brief Relative Humidity (%)
+   */
+  vector<MathSize> rh{};
+  /**
+   * \brief Wind Speed (km/h)
+   */
+  vector<MathSize> wind{};
+  /**
+   * \brief Precipitation (mm) since last calculation
+   */
+  vector<MathSize> prec{};
+  /**
+   * \brief Fine Fuel Moisture Code
+   */
+  vector<MathSize> ffmc{};
+  /**
+   * \brief Duff Moisture Code
+   */
+  vector<MathSize> dmc{};
+  /**
+   * \brief Drought Code
+   */
+  vector<MathSize> dc{};
+  /**
+   * \brief Initial Spread Index
+   */
+  vector<MathSize> isi{};
+  /**
+   * \brief Build-up Index
+   */
+  vector<MathSize> bui{};
+  /**
+   * \brief Fire Weather Index
+   */
+  vector<MathSize> fwi{};
+  /**
+   * \brief Constructor with all values 0
+   * \param members Number of ensemble members
+   */
+  explicit FwiColumns(size_t members);
+  /**
+   * \brief Number of ensemble members
+   * \return Number of ensemble members
+   */
+  [[nodiscard]] size_t size() const noexcept { return temperature.size(); }
+};
+/**
+ * \brief Calculate indices for the next day for all members, replacing the codes from the
+ * previous day that are in columns
+ * \param columns Noon weather (precipitation is noon-to-noon) and codes from previous day
+ * \param month Month to calculate for
+ * \param latitude Latitude to calculate for
+ */
+void calculate_daily(FwiColumns* columns, int month, MathSize latitude);
+/**
+ * \brief Calculate Fine Fuel Moisture Code for the next hour using the hourly method from
+ * Van Wagner (1977), and Initial Spread Index and Fire Weather Index based on it
+ *
+ * Duff Moisture Code, Drought Code and Build-up Index are daily, so they aren't changed.
+ * \param columns Hourly weather, Build-up Index, and Fine Fuel Moisture Code from previous hour
+ */
+void calculate_hourly(FwiColumns* columns);
 }
 #endif
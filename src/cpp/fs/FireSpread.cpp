@@ -3,9 +3,9 @@
 #include "FuelLookup.h"
 #include "FuelType.h"
 #include "LookupTable.h"
+#include "OffsetMemo.h"
 #include "Scenario.h"
 #include "Settings.h"
-#include "SpreadAlgorithm.h"
 #include "unstable.h"
 namespace fs
 {
@@ -57,6 +57,10 @@ static MathSize calculate_standard_wsv(const MathSize v) noexcept
   return v < 40.0 ? exp(0.05039 * v) : 12.0 * (1.0 - exp(-0.0818 * (v - 28)));
 }
 static const LookupTable<&calculate_standard_wsv> STANDARD_WSV{};
+/**
+ * \brief Value that calculate_standard_wsv() approaches but never reaches
+ */
+static constexpr MathSize MAX_STANDARD_WSV = 12.0;
 SpreadInfo::SpreadInfo(
   const Scenario& scenario,
   const DurationSize time,
@@ -72,6 +76,7 @@ MathSize SpreadInfo::initial(
   MathSize& ffmc_effect,
   MathSize& wsv,
   MathSize& rso,
+  MathSize& surface_ros,
   const FuelType* const fuel,
   bool has_no_slope,
   MathSize heading_sin,
@@ -115,7 +120,8 @@ MathSize SpreadInfo::initial(
   spread.raz_ = Direction{Radians{raz}};
   const auto isi = isz * STANDARD_WSV(wsv);
   // FIX: make this a member function so we don't need to preface head_ros_
-  spread.head_ros_ = fuel->calculateRos(spread.nd(), weather, isi) * bui_eff;
+  surface_ros = fuel->calculateRos(spread.nd(), weather, isi) * bui_eff;
+  spread.head_ros_ = surface_ros;
   if (min_ros > spread.head_ros_)
   {
     spread.head_ros_ = INVALID_ROS;
@@ -135,13 +141,25 @@ MathSize SpreadInfo::initial(
   }
   return spread.head_ros_;
 }
-static MathSize find_min_ros(const Scenario& scenario, const DurationSize time)
+MathSize SpreadInfo::minimumRos(const Scenario& scenario, const DurationSize time)
 {
   // HACK: resolve once and fail if not set already
   static const auto& settings = fs::settings::instance();
   const MathSize min_ros = settings.minimum_ros;
   return settings.deterministic ? min_ros : std::max(scenario.spreadThresholdByRos(time), min_ros);
 }
+MathSize SpreadInfo::maximumRos(
+  const FuelType* const fuel,
+  const int nd,
+  const FwiWeather& weather,
+  const FwiWeather& weather_daily
+)
+{
+  // same as initial() with spread probability weather, but with the highest possible wind effect
+  const auto isz = 0.208 * weather.ffmcEffect();
+  return fuel->calculateRos(nd, weather_daily, isz * MAX_STANDARD_WSV)
+       * fuel->buiEffect(weather.bui.value);
+}
 SpreadInfo::SpreadInfo(
   const Scenario& scenario,
   const DurationSize time,
@@ -152,7 +170,7 @@ SpreadInfo::SpreadInfo(
 )
   : SpreadInfo(
       time,
-      find_min_ros(scenario, time),
+      minimumRos(scenario, time),
       scenario.cellSize(),
       key,
       nd,
@@ -160,6 +178,58 @@ SpreadInfo::SpreadInfo(
       weather_daily
     )
 { }
+vector<SpreadInfo> SpreadInfo::calculateAll(
+  const Scenario& scenario,
+  const DurationSize time,
+  const vector<SpreadKey>& keys,
+  const int nd,
+  const ptr<const FwiWeather> weather,
+  const MathSize min_ros
+)
+{
+  const auto cell_size = scenario.cellSize();
+  const auto weather_daily = scenario.weather_daily(time);
+  vector<SpreadInfo> result{};
+  result.reserve(keys.size());
+  for (const auto& key : keys)
+  {
+    result.push_back(SpreadInfo{time, key, nd, weather});
+  }
+  // build-up effect and critical surface intensity only depend on fuel for the same weather
+  // and nd, so calculate them once per fuel
+  const auto bui = weather->bui.value;
+  const auto& fuels = scenario.model().fuels(time);
+  map<FuelCodeSize, tuple<const FuelType*, MathSize, MathSize>> by_fuel{};
+  for (const auto& spread : result)
+  {
+    const auto code = Cell::fuelCode(spread.key_);
+    const auto fuel = fuels.at(code);
+    if (!is_null_fuel(fuel) && !by_fuel.contains(code))
+    {
+      by_fuel.emplace(
+        code,
+        tuple<const FuelType*, MathSize, MathSize>{
+          fuel, fuel->buiEffect(bui), fuel->criticalSurfaceIntensity(spread)
+        }
+      );
+    }
+  }
+  // already running inside a thread per scenario, and there are only a few keys per hour, so
+  // running these in parallel would cost more than it saves
+  for (auto& spread : result)
+  {
+    const auto seek = by_fuel.find(Cell::fuelCode(spread.key_));
+    // no spread in null fuel
+    if (by_fuel.end() != seek)
+    {
+      const auto& [fuel, bui_eff, critical_surface_intensity] = seek->second;
+      spread.calculate(
+        fuel, min_ros, cell_size, weather_daily, bui_eff, critical_surface_intensity
+      );
+    }
+  }
+  return result;
+}
 static SpreadKey make_key(const SlopeSize slope, const AspectSize aspect, const char* fuel_name)
 {
   // HACK: resolve once and fail if not set already
@@ -242,6 +312,16 @@ SpreadInfo::SpreadInfo(
 )
   : SpreadInfo(time, min_ros, cell_size, key, nd, weather, weather)
 { }
+SpreadInfo::SpreadInfo(
+  const DurationSize time,
+  const SpreadKey& key,
+  const int nd,
+  const ptr<const FwiWeather> weather
+)
+  : offsets_({}), max_intensity_(INVALID_INTENSITY), key_(key), weather(weather), time_(time),
+    head_ros_(INVALID_ROS), cfb_(-1), cfc_(-1), tfc_(-1), sfc_(-1), is_crown_(false),
+    raz_(fs::Direction::Invalid()), nd_(nd)
+{ }
 SpreadInfo::SpreadInfo(
   const DurationSize time,
   const MathSize min_ros,
@@ -251,17 +331,35 @@ SpreadInfo::SpreadInfo(
   const ptr<const FwiWeather> weather,
   const ptr<const FwiWeather> weather_daily
 )
-  : offsets_({}), max_intensity_(INVALID_INTENSITY), key_(key), weather(weather), time_(time),
-    head_ros_(INVALID_ROS), cfb_(-1), cfc_(-1), tfc_(-1), sfc_(-1), is_crown_(false),
-    raz_(fs::Direction::Invalid()), nd_(nd)
+  : SpreadInfo(time, key, nd, weather)
 {
-  // HACK: use weather_daily to figure out probability of spread but hourly for ROS
-  const auto slope_azimuth = Cell::aspect(key_);
-  const auto fuel = fuel_by_code(Cell::fuelCode(key_));
+  const auto fuel = &fuel_by_code(Cell::fuelCode(key_))->forSeason(nd_);
   if (is_null_fuel(fuel))
   {
     return;
   }
+  // HACK: only use BUI from hourly weather for both calculations
+  calculate(
+    fuel,
+    min_ros,
+    cell_size,
+    weather_daily,
+    fuel->buiEffect(weather->bui.value),
+    // FIX: gets calculated when not necessary sometimes
+    fuel->criticalSurfaceIntensity(*this)
+  );
+}
+void SpreadInfo::calculate(
+  const FuelType* const fuel,
+  const MathSize min_ros,
+  const MathSize cell_size,
+  const ptr<const FwiWeather> weather_daily,
+  const MathSize bui_eff,
+  const MathSize critical_surface_intensity
+)
+{
+  // HACK: use weather_daily to figure out probability of spread but hourly for ROS
+  const auto slope_azimuth = Cell::aspect(key_);
   const auto has_no_slope = 0 == percentSlope();
   MathSize heading_sin = 0;
   MathSize heading_cos = 0;
@@ -271,51 +369,40 @@ SpreadInfo::SpreadInfo(
     heading_sin = sin(heading);
     heading_cos = cos(heading);
   }
-  // HACK: only use BUI from hourly weather for both calculations
-  const auto _bui = weather->bui.value;
-  const auto bui_eff = fuel->buiEffect(_bui);
-  // FIX: gets calculated when not necessary sometimes
-  const auto critical_surface_intensity = fuel->criticalSurfaceIntensity(*this);
+  min_ros_ = min_ros;
   MathSize ffmc_effect;
   MathSize wsv;
   MathSize rso;
-  if (min_ros > SpreadInfo::initial(
-        *this,
-        *weather_daily,
-        ffmc_effect,
-        wsv,
-        rso,
-        fuel,
-        has_no_slope,
-        heading_sin,
-        heading_cos,
-        bui_eff,
-        min_ros,
-        critical_surface_intensity
-      )
-      || sfc_ < COMPARE_LIMIT)
+  // remember what decided if there's spread so withMinimumRos() can decide it again
+  const auto check = [&](const FwiWeather& for_weather) {
+    MathSize surface_ros;
+    const auto ros = SpreadInfo::initial(
+      *this,
+      for_weather,
+      ffmc_effect,
+      wsv,
+      rso,
+      surface_ros,
+      fuel,
+      has_no_slope,
+      heading_sin,
+      heading_cos,
+      bui_eff,
+      min_ros,
+      critical_surface_intensity
+    );
+    checks_.at(num_checks_++) = RosCheck{surface_ros, ros, sfc_ >= COMPARE_LIMIT};
+    return !(min_ros > ros || sfc_ < COMPARE_LIMIT);
+  };
+  if (!check(*weather_daily))
   {
     return;
   }
   // Now use hourly weather for actual spread calculations
-  // don't check again if pointing at same weather
-  if (weather != weather_daily)
+  // don't check again if it's the same weather
+  if (weather != weather_daily && *weather != *weather_daily)
   {
-    if ((min_ros > SpreadInfo::initial(
-           *this,
-           *weather,
-           ffmc_effect,
-           wsv,
-           rso,
-           fuel,
-           has_no_slope,
-           heading_sin,
-           heading_cos,
-           bui_eff,
-           min_ros,
-           critical_surface_intensity
-         )
-         || sfc_ < COMPARE_LIMIT))
+    if (!check(*weather))
     {
       // no spread with hourly weather
       // NOTE: only would happen if FFMC hourly is lower than FFMC daily?
@@ -324,14 +411,16 @@ SpreadInfo::SpreadInfo(
   }
   logging::verbose("initial ros is {:f}", head_ros_);
   const auto back_isi = ffmc_effect * STANDARD_BACK_ISI_WSV(wsv);
-  auto back_ros = fuel->calculateRos(nd, *weather, back_isi) * bui_eff;
+  back_ros_ = fuel->calculateRos(nd_, *weather, back_isi) * bui_eff;
   if (is_crown_)
   {
-    back_ros = fuel->finalRos(*this, back_isi, fuel->crownFractionBurned(back_ros, rso), back_ros);
+    back_ros_ =
+      fuel->finalRos(*this, back_isi, fuel->crownFractionBurned(back_ros_, rso), back_ros_);
   }
   tfc_ = sfc_;
   // don't need to re-evaluate if crown with new head_ros_ because it would only go up if is_crown_
-  if (fuel->canCrown() && is_crown_)
+  // fuels that change with the season decide if they can crown, not the fuel they use
+  if (fuel_by_code(Cell::fuelCode(key_))->canCrown() && is_crown_)
   {
     // wouldn't be crowning if ros is 0 so that's why this is in an else
     cfb_ = fuel->crownFractionBurned(head_ros_, rso);
@@ -341,13 +430,57 @@ SpreadInfo::SpreadInfo(
   // max intensity should always be at the head
   max_intensity_ = fire_intensity(tfc_, head_ros_);
   l_b_ = fuel->lengthToBreadth(wsv);
-  const HorizontalAdjustment correction_factor =
-    horizontal_adjustment(slope_azimuth, percentSlope());
-  const auto spread_algorithm = WidestEllipseAlgorithm(MAX_SPREAD_ANGLE, cell_size, min_ros);
-  offsets_ = spread_algorithm.calculate_offsets(
-    correction_factor, tfc_, Radians{raz_.asRadians()}, head_ros_, back_ros, l_b_
+  calculateOffsets(cell_size);
+}
+void SpreadInfo::calculateOffsets(const MathSize cell_size)
+{
+  steps_.clear();
+  offsets_ = calculate_offsets(
+    OffsetInputs{
+      cell_size,
+      min_ros_,
+      percentSlope(),
+      slopeAzimuth(),
+      tfc_,
+      raz_.asRadians(),
+      head_ros_,
+      back_ros_,
+      l_b_,
+    },
+    &steps_
   );
   // #endif
+  invalidateIfNoOffsets();
+}
+void SpreadInfo::filterOffsets()
+{
+  // a higher minimum only stops at the same steps sooner, and leaves out slower offsets
+  // HACK: steps also check ros before adjusting it for slope, but that is never lower
+  size_t kept = 0;
+  size_t begin = 0;
+  for (const auto& step : steps_)
+  {
+    const auto before = kept;
+    for (auto i = begin; i < step.end; ++i)
+    {
+      if (offsets_[i].ros >= min_ros_)
+      {
+        offsets_[kept++] = offsets_[i];
+      }
+    }
+    begin = step.end;
+    if (step.stops && before == kept)
+    {
+      break;
+    }
+  }
+  offsets_.resize(kept);
+  // indices don't match offsets anymore
+  steps_.clear();
+  invalidateIfNoOffsets();
+}
+void SpreadInfo::invalidateIfNoOffsets()
+{
   // if no offsets then not spreading so invalidate head_ros_
   if (0 == offsets_.size())
   {
@@ -361,4 +494,49 @@ SpreadInfo::SpreadInfo(
     raz_ = fs::Direction::Invalid();
   }
 }
+SpreadInfo SpreadInfo::withMinimumRos(const MathSize min_ros, const MathSize cell_size) const
+{
+  if (min_ros == min_ros_)
+  {
+    return *this;
+  }
+  logging::check_fatal(
+    min_ros < min_ros_,
+    "Can't use minimum ros of {:f} for spread calculated with {:f}",
+    min_ros,
+    min_ros_
+  );
+  auto result = *this;
+  result.min_ros_ = min_ros;
+  for (size_t i = 0; i < num_checks_; ++i)
+  {
+    // same checks as calculate() in the same order, so it stops where that would have
+    const auto& check = checks_[i];
+    if (min_ros > check.surface_ros || min_ros > check.head_ros || !check.has_fuel)
+    {
+      result.head_ros_ = (min_ros > check.surface_ros) ? INVALID_ROS : check.head_ros;
+      result.offsets_ = {};
+      result.max_intensity_ = INVALID_INTENSITY;
+      result.l_b_ = -1;
+      result.cfb_ = -1;
+      result.cfc_ = -1;
+      result.tfc_ = -1;
+      return result;
+    }
+  }
+  // a higher minimum can't add offsets, so nothing to do if there weren't any
+  if (!result.isNotSpreading())
+  {
+    if (steps_.empty())
+    {
+      // offsets came from OffsetMemo, which doesn't know what steps they were added in
+      result.calculateOffsets(cell_size);
+    }
+    else
+    {
+      result.filterOffsets();
+    }
+  }
+  return result;
+}
 }
@@ -17,6 +17,21 @@ struct ROSOffset
   Offset offset;
 };
 using OffsetSet = vector<ROSOffset>;
+/**
+ * \brief Offsets that get added together while calculating spread
+ */
+struct OffsetStep
+{
+  /**
+   * \brief Index in OffsetSet after the last offset this step added
+   */
+  size_t end;
+  /**
+   * \brief Whether or not calculating stops if this step doesn't add any offsets
+   */
+  bool stops;
+};
+using OffsetSteps = vector<OffsetStep>;
 class FuelType;
 static constexpr MathSize MAX_SPREAD_ANGLE = 5.0;
 static constexpr MathSize INVALID_ROS = -1.0;
@@ -56,6 +71,63 @@ public:
   SpreadInfo(const SpreadInfo& rhs) noexcept = default;
   constexpr SpreadInfo& operator=(SpreadInfo&& rhs) noexcept = default;
   SpreadInfo& operator=(const SpreadInfo& rhs) noexcept = default;
+  /**
+   * \brief Minimum rate of spread for spread to happen in a Scenario at a time
+   * \param scenario Scenario to check threshold for
+   * \param time Time to check threshold at
+   * \return Minimum rate of spread for spread to happen (m/min)
+   */
+  [[nodiscard]] static MathSize minimumRos(const Scenario& scenario, DurationSize time);
+  /**
+   * \brief Highest head fire rate of spread before crowning that any wind or slope could give
+   *
+   * Spread is only possible if this is at least the minimum rate of spread, since every
+   * FuelType spreads faster with higher ISI and no wind or slope can make ISI higher than this
+   * uses.
+   * \param fuel FuelType to calculate for
+   * \param nd Difference between date and the date of minimum foliar moisture content
+   * \param weather FwiWeather to use for calculations
+   * \param weather_daily FwiWeather to use for spread event probability
+   * \return Highest head fire rate of spread before crowning (m/min)
+   */
+  [[nodiscard]] static MathSize maximumRos(
+    const FuelType* fuel,
+    int nd,
+    const FwiWeather& weather,
+    const FwiWeather& weather_daily
+  );
+  /**
+   * \brief Calculate fire spread for many SpreadKeys with the same time and weather at once
+   *
+   * Values that only depend on fuel and weather are calculated once for each fuel instead of
+   * once for each key. Results are exactly the same as constructing a SpreadInfo for each key
+   * separately with the same minimum rate of spread.
+   * \param scenario Scenario this is spreading in
+   * \param time Time spread is occurring
+   * \param keys Attributes for Cells spread is occurring in
+   * \param nd Difference between date and the date of minimum foliar moisture content
+   * \param weather FwiWeather to use for calculations
+   * \param min_ros Minimum rate of spread to consider spreading (m/min)
+   * \return SpreadInfo for each key, in the same order as keys
+   */
+  [[nodiscard]] static vector<SpreadInfo> calculateAll(
+    const Scenario& scenario,
+    DurationSize time,
+    const vector<SpreadKey>& keys,
+    int nd,
+    const ptr<const FwiWeather> weather,
+    MathSize min_ros
+  );
+  /**
+   * \brief Fire spread for the same conditions with a higher minimum rate of spread
+   *
+   * Gives the same head rate of spread, intensity and offsets as calculating with min_ros in the
+   * first place, but only needs to leave out offsets that are slower than min_ros.
+   * \param min_ros Minimum rate of spread to consider spreading (m/min)
+   * \param cell_size Size of cells (m)
+   * \return Fire spread with min_ros as the minimum rate of spread
+   */
+  [[nodiscard]] SpreadInfo withMinimumRos(MathSize min_ros, MathSize cell_size) const;
   /**
    * \brief Determine rate of spread from probability of spread threshold
    * \param threshold Probability of spread threshold
@@ -236,6 +308,45 @@ private:
     const ptr<const FwiWeather> weather,
     const ptr<const FwiWeather> weather_daily
   );
+  /**
+   * \brief Set up for spread calculation without calculating anything yet
+   * \param time Time spread is occurring
+   * \param key Attributes for Cell spread is occurring in
+   * \param nd Difference between date and the date of minimum foliar moisture content
+   * \param weather FwiWeather to use for calculations
+   */
+  SpreadInfo(DurationSize time, const SpreadKey& key, int nd, const ptr<const FwiWeather> weather);
+  /**
+   * \brief Calculate fire spread using values that only depend on fuel and weather
+   * \param fuel FuelType that does the calculations for Cell at this time of year
+   * \param min_ros Minimum rate of spread to consider spreading (m/min)
+   * \param cell_size Size of cells (m)
+   * \param weather_daily FwiWeather to use for spread event probability
+   * \param bui_eff Build-up effect for fuel
+   * \param critical_surface_intensity Critical surface intensity for fuel (kW/m)
+   */
+  void calculate(
+    const FuelType* fuel,
+    MathSize min_ros,
+    MathSize cell_size,
+    const ptr<const FwiWeather> weather_daily,
+    MathSize bui_eff,
+    MathSize critical_surface_intensity
+  );
+  /**
+   * \brief Calculate offsets for spread and invalidate spread if there are none
+   * \param cell_size Size of cells (m)
+   */
+  void calculateOffsets(MathSize cell_size);
+  /**
+   * \brief Leave out offsets that calculating with min_ros_ wouldn't have added, and
+   * invalidate spread if there are none left
+   */
+  void filterOffsets();
+  /**
+   * \brief Invalidate spread if there are no offsets
+   */
+  void invalidateIfNoOffsets();
   /**
    * Do initial spread calculations
    * \return Initial head ros calculation (-1 for none)
@@ -246,6 +357,7 @@ private:
     MathSize& ffmc_effect,
     MathSize& wsv,
     MathSize& rso,
+    MathSize& surface_ros,
     const FuelType* const fuel,
     bool has_no_slope,
     MathSize heading_sin,
@@ -254,10 +366,41 @@ private:
     MathSize min_ros,
     MathSize critical_surface_intensity
   );
+  /**
+   * \brief Rates of spread that decided if spread was possible with one FwiWeather
+   */
+  struct RosCheck
+  {
+    /**
+     * \brief Head fire rate of spread before crowning (m/min)
+     */
+    MathSize surface_ros;
+    /**
+     * \brief Head fire rate of spread after crowning (m/min)
+     */
+    MathSize head_ros;
+    /**
+     * \brief Whether or not surface fuel consumption was enough to spread
+     */
+    bool has_fuel;
+  };
+  /**
+   * \brief Checks done with daily and then hourly weather, in order
+   */
+  array<RosCheck, 2> checks_{};
+  /**
+   * \brief Number of checks that were done
+   */
+  size_t num_checks_ = 0;
   /**
    * \brief Offsets from origin point that represent spread under these conditions
    */
   OffsetSet offsets_{};
+  /**
+   * \brief Steps offsets were added in, so filterOffsets() can stop where calculating would
+   * have (empty if not known)
+   */
+  OffsetSteps steps_{};
   /**
    * \brief Maximum intensity in any direction for spread (kW/m)
    */
@@ -283,6 +426,14 @@ private:
    * \brief Head fire rate of spread (m/min)
    */
   MathSize head_ros_ = INVALID_ROS;
+  /**
+   * \brief Back fire rate of spread (m/min)
+   */
+  MathSize back_ros_ = INVALID_ROS;
+  /**
+   * \brief Minimum rate of spread that was used for calculations (m/min)
+   */
+  MathSize min_ros_ = 0;
   MathSize cfb_ = -1;
   MathSize cfc_ = -1;
   MathSize tfc_ = -1;
@@ -383,27 +383,19 @@ inline Ffmc ffmc_1100_low(const MathSize ln_x, const MathSize ln_x_sq) noexcept
   constexpr auto e = 0.356051255;
   return ffmc_from_moisture((a + c * ln_x + e * ln_x_sq) / (1 + b * ln_x + d * ln_x_sq));
 }
-static ptr<const FwiWeather> make_wx(FwiWeather wx)
-{
-  static sp_set<FwiWeather> all_weather{};
-  static const FwiWeather empty{};
-  if (empty == wx)
-  {
-    return nullptr;
-  }
-  // HACK: assign rain to noon only
-  auto wx_inserted = all_weather.sp_emplace(wx);
-  // doesn't matter if was already there or just inserted
-  return wx_inserted.first->get();
-}
-static ptr<const FwiWeather> make_wx(
+/**
+ * \brief Weather for hours that don't have any
+ */
+static const FwiWeather NO_WEATHER{};
+static FwiWeather make_wx(
   const Speed& speed,
   const FwiWeather& wx,
   const Ffmc& ffmc,
   const int hour
 )
 {
-  return make_wx(FwiWeather{
+  // HACK: assign rain to noon only
+  return FwiWeather{
     Weather{
       wx.temperature,
       wx.rh,
@@ -413,9 +405,9 @@ static ptr<const FwiWeather> make_wx(
     ffmc,
     wx.dmc,
     wx.dc
-  });
+  };
 }
-static ptr<const FwiWeather> make_wx(
+static FwiWeather make_wx(
   const FwiWeather& wx_wind,
   const FwiWeather& wx,
   const Ffmc& ffmc,
@@ -424,15 +416,15 @@ static ptr<const FwiWeather> make_wx(
 {
   return make_wx(Speed(wx_wind.wind.speed.value * wind_speed_adjustment(hour)), wx, ffmc, hour);
 }
-static ptr<const FwiWeather> make_wx(const FwiWeather& wx, const Ffmc& ffmc, const int hour)
+static FwiWeather make_wx(const FwiWeather& wx, const Ffmc& ffmc, const int hour)
 {
   return make_wx(wx, wx, ffmc, hour);
 }
-vector<ptr<const FwiWeather>> make_vector(map<Day, FwiWeather> data)
+vector<FwiWeather> make_vector(map<Day, FwiWeather> data)
 {
   const Day min_date = data.begin()->first;
   const Day max_date = data.rbegin()->first;
-  vector<ptr<const FwiWeather>> r{(static_cast<size_t>(max_date) - min_date + 2) * DAY_HOURS};
+  vector<FwiWeather> r((static_cast<size_t>(max_date) - min_date + 2) * DAY_HOURS, NO_WEATHER);
   // HACK: just approximate last day
   for (const auto& kv : data)
   {
@@ -481,7 +473,7 @@ vector<ptr<const FwiWeather>> make_vector(map<Day, FwiWeather> data)
     const auto x = wx.mcFfmcPct();
     const auto ln_x = log(x);
     const auto ln_x_sq = ln_x * ln_x;
-    const auto& at_1200 = r.at(time_index(day + 1, 12, min_date))->ffmc;
+    const auto& at_1200 = r.at(time_index(day + 1, 12, min_date)).ffmc;
     // figure out which is the closest match and use that curve
     const auto at_1100_high = ffmc_1100_high(ln_x, ln_x_sq);
     const auto at_1100_med = ffmc_1100_med(x);
@@ -529,12 +521,12 @@ vector<ptr<const FwiWeather>> make_vector(map<Day, FwiWeather> data)
   {
     // use first day's weather for min date instead of all 0's
     const auto& wx = (day == min_date ? data.at(day + 1) : data.at(day));
-    const auto ffmc_at_0600 = r.at(time_index(day + 1, 6, min_date))->ffmc.value;
-    const auto ffmc_at_2000 = r.at(time_index(day, 20, min_date))->ffmc.value;
+    const auto ffmc_at_0600 = r.at(time_index(day + 1, 6, min_date)).ffmc.value;
+    const auto ffmc_at_2000 = r.at(time_index(day, 20, min_date)).ffmc.value;
     // need linear interpolation between 2000 and 0600
     const auto ffmc_slope = (ffmc_at_0600 - ffmc_at_2000) / 10.0;
-    const auto wind_at_0600 = r.at(time_index(day + 1, 6, min_date))->wind.speed.value;
-    const auto wind_at_2000 = r.at(time_index(day, 20, min_date))->wind.speed.value;
+    const auto wind_at_0600 = r.at(time_index(day + 1, 6, min_date)).wind.speed.value;
+    const auto wind_at_2000 = r.at(time_index(day, 20, min_date)).wind.speed.value;
     // need linear interpolation between 2000 and 0600
     const auto wind_slope = (wind_at_0600 - wind_at_2000) / 10.0;
     const auto add_wx = [&](const Day day_offset, const int hour, const int offset) {
@@ -561,59 +553,66 @@ vector<ptr<const FwiWeather>> make_vector(map<Day, FwiWeather> data)
 FireWeather::FireWeather(const set<const FuelType*>& used_fuels, const map<Day, FwiWeather>& data)
   : FireWeather(used_fuels, data.begin()->first, data.rbegin()->first, make_vector(data))
 { }
-static SurvivalMap make_survival(
+/**
+ * \brief Find probability of survival for a day, calculating it if nothing has yet
+ * \param fuel FuelType to calculate for
+ * \param wx FwiWeather for each hour of day, or nullptr if there is no weather for the day
+ * \return Probability of survival for each hour of day
+ */
+static const DaySurvival* find_survival(const FuelType* fuel, const FwiWeather* wx)
+{
+  // only FFMC and DMC affect survival, so any day with the same values for them can share
+  array<MathSize, 2 * DAY_HOURS + 1> key{};
+  key[0] = FuelType::safeCode(fuel);
+  for (size_t h = 0; h < DAY_HOURS; ++h)
+  {
+    const auto has_weather = nullptr != wx && NO_WEATHER != wx[h];
+    key[2 * h + 1] = has_weather ? wx[h].ffmc.value : numeric_limits<MathSize>::quiet_NaN();
+    key[2 * h + 2] = has_weather ? wx[h].dmc.value : numeric_limits<MathSize>::quiet_NaN();
+  }
+  static mutex mutex_survival{};
+  static unordered_map<string, unique_ptr<const DaySurvival>> survival_by_key{};
+  lock_guard<mutex> lock(mutex_survival);
+  auto& found =
+    survival_by_key[string{reinterpret_cast<const char*>(key.data()), sizeof(key)}];
+  if (nullptr == found)
+  {
+    array<ThresholdSize, DAY_HOURS> values{};
+    if (nullptr != wx)
+    {
+      fuel->survivalProbabilities(wx, values.size(), values.data());
+    }
+    auto survival = make_unique<DaySurvival>();
+    for (size_t h = 0; h < DAY_HOURS; ++h)
+    {
+      (*survival)[h] = static_cast<float>(std::isnan(key[2 * h + 1]) ? 0.0 : values[h]);
+    }
+    found = std::move(survival);
+  }
+  return found.get();
+}
+FireWeather::FireWeather(
   const set<const FuelType*>& used_fuels,
   const Day min_date,
   const Day max_date,
-  const vector<ptr<const FwiWeather>>& weather_by_hour_by_day
+  vector<FwiWeather> weather_by_hour_by_day
 )
+  : weather_by_hour_by_day_(std::move(weather_by_hour_by_day)), min_date_(min_date),
+    max_date_(max_date)
 {
-  SurvivalMap result{};
+  // survival gets calculated when it's needed since most fuels and days never get used
+  const auto num_days = static_cast<size_t>(max_date) - min_date + 2;
   for (const auto& in_fuel : used_fuels)
   {
     const auto code = FuelType::safeCode(in_fuel);
     if (nullptr != in_fuel && INVALID_FUEL_CODE != code)
     {
-      auto by_fuel = vector<float>{};
-      by_fuel.resize((static_cast<size_t>(max_date) - min_date + 2) * DAY_HOURS);
-      // calculate the entire stream for this fuel
-      for (auto day = min_date; day <= max_date; ++day)
-      {
-        for (auto h = 0; h < DAY_HOURS; ++h)
-        {
-          const auto wx = weather_by_hour_by_day.at(time_index(day, h, min_date));
-          const auto i = time_index(day, h, min_date);
-          by_fuel.at(i) =
-            static_cast<float>(nullptr != wx ? (in_fuel->survivalProbability(*wx)) : 0.0);
-        }
-      }
-      result.at(code) = std::move(by_fuel);
+      fuels_.at(code) = in_fuel;
+      survival_probability_.at(code) = vector<atomic<const DaySurvival*>>(num_days);
     }
   }
-  return result;
 }
-FireWeather::FireWeather(
-  const set<const FuelType*>& used_fuels,
-  const Day min_date,
-  const Day max_date,
-  vector<ptr<const FwiWeather>>&& weather_by_hour_by_day
-)
-  : weather_by_hour_by_day_(weather_by_hour_by_day),
-    survival_probability_(make_survival(used_fuels, min_date, max_date, weather_by_hour_by_day_)),
-    min_date_(min_date), max_date_(max_date)
-{ }
-FireWeather::FireWeather(
-  const set<const FuelType*>& used_fuels,
-  Day min_date,
-  Day max_date,
-  vector<FwiWeather> weather_by_hour_by_day
-)
-  : FireWeather(used_fuels, min_date, max_date, [&]() {
-      auto it = std::views::transform(weather_by_hour_by_day, [](auto& v) { return make_wx(v); });
-      return vector<ptr<const FwiWeather>>{it.begin(), it.end()};
-    }())
-{ }
-static vector<ptr<const FwiWeather>> make_constant_weather(
+static vector<FwiWeather> make_constant_weather(
   const Dc& dc,
   const Dmc& dmc,
   const Ffmc& ffmc,
@@ -624,10 +623,10 @@ static vector<ptr<const FwiWeather>> make_constant_weather(
   static constexpr RelativeHumidity RH(30.0);
   static constexpr Precipitation PREC(0.0);
   const Bui bui{dmc, dc};
-  vector<ptr<const FwiWeather>> wx{static_cast<size_t>(YEAR_HOURS)};
-  std::generate(wx.begin(), wx.end(), [&]() {
-    const Isi isi{wind.speed, ffmc};
-    return make_wx(FwiWeather{
+  const Isi isi{wind.speed, ffmc};
+  return vector<FwiWeather>(
+    static_cast<size_t>(YEAR_HOURS),
+    FwiWeather{
       TEMP,
       RH,
       wind,
@@ -638,9 +637,8 @@ static vector<ptr<const FwiWeather>> make_constant_weather(
       isi,
       bui,
       Fwi{isi, bui},
-    });
-  });
-  return wx;
+    }
+  );
 }
 FireWeather::FireWeather(
   const FuelType* fuel,
@@ -667,11 +665,28 @@ ptr<const FwiWeather> FireWeather::at(const DurationSize time) const
 #ifdef DEBUG_FWI_WEATHER
   logging::check_fatal(time < 0 || time >= MAX_DAYS, "Invalid weather time {:f}", time);
 #endif
-  return weather_by_hour_by_day_.at(time_index(time, min_date_));
+  const auto& wx = weather_by_hour_by_day_.at(time_index(time, min_date_));
+  return NO_WEATHER == wx ? nullptr : &wx;
 }
 ThresholdSize FireWeather::survivalProbability(const DurationSize time, const FuelCodeSize& in_fuel)
   const
 {
-  return survival_probability_.at(in_fuel).at(time_index(time, min_date_));
+  const auto i = time_index(time, min_date_);
+  const auto day = i / DAY_HOURS;
+  auto& for_day = survival_probability_.at(in_fuel).at(day);
+  auto survival = for_day.load(std::memory_order_acquire);
+  if (nullptr == survival)
+  {
+    // day after max_date never has survival
+    const auto first_hour = day * DAY_HOURS;
+    const auto has_weather = day <= static_cast<size_t>(max_date_ - min_date_)
+                          && first_hour + DAY_HOURS <= weather_by_hour_by_day_.size();
+    survival = find_survival(
+      fuels_.at(in_fuel), has_weather ? &weather_by_hour_by_day_[first_hour] : nullptr
+    );
+    // any thread that gets here at the same time finds the same values
+    for_day.store(survival, std::memory_order_release);
+  }
+  return (*survival)[i % DAY_HOURS];
 }
 }
@@ -6,10 +6,18 @@
 namespace fs
 {
 class FuelType;
+/**
+ * \brief Probability of survival in one fuel for each hour of a day
+ */
+using DaySurvival = array<float, DAY_HOURS>;
 // use an array instead of a map since number of values is so small and access should be faster
-using SurvivalMap = array<vector<float>, NUMBER_OF_FUELS>;
+using SurvivalMap = array<vector<atomic<const DaySurvival*>>, NUMBER_OF_FUELS>;
 /**
  * \brief A stream of weather that gets used by a Scenario every Iteration.
+ *
+ * Weather for every hour is stored by value in one contiguous block, so looking up an hour is
+ * just indexing. Probability of survival is calculated for a whole day in one fuel the first
+ * time it's needed, and days with the same moisture share it with every other stream.
  */
 class FireWeather
 {
@@ -21,6 +29,13 @@ public:
    * \param data map of Day to FwiWeather to use for weather stream with diurnal formula
    */
   FireWeather(const set<const FuelType*>& used_fuels, const map<Day, FwiWeather>& data);
+  /**
+   * \brief Constructor
+   * \param used_fuels set of FuelTypes that are used in the simulation
+   * \param min_date Minimum date present in stream
+   * \param max_date Maximum date present in stream
+   * \param weather_by_hour_by_day FwiWeather by hour by Day (all 0 for hours without weather)
+   */
   FireWeather(
     const set<const FuelType*>& used_fuels,
     Day min_date,
@@ -60,7 +75,7 @@ public:
   /**
    * \brief Get FwiWeather for given time
    * \param time Time to get weather for
-   * \return FwiWeather for given time
+   * \return FwiWeather for given time, or nullptr if there is no weather for that time
    */
   [[nodiscard]] ptr<const FwiWeather> at(const DurationSize time) const;
   /**
@@ -87,35 +102,26 @@ public:
    * \brief Weather by hour by day
    * \return Weather by hour by day
    */
-  [[nodiscard]] const vector<ptr<const FwiWeather>>& getWeather()
-  {
-    return weather_by_hour_by_day_;
-  }
-
-protected:
+  [[nodiscard]] const vector<FwiWeather>& getWeather() const { return weather_by_hour_by_day_; }
   /**
-   * \brief Constructor
-   * \param used_fuels set of FuelTypes that are used in the simulation
-   * \param min_date Minimum date present in stream
-   * \param max_date Maximum date present in stream
-   * \param weather_by_hour_by_day FwiWeather by hour by Day
+   * \brief FuelType for each fuel code that is used in the simulation
+   * \return FuelType for each fuel code that is used in the simulation, or nullptr if not used
    */
-  FireWeather(
-    const set<const FuelType*>& used_fuels,
-    Day min_date,
-    Day max_date,
-    vector<ptr<const FwiWeather>>&& weather_by_hour_by_day
-  );
+  [[nodiscard]] const array<const FuelType*, NUMBER_OF_FUELS>& fuels() const { return fuels_; }
 
 private:
   /**
-   * \brief FwiWeather by hour by Day
+   * \brief FwiWeather by hour by Day (all 0 for hours without weather)
+   */
+  vector<FwiWeather> weather_by_hour_by_day_{};
+  /**
+   * \brief FuelType for each fuel code that is used in the simulation
    */
-  vector<ptr<const FwiWeather>> weather_by_hour_by_day_{};
+  array<const FuelType*, NUMBER_OF_FUELS> fuels_{};
   /**
-   * \brief Probability of survival for fuels fuel at each time
+   * \brief Probability of survival for each used fuel on each day, or nullptr if not calculated
    */
-  SurvivalMap survival_probability_{};
+  mutable SurvivalMap survival_probability_{};
   /**
    * \brief Minimum date present in stream
    */
@@ -143,7 +149,9 @@ private:
     for (auto hour = 0; hour < DAY_HOURS; ++hour)
     {
       const auto time = static_cast<DurationSize>(day) + hour / 24.0;
-      if (lhs.at(time) != rhs.at(time))
+      const auto wx_lhs = lhs.at(time);
+      const auto wx_rhs = rhs.at(time);
+      if ((nullptr == wx_lhs) != (nullptr == wx_rhs) || (nullptr != wx_lhs && *wx_lhs != *wx_rhs))
       {
         return false;
       }
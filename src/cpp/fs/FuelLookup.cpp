@@ -665,4 +665,15 @@ const array<const FuelType*, NUMBER_OF_FUELS> FuelLookup::Fuels{
   &M3_M4_70,  &M3_M4_75, &M3_M4_80, &M3_M4_85,  &M3_M4_90, &M3_M4_95, &M1_00,    &M2_00,
   &M1_M2_00,  &M3_00,    &M4_00,    &M3_M4_100, &O1,
 };
+ResolvedFuels resolve_fuels(const int nd)
+{
+  ResolvedFuels result{};
+  std::transform(
+    FuelLookup::Fuels.begin(),
+    FuelLookup::Fuels.end(),
+    result.begin(),
+    [nd](const FuelType* fuel) { return nullptr == fuel ? nullptr : &fuel->forSeason(nd); }
+  );
+  return result;
+}
 }
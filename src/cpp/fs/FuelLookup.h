@@ -78,6 +78,16 @@ private:
    */
   shared_ptr<FuelLookupImpl> impl_{nullptr};
 };
+/**
+ * \brief FuelType that does the calculations for each fuel code at a specific time of year
+ */
+using ResolvedFuels = array<const FuelType*, NUMBER_OF_FUELS>;
+/**
+ * \brief Find FuelType that does the calculations for each fuel code
+ * \param nd Difference between date and the date of minimum foliar moisture content
+ * \return FuelType that does the calculations for each fuel code
+ */
+[[nodiscard]] ResolvedFuels resolve_fuels(int nd);
 /**
  * \brief Look up a FuelType based on the given code
  * \param code Value to use for lookup
@@ -3,6 +3,17 @@
 #include "Log.h"
 namespace fs
 {
+void FuelType::survivalProbabilities(
+  const FwiWeather* wx,
+  const size_t count,
+  ThresholdSize* results
+) const noexcept
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    results[i] = survivalProbability(wx[i]);
+  }
+}
 MathSize InvalidFuel::grass_curing(const int, const FwiWeather&) const
 {
   throw runtime_error("Invalid fuel type in fuel map");
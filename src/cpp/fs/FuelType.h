@@ -5,6 +5,7 @@
 #include "Duff.h"
 #include "FireSpread.h"
 #include "FWI.h"
+#include "LookupTable.h"
 namespace fs
 {
 using duff::Duff;
@@ -35,6 +36,22 @@ static constexpr MathSize DUFF_FFMC_DEPTH = 1.2;
 {
   return 300.0 * fc * ros;
 }
+/**
+ * \brief Crown Fraction Burned (CFB) before limiting to positive values [ST-X-3 eq 58]
+ * \param rss_minus_rso Surface Rate of spread (ROS) (m/min) minus critical surface fire spread
+ * rate (RSO)
+ * \return Crown Fraction Burned (CFB) before limiting to positive values [ST-X-3 eq 58]
+ */
+[[nodiscard]] static MathSize calculate_crown_fraction_burned(const MathSize rss_minus_rso) noexcept
+{
+  return 1.0 - exp(-0.230 * rss_minus_rso);
+}
+#ifdef USE_FBP_LOOKUP_TABLES
+/**
+ * \brief Crown Fraction Burned (CFB) [ST-X-3 eq 58] interpolated for every 0.01 m/min
+ */
+static const LookupTable<&calculate_crown_fraction_burned, 2, 2, true> CROWN_FRACTION_BURNED{};
+#endif
 /**
  * \brief An FBP fuel type.
  */
@@ -107,6 +124,16 @@ public:
    * \return Whether or not this fuel can have a crown fire
    */
   [[nodiscard]] constexpr bool canCrown() const { return can_crown_; }
+  /**
+   * \brief FuelType that does the calculations for this fuel at the given time of year
+   * \param nd Difference between date and the date of minimum foliar moisture content
+   * \return FuelType that does the calculations for this fuel at the given time of year
+   */
+  [[nodiscard]] virtual const FuelType& forSeason(const int nd) const noexcept
+  {
+    std::ignore = nd;
+    return *this;
+  }
   /**
    * \brief Grass curing
    * \return Grass curing (or -1 if invalid for this fuel type)
@@ -141,6 +168,14 @@ public:
    * \return Chance of survival (% / 100)
    */
   [[nodiscard]] virtual ThresholdSize survivalProbability(const FwiWeather& wx) const noexcept = 0;
+  /**
+   * \brief Survival probability for many FwiWeather at once
+   * \param wx FwiWeather to calculate survival probability for
+   * \param count Number of FwiWeather
+   * \param results Array to put chance of survival (% / 100) for each FwiWeather into
+   */
+  virtual void survivalProbabilities(const FwiWeather* wx, size_t count, ThresholdSize* results)
+    const noexcept;
   /**
    * \brief BUI Effect on surface fire rate of spread [ST-X-3 eq 54]
    * \param bui Build-up Index
@@ -161,6 +196,26 @@ public:
    * \return Rate of spread (m/min)
    */
   [[nodiscard]] virtual MathSize calculateRos(int nd, const FwiWeather& wx, MathSize isi) const = 0;
+  /**
+   * \brief Initial rate of spread (m/min) [ST-X-3 eq 26] from interpolated lookup table
+   *
+   * Available whether or not USE_FBP_LOOKUP_TABLES is defined so tables can be checked.
+   * \param isi Initial Spread Index
+   * \return Initial rate of spread (m/min) [ST-X-3 eq 26], or NaN if fuel doesn't have its own
+   */
+  [[nodiscard]] virtual MathSize rosBasicInterpolated(MathSize) const noexcept
+  {
+    return numeric_limits<MathSize>::quiet_NaN();
+  }
+  /**
+   * \brief Initial rate of spread (m/min) [ST-X-3 eq 26] calculated without lookup table
+   * \param isi Initial Spread Index
+   * \return Initial rate of spread (m/min) [ST-X-3 eq 26], or NaN if fuel doesn't have its own
+   */
+  [[nodiscard]] virtual MathSize rosBasicCalculated(MathSize) const noexcept
+  {
+    return numeric_limits<MathSize>::quiet_NaN();
+  }
   /**
    * \brief Calculate ISI with slope influence and zero wind (ISF) [ST-X-3 eq 41/42]
    * \param spread SpreadInfo to use
@@ -271,7 +326,11 @@ public:
     const noexcept override
   {
     // can't burn crown if it doesn't exist
-    return cfl() > 0 ? max(0.0, 1.0 - exp(-0.230 * (rss - rso))) : 0.0;
+#ifdef USE_FBP_LOOKUP_TABLES
+    return cfl() > 0 ? max(0.0, CROWN_FRACTION_BURNED(rss - rso)) : 0.0;
+#else
+    return cfl() > 0 ? max(0.0, calculate_crown_fraction_burned(rss - rso)) : 0.0;
+#endif
   }
   /**
    * \brief Calculate probability of burning [Anderson eq 1]
@@ -280,16 +339,7 @@ public:
    */
   [[nodiscard]] ThresholdSize probabilityPeat(const MathSize mc_fraction) const noexcept override
   {
-    // Anderson table 1
-    constexpr auto pb = bulkDensity();
-    // Anderson table 1
-    constexpr auto fi = inorganicPercent();
-    constexpr auto pi = fi * pb;
-    // Inorganic ratio
-    constexpr auto ri = fi / (1 - fi);
-    constexpr auto const_part = -19.329 + 1.7170 * ri + 23.059 * pi;
-    // Anderson eq 1
-    return 1 / (1 + exp(17.047 * mc_fraction / (1 - fi) + const_part));
+    return 1 / (1 + exp(peatExponent(mc_fraction)));
   }
   /**
    * \brief Survival probability calculated using probability of ony survival based on multiple
@@ -304,17 +354,7 @@ public:
     //            (Q$44 * $O$43 + $N$43)))) -
     //            (1 / (1 + EXP($G$43 + $I$43 * (2.5 * $O$43 + $N$43)))))
     //            / (1 / (1 + EXP($G$43 + $I$43 * $N$43))), 0)
-    // HACK: use same constants for all fuels because they seem to work nicer than
-    // using the ratios, but they change anyway because of the other fuel attributes
-    static const auto WFfmc = 0.25;
-    static const auto WDmc = 1.0;
-    static const auto RatioHartford = 0.5;
-    static const auto RatioFrandsen = 1.0 - RatioHartford;
-    static const auto RatioAspen = 0.5;
-    static const auto RatioFuel = 1.0 - RatioAspen;
     const auto mc_ffmc = wx.mcFfmc() * WFfmc + WDmc;
-    static const auto McFfmcSaturated = 2.5 * WFfmc + WDmc;
-    static const auto McDmc = WDmc;
     const auto prob_ffmc_peat = probabilityPeat(mc_ffmc);
     const auto prob_ffmc_peat_saturated = probabilityPeat(McFfmcSaturated);
     const auto prob_ffmc_peat_zero = probabilityPeat(McDmc);
@@ -331,12 +371,80 @@ public:
     const auto prob_weight_ffmc_peat = probabilityPeat(mc_pct / 100);
     const auto prob_weight_dmc = duffDmcType()->probabilityOfSurvival(wx.mcDmcPct());
     const auto prob_weight_dmc_peat = probabilityPeat(wx.mcDmc());
-    // chance of survival is 1 - chance of it not surviving in every fuel
-    const auto tot_prob =
-      1
-      - (1 - prob_ffmc_peat_weighted) * (1 - prob_ffmc_weighted)
-          * ((1 - prob_otway) * RatioAspen + ((1 - prob_weight_ffmc_peat) * RatioHartford + (1 - prob_weight_ffmc) * RatioFrandsen) * ((1 - prob_weight_dmc_peat) * RatioHartford + (1 - prob_weight_dmc) * RatioFrandsen) * RatioFuel);
-    return tot_prob;
+    return combineSurvival(
+      prob_ffmc_peat_weighted,
+      prob_ffmc_weighted,
+      prob_otway,
+      prob_weight_ffmc_peat,
+      prob_weight_ffmc,
+      prob_weight_dmc_peat,
+      prob_weight_dmc
+    );
+  }
+  /**
+   * \brief Survival probability for many FwiWeather at once
+   *
+   * Uses the same formulae as survivalProbability(), but every exp() for a block of values is
+   * done with one call to vector_exp(), so results can differ from it by a few ulp.
+   * \param wx FwiWeather to calculate survival probability for
+   * \param count Number of FwiWeather
+   * \param results Array to put chance of survival (% / 100) for each FwiWeather into
+   */
+  void survivalProbabilities(const FwiWeather* wx, const size_t count, ThresholdSize* results)
+    const noexcept override
+  {
+    static constexpr size_t BLOCK = DAY_HOURS;
+    // one row per exp() in survivalProbability()
+    static constexpr size_t ROWS = 7;
+    const auto prob_ffmc_peat_saturated = probabilityPeat(McFfmcSaturated);
+    const auto prob_ffmc_peat_zero = probabilityPeat(McDmc);
+    const auto prob_ffmc_saturated = duffFfmcType()->probabilityOfSurvival(McFfmcSaturated * 100);
+    const auto prob_ffmc_zero = duffFfmcType()->probabilityOfSurvival(McDmc);
+    array<MathSize, BLOCK> mc_ffmc_pct{};
+    array<MathSize, BLOCK> mc_dmc_pct{};
+    array<MathSize, ROWS * BLOCK> exponents{};
+    array<MathSize, ROWS * BLOCK> exps{};
+    for (size_t start = 0; start < count; start += BLOCK)
+    {
+      const auto n = std::min(BLOCK, count - start);
+      const auto for_block = &wx[start];
+      for (size_t i = 0; i < n; ++i)
+      {
+        mc_ffmc_pct[i] = for_block[i].mcFfmcPct();
+        // same as FwiWeather::mcDmcPct()
+        exponents[i] = (for_block[i].dmc.value - 244.72) / -43.43;
+      }
+      vector_exp(exponents.data(), mc_dmc_pct.data(), n);
+      for (size_t i = 0; i < n; ++i)
+      {
+        mc_dmc_pct[i] += 20;
+        const auto mc_ffmc = mc_ffmc_pct[i] / 100.0 * WFfmc + WDmc;
+        const auto mc_pct = mc_dmc_pct[i] * dmcRatio() + mc_ffmc_pct[i] * ffmcRatio();
+        exponents[i] = peatExponent(mc_ffmc);
+        exponents[BLOCK + i] = duffFfmcType()->survivalExponent(mc_ffmc * 100);
+        exponents[2 * BLOCK + i] = -3.11 + 0.12 * for_block[i].dmc.value;
+        exponents[3 * BLOCK + i] = duffFfmcType()->survivalExponent(mc_pct);
+        exponents[4 * BLOCK + i] = peatExponent(mc_pct / 100);
+        exponents[5 * BLOCK + i] = duffDmcType()->survivalExponent(mc_dmc_pct[i]);
+        exponents[6 * BLOCK + i] = peatExponent(mc_dmc_pct[i] / 100.0);
+      }
+      vector_exp(exponents.data(), exps.data(), exps.size());
+      for (size_t i = 0; i < n; ++i)
+      {
+        const auto prob_ffmc_peat = 1 / (1 + exps[i]);
+        const auto prob_ffmc = Duff::survivalFromExp(exps[BLOCK + i]);
+        const auto term_otway = exps[2 * BLOCK + i];
+        results[start + i] = combineSurvival(
+          (prob_ffmc_peat - prob_ffmc_peat_saturated) / prob_ffmc_peat_zero,
+          (prob_ffmc - prob_ffmc_saturated) / prob_ffmc_zero,
+          term_otway / (1 + term_otway),
+          1 / (1 + exps[4 * BLOCK + i]),
+          Duff::survivalFromExp(exps[3 * BLOCK + i]),
+          1 / (1 + exps[6 * BLOCK + i]),
+          Duff::survivalFromExp(exps[5 * BLOCK + i])
+        );
+      }
+    }
   }
   /**
    * \brief Duff Bulk Density (kg/m^3) [Anderson table 1]
@@ -378,6 +486,55 @@ public:
   }
 
 private:
+  // HACK: use same constants for all fuels because they seem to work nicer than
+  // using the ratios, but they change anyway because of the other fuel attributes
+  static constexpr MathSize WFfmc = 0.25;
+  static constexpr MathSize WDmc = 1.0;
+  static constexpr MathSize RatioHartford = 0.5;
+  static constexpr MathSize RatioFrandsen = 1.0 - RatioHartford;
+  static constexpr MathSize RatioAspen = 0.5;
+  static constexpr MathSize RatioFuel = 1.0 - RatioAspen;
+  static constexpr MathSize McFfmcSaturated = 2.5 * WFfmc + WDmc;
+  static constexpr MathSize McDmc = WDmc;
+  /**
+   * \brief Exponent in probability of burning equation [Anderson eq 1]
+   * \param mc_fraction moisture content (% / 100)
+   * \return Exponent in probability of burning equation [Anderson eq 1]
+   */
+  [[nodiscard]] static constexpr MathSize peatExponent(const MathSize mc_fraction) noexcept
+  {
+    // Anderson table 1
+    constexpr auto pb = bulkDensity();
+    // Anderson table 1
+    constexpr auto fi = inorganicPercent();
+    constexpr auto pi = fi * pb;
+    // Inorganic ratio
+    constexpr auto ri = fi / (1 - fi);
+    constexpr auto const_part = -19.329 + 1.7170 * ri + 23.059 * pi;
+    // Anderson eq 1
+    return 17.047 * mc_fraction / (1 - fi) + const_part;
+  }
+  /**
+   * \brief Chance of survival from chance of survival in each part of the duff
+   * \return Chance of survival (% / 100)
+   */
+  [[nodiscard]] static constexpr ThresholdSize combineSurvival(
+    const ThresholdSize prob_ffmc_peat_weighted,
+    const ThresholdSize prob_ffmc_weighted,
+    const ThresholdSize prob_otway,
+    const ThresholdSize prob_weight_ffmc_peat,
+    const ThresholdSize prob_weight_ffmc,
+    const ThresholdSize prob_weight_dmc_peat,
+    const ThresholdSize prob_weight_dmc
+  ) noexcept
+  {
+    // chance of survival is 1 - chance of it not surviving in every fuel
+    const auto tot_prob =
+      1
+      - (1 - prob_ffmc_peat_weighted) * (1 - prob_ffmc_weighted)
+          * ((1 - prob_otway) * RatioAspen + ((1 - prob_weight_ffmc_peat) * RatioHartford + (1 - prob_weight_ffmc) * RatioFrandsen) * ((1 - prob_weight_dmc_peat) * RatioHartford + (1 - prob_weight_dmc) * RatioFrandsen) * RatioFuel);
+    return tot_prob;
+  }
   /**
    * \brief Type of duff near the surface
    */
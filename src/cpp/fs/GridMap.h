@@ -144,6 +144,15 @@ public:
    * \brief Clear data from GridMap
    */
   void clear() noexcept { this->data = {}; }
+  /**
+   * \brief Estimate of memory used by values in this (bytes)
+   * \return Estimate of memory used by values in this (bytes)
+   */
+  [[nodiscard]] size_t memoryUsed() const noexcept
+  {
+    // each node in a map has three pointers and a colour along with the value
+    return this->data.size() * (sizeof(typename map<XYIdx, T>::value_type) + 4 * sizeof(void*));
+  }
 
 protected:
   tuple<Idx, Idx, Idx, Idx> dataBounds() const override
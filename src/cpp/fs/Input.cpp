@@ -5,73 +5,36 @@
 #include "Util.h"
 namespace fs
 {
-inline MathSize stod(const string* const str) { return stod(*str); }
-FwiWeather read_fwi_weather(istringstream* iss, string* str)
+static MathSize read_value(string_view* text, const char* name)
 {
-  // PREC
-  getline(iss, str, ',');
-  logging::extensive("PREC is {:s}", *str);
-  const Precipitation prec(stod(str));
-  // TEMP
-  getline(iss, str, ',');
-  logging::extensive("TEMP is {:s}", *str);
-  const Temperature temp(stod(str));
-  // RH
-  getline(iss, str, ',');
-  logging::extensive("RH is {:s}", *str);
-  const RelativeHumidity rh(stod(str));
-  // WS
-  getline(iss, str, ',');
-  logging::extensive("WS is {:s}", *str);
-  const Speed ws(stod(str));
-  // WD
-  getline(iss, str, ',');
-  logging::extensive("WD is {:s}", *str);
-  const Direction wd{Degrees{stod(str)}};
+  const auto field = next_field(text, ',');
+  logging::extensive("{:s} is {:s}", name, field);
+  return parse_number<MathSize>(field);
+}
+FwiWeather read_fwi_weather(string_view* text)
+{
+  const Precipitation prec(read_value(text, "PREC"));
+  const Temperature temp(read_value(text, "TEMP"));
+  const RelativeHumidity rh(read_value(text, "RH"));
+  const Speed ws(read_value(text, "WS"));
+  const Direction wd{Degrees{read_value(text, "WD")}};
   const Wind wind{ws, wd};
   // FIX: pretend we're checking these but the flag is unset for now
-  getline(iss, str, ',');
-  logging::extensive("FFMC is {:s}", *str);
-  const Ffmc ffmc(stod(str));
-  getline(iss, str, ',');
-  logging::extensive("DMC is {:s}", *str);
-  const Dmc dmc(stod(str));
-  getline(iss, str, ',');
-  logging::extensive("DC is {:s}", *str);
-  const Dc dc(stod(str));
-  getline(iss, str, ',');
-  logging::extensive("ISI is {:s}", *str);
-  const Isi isi{check_isi(stod(str), ws, ffmc)};
-  getline(iss, str, ',');
-  logging::extensive("BUI is {:s}", *str);
-  const Bui bui{check_bui(stod(str), dmc, dc)};
-  getline(iss, str, ',');
-  logging::extensive("FWI is {:s}", *str);
-  const Fwi fwi{check_fwi(stod(str), isi, bui)};
+  const Ffmc ffmc(read_value(text, "FFMC"));
+  const Dmc dmc(read_value(text, "DMC"));
+  const Dc dc(read_value(text, "DC"));
+  const Isi isi{check_isi(read_value(text, "ISI"), ws, ffmc)};
+  const Bui bui{check_bui(read_value(text, "BUI"), dmc, dc)};
+  const Fwi fwi{check_fwi(read_value(text, "FWI"), isi, bui)};
   return {temp, rh, wind, prec, ffmc, dmc, dc, isi, bui, fwi};
 }
-FwiWeather read_weather(istringstream* iss, string* str)
+FwiWeather read_weather(string_view* text)
 {
-  // PREC
-  getline(iss, str, ',');
-  logging::extensive("PREC is {:s}", *str);
-  const Precipitation prec(stod(str));
-  // TEMP
-  getline(iss, str, ',');
-  logging::extensive("TEMP is {:s}", *str);
-  const Temperature temp(stod(str));
-  // RH
-  getline(iss, str, ',');
-  logging::extensive("RH is {:s}", *str);
-  const RelativeHumidity rh(stod(str));
-  // WS
-  getline(iss, str, ',');
-  logging::extensive("WS is {:s}", *str);
-  const Speed ws(stod(str));
-  // WD
-  getline(iss, str, ',');
-  logging::extensive("WD is {:s}", *str);
-  const Direction wd{Degrees{stod(str)}};
+  const Precipitation prec(read_value(text, "PREC"));
+  const Temperature temp(read_value(text, "TEMP"));
+  const RelativeHumidity rh(read_value(text, "RH"));
+  const Speed ws(read_value(text, "WS"));
+  const Direction wd{Degrees{read_value(text, "WD")}};
   const Wind wind{ws, wd};
   return {
     {.temperature = temp, .rh = rh, .wind = wind, .prec = prec},
@@ -6,16 +6,16 @@
 namespace fs
 {
 /**
- * \brief Read all indices from a stream
- * \param iss Stream to parse
- * \param str string to read into
+ * \brief Read all indices from comma separated text
+ * \param text Text to parse, which gets moved past the fields that were read
+ * \throws runtime_error if any field is not a number
  */
-FwiWeather read_fwi_weather(istringstream* iss, string* str);
+FwiWeather read_fwi_weather(string_view* text);
 /**
- * \brief Read only weather indices from a stream
- * \param iss Stream to parse
- * \param str string to read into
+ * \brief Read only weather indices from comma separated text
+ * \param text Text to parse, which gets moved past the fields that were read
+ * \throws runtime_error if any field is not a number
  */
-FwiWeather read_weather(istringstream* iss, string* str);
+FwiWeather read_weather(string_view* text);
 }
 #endif
@@ -38,6 +38,21 @@ IntensityMap::IntensityMap(const IntensityMap& rhs)
   direction_of_spread_at_max_ = rhs.direction_of_spread_at_max_;
   is_burned_ = rhs.is_burned_;
 }
+void IntensityMap::reset()
+{
+  lock_guard<mutex> lock(mutex_);
+  intensity_max_.clear();
+  if (rate_of_spread_at_max_.has_value())
+  {
+    rate_of_spread_at_max_->clear();
+  }
+  if (direction_of_spread_at_max_.has_value())
+  {
+    direction_of_spread_at_max_->clear();
+  }
+  // only undoes cells that burned instead of copying the whole grid again
+  is_burned_.revert(model_.environment().unburnable());
+}
 void IntensityMap::applyPerimeter(const Perimeter& perimeter) noexcept
 {
   std::for_each(
@@ -150,4 +165,17 @@ map<XYIdx, IntensitySize>::const_iterator IntensityMap::cbegin() const noexcept
 {
   return intensity_max_.data.cbegin();
 }
+size_t IntensityMap::memoryUsed() const noexcept
+{
+  auto result = intensity_max_.memoryUsed() + is_burned_.memoryUsed();
+  if (rate_of_spread_at_max_.has_value())
+  {
+    result += rate_of_spread_at_max_->memoryUsed();
+  }
+  if (direction_of_spread_at_max_.has_value())
+  {
+    result += direction_of_spread_at_max_->memoryUsed();
+  }
+  return result;
+}
 }
@@ -32,6 +32,10 @@ public:
   IntensityMap(IntensityMap&& rhs) = delete;
   IntensityMap& operator=(const IntensityMap& rhs) = delete;
   IntensityMap& operator=(IntensityMap&& rhs) noexcept = delete;
+  /**
+   * \brief Clear everything that has burned so this can be used for another run
+   */
+  void reset();
   [[nodiscard]] Idx height() const { return is_burned_.height(); }
   [[nodiscard]] Idx width() const { return is_burned_.width(); }
   /**
@@ -65,6 +69,11 @@ public:
    * \return Size of the fire represented by this
    */
   [[nodiscard]] MathSize fireSize() const { return is_burned_.fireSize(); }
+  /**
+   * \brief Estimate of memory used by this (bytes)
+   * \return Estimate of memory used by this (bytes)
+   */
+  [[nodiscard]] size_t memoryUsed() const noexcept;
   /**
    * \brief Iterator for underlying GridMap
    * \return Iterator for underlying GridMap
@@ -1,6 +1,7 @@
 /* SPDX-License-Identifier: AGPL-3.0-or-later */
 #include "Iteration.h"
 #include "Scenario.h"
+#include "ThresholdSampler.h"
 namespace fs
 {
 Iteration::~Iteration()
@@ -11,37 +12,40 @@ Iteration::~Iteration()
   }
 }
 Iteration::Iteration(vector<Scenario*> scenarios) noexcept : scenarios_(std::move(scenarios)) { }
-Iteration* Iteration::reset_with_new_start(const XYIdx& start_cell)
+Iteration* Iteration::reset(ThresholdSampler* sampler_extinction, ThresholdSampler* sampler_spread)
 {
-  // HACK: resolve once and fail if not set already
-  static const auto& settings = fs::settings::instance();
-  // HACK: ensure only called with surface
-  logging::check_fatal(
-    !settings.is_surface(), "Called reset_with_new_start() when not calculating surface"
-  );
-  // HACK: just copy code for now
-  // FIX: remove duplicate code
   cancelled_ = false;
   final_sizes_ = {};
-  auto i = 0;
-  // could have multiple weather scenarios so this still makes sense to loop
+  for (auto sampler : {sampler_extinction, sampler_spread})
+  {
+    if (nullptr != sampler)
+    {
+      sampler->nextIteration();
+    }
+  }
+  size_t i = 0;
   for (auto& scenario : scenarios_)
   {
-    logging::extensive("Resetting scenario {:d}", i);
-    std::ignore = scenario->reset_with_new_start(start_cell, &final_sizes_);
+    static_cast<void>(scenario->reset(sampler_extinction, sampler_spread, i, &final_sizes_));
     ++i;
   }
   return this;
 }
-Iteration* Iteration::reset(mt19937_64* mt_extinction, mt19937_64* mt_spread)
+void Iteration::skip(ThresholdSampler* sampler_extinction, ThresholdSampler* sampler_spread)
 {
-  cancelled_ = false;
-  final_sizes_ = {};
+  for (auto sampler : {sampler_extinction, sampler_spread})
+  {
+    if (nullptr != sampler)
+    {
+      sampler->nextIteration();
+    }
+  }
+  size_t i = 0;
   for (auto& scenario : scenarios_)
   {
-    static_cast<void>(scenario->reset(mt_extinction, mt_spread, &final_sizes_));
+    scenario->skip(sampler_extinction, sampler_spread, i);
+    ++i;
   }
-  return this;
 }
 vector<DurationSize> Iteration::savePoints() const { return scenarios_.at(0)->savePoints(); }
 DurationSize Iteration::startTime() const { return scenarios_.at(0)->startTime(); }
@@ -8,6 +8,7 @@ namespace fs
 {
 class ProbabilityMap;
 class Scenario;
+class ThresholdSampler;
 /**
  * \brief Represents a full set of simulations using all available weather streams.
  */
@@ -25,18 +26,19 @@ public:
   Iteration& operator=(const Iteration& rhs) = default;
   Iteration& operator=(Iteration&& rhs) = default;
   /**
-   * \brief Assign start Cell and create new thresholds for use in each Scenario
-   * \param start_cell Cell to start ignition in
+   * \brief Create new thresholds for use in each Scenario
+   * \param sampler_extinction Extinction thresholds
+   * \param sampler_spread Spread thresholds
    * \return This
    */
-  Iteration* reset_with_new_start(const XYIdx& start_cell);
+  Iteration* reset(ThresholdSampler* sampler_extinction, ThresholdSampler* sampler_spread);
   /**
-   * \brief Create new thresholds for use in each Scenario
-   * \param mt_extinction Extinction thresholds
-   * \param mt_spread Spread thresholds
-   * \return This
+   * \brief Draw the same random numbers as reset() without using them, so the next
+   * Iteration gets the thresholds it would have if this one had run
+   * \param sampler_extinction Extinction thresholds
+   * \param sampler_spread Spread thresholds
    */
-  Iteration* reset(mt19937_64* mt_extinction, mt19937_64* mt_spread);
+  void skip(ThresholdSampler* sampler_extinction, ThresholdSampler* sampler_spread);
   /**
    * \brief List of Scenarios this Iteration contains
    * \return List of Scenarios this Iteration contains
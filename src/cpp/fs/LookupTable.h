@@ -13,15 +13,26 @@ namespace fs
  * \tparam Fct Function to apply over the range of values
  * \tparam IndexDigits Number of digits to use for range of values
  * \tparam Precision Precision in decimal places to use for range of values
+ * \tparam Interpolate Whether to interpolate linearly between values instead of truncating
  */
-template <MathSize (*Fct)(const MathSize), int IndexDigits = 3, int Precision = 1>
+template <
+  MathSize (*Fct)(const MathSize),
+  int IndexDigits = 3,
+  int Precision = 1,
+  bool Interpolate = false>
 class LookupTable
 {
 #ifndef LOOKUP_TABLES_OFF
+  /**
+   * \brief Number of steps in range of values
+   */
+  static constexpr size_t NUM_STEPS = pow_int<IndexDigits>(10) * pow_int<Precision>(10);
   /**
    * \brief Array with enough space for function called with specific number of digits and precision
+   *
+   * Interpolating needs the value at the end of the range as well.
    */
-  using ValuesArray = array<MathSize, pow_int<IndexDigits>(10) * pow_int<Precision>(10)>;
+  using ValuesArray = array<MathSize, NUM_STEPS + (Interpolate ? 1 : 0)>;
   /**
    * \brief Array of values from calling function
    */
@@ -60,7 +71,26 @@ public:
    */
   [[nodiscard]] constexpr MathSize operator()(const MathSize value) const
   {
-    return values_.at(static_cast<size_t>(value * pow_int<Precision>(10)));
+#ifdef LOOKUP_TABLES_OFF
+    return Fct(value);
+#else
+    if constexpr (Interpolate)
+    {
+      const auto scaled = value * pow_int<Precision>(10);
+      // negated so NaN also uses the function directly
+      if (!(scaled >= 0.0 && scaled < static_cast<MathSize>(NUM_STEPS)))
+      {
+        return Fct(value);
+      }
+      const auto i = static_cast<size_t>(scaled);
+      const auto fraction = scaled - static_cast<MathSize>(i);
+      return values_[i] + fraction * (values_[i + 1] - values_[i]);
+    }
+    else
+    {
+      return values_.at(static_cast<size_t>(value * pow_int<Precision>(10)));
+    }
+#endif
   }
 };
 }
@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#include "MappedFile.h"
+#include "Log.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+namespace fs
+{
+#ifdef _WIN32
+MappedFile::MappedFile(const string& filename)
+{
+  ifstream in{filename, std::ios::binary};
+  is_open_ = in.is_open();
+  if (is_open_)
+  {
+    contents_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data_ = contents_.data();
+    size_ = contents_.size();
+  }
+}
+MappedFile::~MappedFile() = default;
+#else
+MappedFile::MappedFile(const string& filename)
+{
+  const auto fd = open(filename.c_str(), O_RDONLY);
+  if (-1 == fd)
+  {
+    return;
+  }
+  struct stat info{};
+  if (0 == fstat(fd, &info))
+  {
+    is_open_ = true;
+    size_ = static_cast<size_t>(info.st_size);
+    // can't map an empty file, but there's nothing to read anyway
+    if (0 < size_)
+    {
+      const auto mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (MAP_FAILED == mapped)
+      {
+        logging::error("Could not map file {:s} into memory", filename);
+        is_open_ = false;
+        size_ = 0;
+      }
+      else
+      {
+        // parsing goes from start to end so let the os read ahead
+        madvise(mapped, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(mapped);
+      }
+    }
+  }
+  close(fd);
+}
+MappedFile::~MappedFile()
+{
+  if (nullptr != data_)
+  {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+#endif
+}
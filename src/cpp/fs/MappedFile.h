@@ -0,0 +1,58 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#ifndef FS_MAPPEDFILE_H
+#define FS_MAPPEDFILE_H
+#include "stdafx.h"
+namespace fs
+{
+/**
+ * \brief Read-only view of the contents of a whole file.
+ *
+ * Memory maps the file where possible so large inputs can be parsed without copying them, and
+ * reads the file into memory otherwise.
+ */
+class MappedFile
+{
+public:
+  /**
+   * \brief Open file and map it into memory
+   * \param filename Name of file to open
+   */
+  explicit MappedFile(const string& filename);
+  ~MappedFile();
+  MappedFile(MappedFile&& rhs) = delete;
+  MappedFile(const MappedFile& rhs) = delete;
+  MappedFile& operator=(MappedFile&& rhs) = delete;
+  MappedFile& operator=(const MappedFile& rhs) = delete;
+  /**
+   * \brief Whether or not file was opened
+   * \return Whether or not file was opened
+   */
+  [[nodiscard]] constexpr bool isOpen() const noexcept { return is_open_; }
+  /**
+   * \brief Contents of file
+   * \return Contents of file (empty if not open)
+   */
+  [[nodiscard]] constexpr string_view text() const noexcept { return {data_, size_}; }
+
+private:
+#ifdef _WIN32
+  /**
+   * \brief Contents of file, since it is read instead of mapped
+   */
+  string contents_{};
+#endif
+  /**
+   * \brief Start of file contents
+   */
+  const char* data_{nullptr};
+  /**
+   * \brief Size of file contents
+   */
+  size_t size_{0};
+  /**
+   * \brief Whether or not file was opened
+   */
+  bool is_open_{false};
+};
+}
+#endif
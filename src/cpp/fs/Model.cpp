@@ -1,21 +1,26 @@
 /* SPDX-License-Identifier: AGPL-3.0-or-later */
 #include "Model.h"
+#include "Checkpoint.h"
 #include "FBP45.h"
 #include "FireWeather.h"
 #include "FWI.h"
-#include "Input.h"
 #include "Location.h"
 #include "Log.h"
 #include "Observer.h"
+#include "OffsetMemo.h"
 #include "Perimeter.h"
 #include "ProbabilityMap.h"
 #include "Scenario.h"
 #include "Settings.h"
+#include "SpreadCache.h"
+#include "ThresholdSampler.h"
+#include "WeatherFile.h"
 namespace fs
 {
 // // HACK: assume using half the CPUs probably means that faster cores are being used?
 // constexpr MathSize PCT_CPU = 0.5;
 Semaphore Model::task_limiter{static_cast<int>(std::thread::hardware_concurrency())};
+MemoryBudget Model::memory_budget{0};
 Model::Model(
   const tm& start_time,
   const string_view output_directory,
@@ -32,8 +37,10 @@ Model::Model(
   const Settings& settings
 )
   : output_directory_(output_directory), start_time_(start_time), running_since_(Clock::now()),
-    time_limit_(settings.maximum_time_seconds), no_interim_save_since_(Clock::now()),
-    interim_save_interval_(settings.interim_output_interval_seconds), env_(env),
+    time_limit_(std::chrono::seconds(settings.maximum_time_seconds)),
+    no_interim_save_since_(Clock::now()),
+    interim_save_interval_(std::chrono::seconds(settings.interim_output_interval_seconds)),
+    env_(env),
     active_simulations_still_required_(settings.minimum_active_simulation_count),
     latitude_(start_point.latitude()), longitude_(start_point.longitude())
 {
@@ -49,6 +56,15 @@ Model::Model(
       calculate_is_green(nd_.at(static_cast<size_t>(day))) ? "" : " not",
       calculate_grass_curing(nd_.at(static_cast<size_t>(day)))
     );
+    // only changes with green-up so keep one copy of each distinct set of fuels
+    const auto resolved = resolve_fuels(nd_.at(static_cast<size_t>(day)));
+    const auto seek = std::find(resolved_fuels_.begin(), resolved_fuels_.end(), resolved);
+    resolved_fuels_by_day_.at(static_cast<size_t>(day)) =
+      static_cast<size_t>(std::distance(resolved_fuels_.begin(), seek));
+    if (resolved_fuels_.end() == seek)
+    {
+      resolved_fuels_.push_back(resolved);
+    }
   }
 }
 void Model::setWeather(const FwiWeather& weather, const Day start_day)
@@ -57,213 +73,191 @@ void Model::setWeather(const FwiWeather& weather, const Day start_day)
   static const auto& settings = fs::settings::instance();
   static const auto& lookup = settings.fuel_lookup.lookup();
   yesterday_ = weather;
+  // every thread uses the same weather, so they can all share spread
+  spread_caches_.emplace(0, make_shared<SpreadCache>());
   const auto& f = lookup.usedFuels();
   wx_.emplace(
     0,
-    FireWeather{
+    make_shared<FireWeather>(
       f, static_cast<Day>(start_day - 1), weather.dc, weather.dmc, weather.ffmc, weather.wind
-    }
+    )
   );
   wx_daily_.emplace(
     0,
-    FireWeather{
+    make_shared<FireWeather>(
       f, static_cast<Day>(start_day - 1), weather.dc, weather.dmc, weather.ffmc, weather.wind
-    }
+    )
   );
 }
+/**
+ * \brief Last day that any output is saved for
+ * \param start_day Start date for simulation
+ * \return Last day that any output is saved for
+ */
+static Day find_last_date(const Day start_day)
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  auto last_date = start_day;
+  for (const auto& i : settings.output_date_offsets.offsets())
+  {
+    last_date = max(static_cast<Day>(start_day + i), last_date);
+  }
+  return last_date;
+}
+/**
+ * \brief Weather in a stream that a simulation can use between two days
+ * \param hourly Hourly weather starting at min_date
+ * \param daily Daily weather for each day
+ * \param min_date First day of hourly weather
+ * \param from First day to include
+ * \param to Last day to include
+ * \return Hourly weather for the days followed by daily weather for each day
+ */
+static vector<FwiWeather> weather_used(
+  const vector<FwiWeather>& hourly,
+  const map<Day, FwiWeather>& daily,
+  const Day min_date,
+  const Day from,
+  const Day to
+)
+{
+  vector<FwiWeather> result{};
+  const auto first = static_cast<size_t>(from - min_date) * DAY_HOURS;
+  const auto last = min(hourly.size(), static_cast<size_t>(to - min_date + 1) * DAY_HOURS);
+  if (first < last)
+  {
+    result.insert(result.end(), hourly.begin() + first, hourly.begin() + last);
+  }
+  for (auto day = from; day <= to; ++day)
+  {
+    const auto seek = daily.find(day);
+    // days without daily weather still need to line up between streams
+    result.push_back(daily.end() == seek ? FwiWeather{} : seek->second);
+  }
+  return result;
+}
 void Model::readWeather(
   const FwiWeather& yesterday,
   const MathSize latitude,
-  const string& filename
+  const string& filename,
+  const Day start_day,
+  const Day last_date
 )
 {
   // HACK: resolve once and fail if not set already
   static const auto& settings = fs::settings::instance();
   static const auto& lookup = settings.fuel_lookup.lookup();
-  map<size_t, vector<FwiWeather>> wx{};
-  map<size_t, map<Day, FwiWeather>> wx_daily{};
-  map<Day, struct tm> dates{};
-  Day min_date = numeric_limits<Day>::max();
-  Day max_date = numeric_limits<Day>::min();
-  time_t prev_time = numeric_limits<time_t>::min();
-  ifstream in{filename};
-  logging::check_fatal(!in.is_open(), "Could not open input weather file {:s}", filename);
-  if (in.is_open())
-  {
+  auto streams = read_weather_streams(filename, yesterday, latitude);
+  year_ = streams.year;
+  const auto min_date = streams.min_date;
+  const auto max_date = streams.max_date;
 #ifdef DEBUG_WEATHER
-    const auto file_out = string(output_directory_) + "/wx_hourly_out_read.csv";
-    ofstream out{file_out};
-    logging::check_fatal(!out.is_open(), "Cannot open file {:s} for output", file_out.c_str());
-    out << "Scenario,Date,PREC,TEMP,RH,WS,WD,FFMC,DMC,DC,ISI,BUI,FWI\r\n";
+  const auto file_out = string(output_directory_) + "/wx_hourly_out_read.csv";
+  ofstream out{file_out};
+  logging::check_fatal(!out.is_open(), "Cannot open file {:s} for output", file_out.c_str());
+  out << "Scenario,Date,PREC,TEMP,RH,WS,WD,FFMC,DMC,DC,ISI,BUI,FWI\r\n";
 #endif
-    string str;
-    logging::info("Reading scenarios from '{:s}'", filename);
-    // read header line
-    getline(in, str);
-    // get rid of whitespace
-    str.erase(std::remove(str.begin(), str.end(), ' '), str.end());
-    str.erase(std::remove(str.begin(), str.end(), '\n'), str.end());
-    str.erase(std::remove(str.begin(), str.end(), '\r'), str.end());
-    constexpr auto expected_header = "Scenario,Date,PREC,TEMP,RH,WS,WD,FFMC,DMC,DC,ISI,BUI,FWI";
-    logging::check_fatal(
-      expected_header != str,
-      "Input CSV must have columns in this order:\n'{:s}'\n but got:\n'{:s}'",
-      expected_header,
-      str
-    );
-    auto prev = &yesterday;
-    // HACK: adding to original object if we don't do this?
-    auto apcp_24h = yesterday.prec.value;
-    while (getline(in, str))
+  const auto& f = lookup.usedFuels();
+  // nothing outside of this can affect a simulation, so streams that only differ outside of it
+  // give the same results
+  const auto from = max(min_date, static_cast<Day>(start_day - 1));
+  const auto to = min(max_date, last_date);
+  // first stream with each hash of the weather that gets used
+  unordered_map<size_t, vector<size_t>> by_hash{};
+  vector<vector<FwiWeather>> used(streams.scenarios.size());
+  // scenario numbers that have the same weather as the first stream that had it
+  map<size_t, vector<size_t>> same_weather{};
+  for (size_t i = 0; i < streams.scenarios.size(); ++i)
+  {
+    const auto k = streams.scenarios.at(i);
+    auto& s = streams.hourly.at(i);
+#ifdef DEBUG_WEATHER
+    for (size_t for_time = 0; for_time < s.size(); ++for_time)
     {
-      istringstream iss(str);
-      if (getline(iss, str, ',') && !str.empty())
+      const auto& w = s.at(for_time);
+      if (FwiWeather{} == w)
       {
-        // HACK: ignore date and just worry about relative order??
-        // Scenario
-        logging::verbose("Scenario is {:s}", str);
-        size_t cur = 0;
-        try
-        {
-          cur = static_cast<size_t>(stoi(str));
-        }
-        catch (const std::exception& ex)
-        {
-          // HACK: somehow stoi() is still getting empty strings
-          logging::fatal(
-            ex, "Error reading weather file {:s}: {:s} is not a valid integer", filename, str
-          );
-        }
-        if (wx.find(cur) == wx.end())
-        {
-          logging::debug("Loading scenario {:d}...", cur);
-          wx.emplace(cur, vector<FwiWeather>{});
-          prev_time = std::numeric_limits<time_t>::min();
-          logging::check_fatal(
-            wx_daily.find(cur) != wx_daily.end(),
-            "Somehow have daily weather for scenario {:d} before hourly weather",
-            cur
-          );
-          wx_daily.emplace(cur, map<Day, FwiWeather>());
-          prev = &yesterday;
-          logging::extensive(
-            "Resetting new scenario precip to {:f} from {:f}", yesterday.prec.value, apcp_24h
-          );
-          apcp_24h = yesterday.prec.value;
-        }
-        auto& s = wx.at(cur);
-        struct tm t{};
-        read_date(&iss, &str, &t);
-        year_ = t.tm_year + TM_YEAR_OFFSET;
-        const auto ticks = mktime(&t);
-        if (1 == cur)
-        {
-          logging::debug("Date '{:s}' is {:d} and calculated jd is {:d}", str, ticks, t.tm_yday);
-          if (!s.empty() && t.tm_yday < min_date)
-          {
-            exit(
-              logging::fatal("Weather input file crosses year boundary or dates are not sequential")
-            );
-          }
-        }
-        min_date = min(min_date, static_cast<Day>(t.tm_yday));
-        max_date = max(max_date, static_cast<Day>(t.tm_yday));
-        time_t cur_time = mktime(&t);
-        if (prev_time != std::numeric_limits<time_t>::min())
-        {
-          auto seconds_diff = (cur_time - prev_time);
-          logging::check_fatal(
-            seconds_diff != HOUR_SECONDS,
-            "Expected sequential hours in weather input but rows are {:f} hours away from each other",
-            seconds_diff / static_cast<MathSize>(HOUR_SECONDS)
-          );
-        }
-        prev_time = cur_time;
-        const auto for_time = (t.tm_yday - min_date) * DAY_HOURS + t.tm_hour;
-        // HACK: can be up until rest of year since start date
-        const size_t new_size = (max_date - min_date + 1) * DAY_HOURS;
-        const auto old_size = s.size();
-        if (old_size != new_size)
-        {
-          s.resize(new_size);
-        }
-        logging::verbose("for_time == {:d}", for_time);
-        FwiWeather w{read_fwi_weather(&iss, &str)};
-        s.at(for_time) = w;
-        logging::check_fatal(
-          0 > w.prec.value, "Hourly weather precip {:f} is negative", w.prec.value
-        );
-        apcp_24h += w.prec.value;
-        logging::extensive(
-          "Adding {:f} to precip results in accumulation of {:f}", w.prec.value, apcp_24h
-        );
-        if (12 == t.tm_hour)
-        {
-          // we just hit noon on a new day, so add the daily value
-          auto& s_daily = wx_daily.at(cur);
-          const auto day = static_cast<Day>(t.tm_yday);
-          logging::check_fatal(s_daily.find(day) != s_daily.end(), "Day already exists");
-          const auto month = t.tm_mon + 1;
-          s_daily.emplace(
-            day,
-            FwiWeather{*prev, month, latitude, w.temperature, w.rh, w.wind, Precipitation(apcp_24h)}
-          );
-          // new 24 hour period
-          logging::extensive("Resetting daily precip to {:f} from {:f}", 0.0, apcp_24h);
-          apcp_24h = 0;
-          prev = &s_daily.at(static_cast<Day>(t.tm_yday));
-        }
-#ifdef DEBUG_WEATHER
-        const auto month = t.tm_mon + 1;
-        const auto fmt_line = std::format(
-          "{:d},{:d}-{:02d}-{:02d} {:02d}:{:02d}:{:02d},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f}",
-          cur,
-          year_,
-          month,
-          t.tm_mday,
-          t.tm_hour,
-          t.tm_min,
-          t.tm_sec,
-          w.prec.value,
-          w.temperature.value,
-          w.rh.value,
-          w.wind.speed.value,
-          w.wind.direction.value,
-          w.ffmc.value,
-          w.dmc.value,
-          w.dc.value,
-          w.isi.value,
-          w.bui.value,
-          w.fwi.value
-        );
-        logging::debug(fmt_line.c_str());
-        out << fmt_line << "\r\n";
-#endif
+        continue;
       }
+      size_t month;
+      size_t day_of_month;
+      month_and_day(year_, min_date + for_time / DAY_HOURS, &month, &day_of_month);
+      const auto fmt_line = std::format(
+        "{:d},{:d}-{:02d}-{:02d} {:02d}:{:02d}:{:02d},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f},{:1.6f}",
+        k,
+        year_,
+        month,
+        day_of_month,
+        for_time % DAY_HOURS,
+        0,
+        0,
+        w.prec.value,
+        w.temperature.value,
+        w.rh.value,
+        w.wind.speed.value,
+        w.wind.direction.value,
+        w.ffmc.value,
+        w.dmc.value,
+        w.dc.value,
+        w.isi.value,
+        w.bui.value,
+        w.fwi.value
+      );
+      logging::debug(fmt_line.c_str());
+      out << fmt_line << "\r\n";
     }
-#ifdef DEBUG_WEATHER
-    out.close();
-    logging::check_fatal(out.fail(), "Could not close file {:s}", file_out.c_str());
 #endif
-    in.close();
-  }
-  const auto& f = lookup.usedFuels();
-  // loop through and try to find duplicates
-  for (const auto& kv : wx)
-  {
-    const auto k = kv.first;
-    const auto& s = kv.second;
-    // FIX: this is just looking for duplicate scenario ids, not weather?
+    // ignore streams for a scenario number that was already read
     if (wx_.find(k) == wx_.end())
     {
-      wx_.emplace(k, FireWeather{f, min_date, max_date, s});
+      auto& s_daily = streams.daily.at(i);
+      auto& cur = used.at(i);
+      cur = weather_used(s, s_daily, min_date, from, to);
+      const string_view bytes{
+        reinterpret_cast<const char*>(cur.data()), cur.size() * sizeof(FwiWeather)
+      };
+      auto& candidates = by_hash[std::hash<string_view>{}(bytes)];
+      const auto same = std::find_if(candidates.begin(), candidates.end(), [&](const size_t j) {
+        const auto& other = used.at(j);
+        return other.size() == cur.size() && 0 == memcmp(other.data(), cur.data(), bytes.size());
+      });
+      if (candidates.end() != same)
+      {
+        const auto first = streams.scenarios.at(*same);
+        wx_.emplace(k, wx_.at(first));
+        wx_daily_.emplace(k, wx_daily_.at(first));
+        same_weather.at(first).push_back(k);
+        cur.clear();
+        continue;
+      }
+      candidates.push_back(i);
+      same_weather.emplace(k, vector<size_t>{k});
+      wx_.emplace(k, make_shared<FireWeather>(f, min_date, max_date, std::move(s)));
       // calculate daily indices
-      auto& s_daily = wx_daily.at(k);
       // HACK: set yesterday to match today
       s_daily.emplace(min_date - 1, s_daily.at(min_date));
-      wx_daily_.emplace(k, FireWeather{f, s_daily});
+      wx_daily_.emplace(k, make_shared<FireWeather>(f, s_daily));
+    }
+  }
+  for (const auto& kv : same_weather)
+  {
+    if (1 < kv.second.size())
+    {
+      const auto cache = make_shared<SpreadCache>();
+      for (const auto k : kv.second)
+      {
+        spread_caches_.emplace(k, cache);
+      }
     }
   }
+  logging::note(
+    "Found {:d} distinct weather streams for {:d} scenarios", same_weather.size(), wx_.size()
+  );
+#ifdef DEBUG_WEATHER
+  out.close();
+  logging::check_fatal(out.fail(), "Could not close file {:s}", file_out.c_str());
+#endif
 }
 void Model::findStarts(const XYIdx& location)
 {
@@ -332,6 +326,50 @@ void Model::findAllStarts()
   }
   logging::info("Using {:d} start locations:", ignitionScenarios());
 }
+size_t Model::surfaceThreads() const noexcept
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  if (!settings.run_async)
+  {
+    return 1;
+  }
+  const auto hardware_threads = static_cast<size_t>(std::thread::hardware_concurrency());
+  return max(static_cast<size_t>(1), min(hardware_threads, ignitionScenarios()));
+}
+void Model::runSurface(
+  const Iteration& iteration,
+  map<DurationSize, shared_ptr<ProbabilityMap>>* probabilities
+)
+{
+  atomic<size_t> next_start{0};
+  SafeVector final_sizes{};
+  const auto run_starts = [&](Scenario* scenario) {
+    for (auto i = next_start++; i < starts_.size(); i = next_start++)
+    {
+      std::ignore = scenario->reset_with_new_start(starts_[i], &final_sizes);
+      if (nullptr == scenario->run(probabilities))
+      {
+        // cancelled
+        return;
+      }
+      ++scenarios_done_;
+    }
+  };
+  const auto& scenarios = iteration.getScenarios();
+  logging::note("Running {:d} starts with {:d} threads", starts_.size(), scenarios.size());
+  vector<std::thread> threads{};
+  for (size_t i = 1; i < scenarios.size(); ++i)
+  {
+    threads.emplace_back(run_starts, scenarios[i]);
+  }
+  run_starts(scenarios[0]);
+  for (auto& t : threads)
+  {
+    t.join();
+  }
+  iterations_done_ = scenarios_done_;
+}
 void Model::makeStarts(
   Coordinates coordinates,
   const Point& point,
@@ -446,26 +484,30 @@ Iteration Model::readScenarios(
   };
   if (settings.is_surface())
   {
-    setup_scenario(new Scenario(
-      this,
-      0,
-      &wx_.at(0),
-      &wx_daily_.at(0),
-      start,
-      nullptr,
-      starts_.at(0),
-      start_point,
-      start_day,
-      last_date
-    ));
+    // each thread reuses its own Scenario for every start it runs
+    for (size_t i = 0; i < surfaceThreads(); ++i)
+    {
+      setup_scenario(new Scenario(
+        this,
+        0,
+        wx_.at(0).get(),
+        wx_daily_.at(0).get(),
+        start,
+        nullptr,
+        starts_.at(0),
+        start_point,
+        start_day,
+        last_date
+      ));
+    }
   }
   else
   {
     for (const auto& kv : wx_)
     {
       const auto id = kv.first;
-      const auto* cur_wx = &kv.second;
-      const auto* cur_daily = &wx_daily_.at(id);
+      const auto* cur_wx = kv.second.get();
+      const auto* cur_daily = wx_daily_.at(id).get();
       // FIX: this should simplify to the loop and passing both location & perim
       if (nullptr != perimeter_)
       {
@@ -509,6 +551,76 @@ Iteration Model::readScenarios(
   }
   return Iteration(result);
 }
+ptr<SpreadCache> Model::spreadCache(const size_t id) const
+{
+  const auto seek = spread_caches_.find(id);
+  return spread_caches_.end() == seek ? nullptr : seek->second.get();
+}
+ptr<const vector<size_t>> Model::nextSpreadHours(
+  const ptr<const FireWeather> weather,
+  const ptr<const FireWeather> weather_daily
+)
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  lock_guard<mutex> lock(mutex_next_spread_hours_);
+  const auto seek = next_spread_hours_.find({weather, weather_daily});
+  if (next_spread_hours_.end() != seek)
+  {
+    return &seek->second;
+  }
+  const auto min_ffmc = min(settings.minimum_ffmc, settings.minimum_ffmc_at_night);
+  const auto& hourly = weather->getWeather();
+  const auto& by_hour = weather_daily->getWeather();
+  // can't rule out any fuels if the stream doesn't know which ones it's used with
+  const auto has_fuels = std::ranges::any_of(weather->fuels(), [](const FuelType* used) {
+    return nullptr != used;
+  });
+  const auto can_spread = [&](const size_t hour) {
+    const auto& wx_daily = by_hour[hour];
+    const auto time =
+      static_cast<DurationSize>(hour + DAY_HOURS * weather_daily->minDate()) / DAY_HOURS;
+    const auto i = static_cast<ptrdiff_t>(time_index(time))
+                 - static_cast<ptrdiff_t>(DAY_HOURS) * weather->minDate();
+    // don't skip hours without weather so they fail the same way they would otherwise
+    if (FwiWeather{} == wx_daily || 0 > i || hourly.size() <= static_cast<size_t>(i)
+        || FwiWeather{} == hourly[static_cast<size_t>(i)])
+    {
+      return true;
+    }
+    if (wx_daily.ffmc.value < min_ffmc)
+    {
+      return false;
+    }
+    // fuels are only resolved for days in a year
+    if (!has_fuels || MAX_DAYS <= static_cast<Day>(time))
+    {
+      return true;
+    }
+    const auto& wx = hourly[static_cast<size_t>(i)];
+    const auto& fuels_now = fuels(time);
+    return std::ranges::any_of(weather->fuels(), [&](const FuelType* used) {
+      if (nullptr == used)
+      {
+        return false;
+      }
+      const auto fuel = fuels_now.at(FuelType::safeCode(used));
+      return !is_null_fuel(fuel)
+          && SpreadInfo::maximumRos(fuel, nd(time), wx, wx_daily) >= settings.minimum_ros;
+    });
+  };
+  vector<size_t> result(by_hour.size());
+  auto next = by_hour.size();
+  for (auto hour = by_hour.size(); hour > 0; --hour)
+  {
+    if (can_spread(hour - 1))
+    {
+      next = hour - 1;
+    }
+    result[hour - 1] = next;
+  }
+  return &next_spread_hours_.emplace(pair{weather, weather_daily}, std::move(result)).first->second;
+}
 [[nodiscard]] std::chrono::seconds Model::runTime() const
 {
   const auto run_time = last_checked_ - runningSince();
@@ -587,8 +699,6 @@ bool Model::add_statistics(
   const SafeVector& sizes
 )
 {
-  // HACK: resolve once and fail if not set already
-  static const auto& settings = fs::settings::instance();
   const auto i = pct->size();
   const auto cur_sizes = sizes.getValues();
   logging::check_fatal(cur_sizes.empty(), "No sizes at end of simulation");
@@ -601,18 +711,24 @@ bool Model::add_statistics(
   {
     static_cast<void>(insert_sorted(all_sizes, size));
   }
+  return check_statistics(*all_sizes, i);
+}
+bool Model::check_statistics(const vector<MathSize>& all_sizes, const size_t iterations)
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
   if (settings.is_surface())
   {
     return true;
   }
-  is_under_simulation_minimum_ = all_sizes->size() < settings.minimum_simulation_count;
+  is_under_simulation_minimum_ = all_sizes.size() < settings.minimum_simulation_count;
   if (isUnderSimulationCountMinimum())
   {
     return true;
   }
   active_simulations_still_required_ = [&]() {
     size_t num_left = settings.minimum_active_simulation_count;
-    for (const auto s : *all_sizes)
+    for (const auto s : all_sizes)
     {
       if (s > initial_size())
       {
@@ -625,7 +741,7 @@ bool Model::add_statistics(
       }
     }
     logging::note(
-      "Not enough active simulations out of {:d} results to meet minimum", all_sizes->size()
+      "Not enough active simulations out of {:d} results to meet minimum", all_sizes.size()
     );
     return num_left;
   }();
@@ -633,12 +749,12 @@ bool Model::add_statistics(
   {
     return true;
   }
-  is_over_simulation_count_ = all_sizes->size() >= settings.maximum_simulation_count;
+  is_over_simulation_count_ = all_sizes.size() >= settings.maximum_simulation_count;
   if (isOverSimulationCountMaximum())
   {
     logging::note(
       "Stopping after {:d} iterations. Simulation limit of {:d} simulations has been reached.",
-      i,
+      iterations,
       +settings.maximum_simulation_count
     );
     return false;
@@ -647,7 +763,7 @@ bool Model::add_statistics(
   {
     logging::note(
       "Stopping after {:d} iterations. Time limit of {:d} seconds has been reached.",
-      i,
+      iterations,
       +settings.maximum_time_seconds
     );
     return false;
@@ -664,12 +780,17 @@ bool Model::add_statistics(
  *
  * 2) the amount of variability in the output statistics has decreased to a point
  * that is less than the confidence level defined in the settings file
+ *
+ * 3) if MAXIMUM_PROBABILITY_ERROR is set, the binomial standard error of the burn
+ * probability for the last output date is below it instead of (2), using either the
+ * worst cell or the root mean square over all cells that burned
  */
 size_t runs_required(
   const size_t i,
   const vector<MathSize>* all_sizes,
   const vector<MathSize>* means,
   const vector<MathSize>* pct,
+  ptr<ProbabilityMap> last_probabilities,
   const Model& model
 )
 {
@@ -726,6 +847,22 @@ size_t runs_required(
     logging::note("Cannot calculate statistics with only {:d} value", min_values);
     return 1;
   }
+  if (nullptr != last_probabilities && 0 < settings.maximum_probability_error)
+  {
+    const auto error = last_probabilities->standardError(settings.probability_error_mean);
+    const auto n = last_probabilities->numSizes();
+    logging::debug("Standard error of burn probability after {:d} simulations is {:f}", n, error);
+    if (error <= settings.maximum_probability_error)
+    {
+      return 0;
+    }
+    // standard error shrinks with square root of number of simulations
+    const auto ratio = error / settings.maximum_probability_error;
+    const auto sims_left = static_cast<size_t>(ceil(n * ratio * ratio)) - n;
+    const auto sims_per_iteration = max(static_cast<size_t>(1), n / i);
+    const auto left = (sims_left + sims_per_iteration - 1) / sims_per_iteration;
+    return min(max_sims_left, max(static_cast<size_t>(1), left));
+  }
   const auto for_sizes = Statistics{*all_sizes};
   const auto for_means = Statistics{*means};
   const auto for_pct = Statistics{*pct};
@@ -828,6 +965,305 @@ DurationSize Model::saveProbabilities(
   }
   return final_time;
 }
+/**
+ * \brief Start of every checkpoint file
+ */
+static constexpr array<char, 8> CHECKPOINT_MAGIC{'F', 'S', 'C', 'H', 'E', 'C', 'K', 'P'};
+static constexpr uint64_t CHECKPOINT_VERSION = 2;
+/**
+ * \brief Value that reads differently if file was written on machine with other byte order
+ */
+static constexpr uint64_t CHECKPOINT_BYTE_ORDER = 0x0102030405060708ULL;
+/**
+ * \brief Name of checkpoint file in output directory
+ */
+static constexpr auto CHECKPOINT_FILE_NAME = "checkpoint.fsc";
+/**
+ * \brief Header at start of checkpoint file.
+ *
+ * Header is followed by:
+ *   - state of extinction and then spread ThresholdSampler
+ *   - all sizes, mean sizes, and 95th percentile sizes (MathSize), each preceded by count
+ *   - state of ProbabilityMap for each save point in order of time
+ */
+struct CheckpointHeader
+{
+  array<char, 8> magic;
+  uint64_t version;
+  uint64_t byte_order;
+  uint64_t scenarios_per_iteration;
+  uint64_t iterations_done;
+  uint64_t num_probabilities;
+  uint64_t scenarios_done;
+  uint64_t scenarios_required_done;
+  uint64_t scenarios_last_save;
+  uint64_t seconds_since_interim_save;
+  uint64_t interim_changed;
+};
+void Model::saveCheckpoint(
+  const ThresholdSampler& sampler_extinction,
+  const ThresholdSampler& sampler_spread,
+  const vector<MathSize>& all_sizes,
+  const vector<MathSize>& means,
+  const vector<MathSize>& pct,
+  const map<DurationSize, shared_ptr<ProbabilityMap>>& probabilities
+) const
+{
+  const auto file_out = output_directory_ + CHECKPOINT_FILE_NAME;
+  // write somewhere else first so being stopped part way through keeps the last checkpoint
+  const auto file_tmp = file_out + ".tmp";
+  ofstream out{file_tmp, std::ios::binary};
+  logging::check_fatal(!out.is_open(), "Cannot open file {:s} for output", file_tmp);
+  const CheckpointHeader header{
+    .magic = CHECKPOINT_MAGIC,
+    .version = CHECKPOINT_VERSION,
+    .byte_order = CHECKPOINT_BYTE_ORDER,
+    .scenarios_per_iteration = scenarios_per_iteration_,
+    .iterations_done = iterations_done_,
+    .num_probabilities = probabilities.size(),
+    .scenarios_done = scenarios_done_,
+    .scenarios_required_done = scenarios_required_done_,
+    .scenarios_last_save = scenarios_last_save_,
+    .seconds_since_interim_save = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - no_interim_save_since_)
+        .count()
+    ),
+    .interim_changed = interim_changed_
+  };
+  checkpoint::write_value(out, header);
+  sampler_extinction.save(out);
+  sampler_spread.save(out);
+  checkpoint::write_values(out, all_sizes);
+  checkpoint::write_values(out, means);
+  checkpoint::write_values(out, pct);
+  for (const auto& kv : probabilities)
+  {
+    kv.second->saveState(out);
+  }
+  out.close();
+  logging::check_fatal(out.fail(), "Could not close file {:s}", file_tmp);
+  std::filesystem::rename(file_tmp, file_out);
+  logging::note("Saved checkpoint after {:d} iterations to {:s}", iterations_done_, file_out);
+}
+void Model::loadCheckpoint(
+  const string& file_name,
+  ThresholdSampler* sampler_extinction,
+  ThresholdSampler* sampler_spread,
+  vector<MathSize>* all_sizes,
+  vector<MathSize>* means,
+  vector<MathSize>* pct,
+  map<DurationSize, shared_ptr<ProbabilityMap>>* probabilities
+)
+{
+  ifstream in{file_name, std::ios::binary};
+  logging::check_fatal(!in.is_open(), "Could not open checkpoint {:s}", file_name);
+  const auto header = checkpoint::read_value<CheckpointHeader>(in);
+  logging::check_fatal(
+    CHECKPOINT_MAGIC != header.magic, "File {:s} is not a checkpoint", file_name
+  );
+  logging::check_fatal(
+    CHECKPOINT_BYTE_ORDER != header.byte_order,
+    "Checkpoint {:s} was written on a machine with different byte order",
+    file_name
+  );
+  logging::check_fatal(
+    CHECKPOINT_VERSION != header.version,
+    "Checkpoint {:s} is version {:d} but expected version {:d}",
+    file_name,
+    header.version,
+    CHECKPOINT_VERSION
+  );
+  // thresholds would be different if inputs changed, but at least catch obvious mismatches
+  logging::check_fatal(
+    scenarios_per_iteration_ != header.scenarios_per_iteration,
+    "Checkpoint {:s} has {:d} scenarios per iteration instead of {:d}",
+    file_name,
+    header.scenarios_per_iteration,
+    scenarios_per_iteration_
+  );
+  logging::check_fatal(
+    probabilities->size() != header.num_probabilities,
+    "Checkpoint {:s} has {:d} output dates instead of {:d}",
+    file_name,
+    header.num_probabilities,
+    probabilities->size()
+  );
+  sampler_extinction->load(in);
+  sampler_spread->load(in);
+  *all_sizes = checkpoint::read_values<MathSize>(in);
+  *means = checkpoint::read_values<MathSize>(in);
+  *pct = checkpoint::read_values<MathSize>(in);
+  for (auto& kv : *probabilities)
+  {
+    kv.second->loadState(in);
+  }
+  iterations_done_ = static_cast<size_t>(header.iterations_done);
+  scenarios_done_ = static_cast<size_t>(header.scenarios_done);
+  scenarios_required_done_ = static_cast<size_t>(header.scenarios_required_done);
+  scenarios_last_save_ = static_cast<size_t>(header.scenarios_last_save);
+  // keep interim outputs on the same schedule as if the run hadn't stopped
+  no_interim_save_since_ =
+    Clock::now() - std::chrono::seconds(static_cast<int64_t>(header.seconds_since_interim_save));
+  interim_changed_ = 0 != header.interim_changed;
+  logging::note("Resuming after {:d} iterations from checkpoint {:s}", iterations_done_, file_name);
+}
+/**
+ * \brief Start of every shard file
+ */
+static constexpr array<char, 8> SHARD_MAGIC{'F', 'S', 'S', 'H', 'A', 'R', 'D', 'S'};
+static constexpr uint64_t SHARD_VERSION = 1;
+/**
+ * \brief Header at start of shard file.
+ *
+ * Header is followed by:
+ *   - burned and then edge Locations of initial Perimeter (XYIdx), each preceded by count
+ *   - definition and then state of ProbabilityMap for each save point in order of time
+ */
+struct ShardHeader
+{
+  array<char, 8> magic;
+  uint64_t version;
+  uint64_t byte_order;
+  uint64_t shard_index;
+  uint64_t shard_count;
+  uint64_t num_probabilities;
+  /**
+   * \brief Fields of start time that are used for output names
+   */
+  array<int, 9> start_time;
+};
+void Model::saveShard(const map<DurationSize, shared_ptr<ProbabilityMap>>& probabilities) const
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  const auto file_out = output_directory_
+                      + std::format(
+                          "shard_{:d}_of_{:d}.fsp", settings.shard_index, settings.shard_count
+                        );
+  ofstream out{file_out, std::ios::binary};
+  logging::check_fatal(!out.is_open(), "Cannot open file {:s} for output", file_out);
+  const auto& t = start_time_;
+  const array<int, 9> start_fields{
+    t.tm_sec, t.tm_min, t.tm_hour, t.tm_mday, t.tm_mon, t.tm_year, t.tm_wday, t.tm_yday, t.tm_isdst
+  };
+  const ShardHeader header{
+    .magic = SHARD_MAGIC,
+    .version = SHARD_VERSION,
+    .byte_order = CHECKPOINT_BYTE_ORDER,
+    .shard_index = settings.shard_index,
+    .shard_count = settings.shard_count,
+    .num_probabilities = probabilities.size(),
+    .start_time = start_fields
+  };
+  checkpoint::write_value(out, header);
+  const auto write_locations = [&out](const list<XYIdx>& locations) {
+    checkpoint::write_values(out, vector<XYIdx>{locations.begin(), locations.end()});
+  };
+  write_locations(nullptr == perimeter_ ? list<XYIdx>{} : perimeter_->burned);
+  write_locations(nullptr == perimeter_ ? list<XYIdx>{} : perimeter_->edge);
+  for (const auto& kv : probabilities)
+  {
+    kv.second->saveDefinition(out);
+    kv.second->saveState(out);
+  }
+  out.close();
+  logging::check_fatal(out.fail(), "Could not close file {:s}", file_out);
+  logging::note(
+    "Saved {:d} iterations for shard {:d} of {:d} to {:s}",
+    iterations_done_,
+    settings.shard_index,
+    settings.shard_count,
+    file_out
+  );
+}
+int Model::mergeShards(const string_view output_directory, const vector<string>& file_names)
+{
+  map<DurationSize, shared_ptr<ProbabilityMap>> probabilities{};
+  tm start_time{};
+  size_t shard_count = 0;
+  set<size_t> shards{};
+  for (const auto& file_name : file_names)
+  {
+    ifstream in{file_name, std::ios::binary};
+    logging::check_fatal(!in.is_open(), "Could not open shard {:s}", file_name);
+    const auto header = checkpoint::read_value<ShardHeader>(in);
+    logging::check_fatal(SHARD_MAGIC != header.magic, "File {:s} is not a shard", file_name);
+    logging::check_fatal(
+      CHECKPOINT_BYTE_ORDER != header.byte_order,
+      "Shard {:s} was written on a machine with different byte order",
+      file_name
+    );
+    logging::check_fatal(
+      SHARD_VERSION != header.version,
+      "Shard {:s} is version {:d} but expected version {:d}",
+      file_name,
+      header.version,
+      SHARD_VERSION
+    );
+    logging::check_fatal(
+      !shards.empty() && shard_count != header.shard_count,
+      "Shard {:s} is one of {:d} shards instead of {:d}",
+      file_name,
+      header.shard_count,
+      shard_count
+    );
+    shard_count = static_cast<size_t>(header.shard_count);
+    logging::check_fatal(
+      !shards.insert(static_cast<size_t>(header.shard_index)).second,
+      "Shard {:d} was given more than once",
+      header.shard_index
+    );
+    auto burned = checkpoint::read_values<XYIdx>(in);
+    auto edge = checkpoint::read_values<XYIdx>(in);
+    const auto perimeter = burned.empty()
+                           ? nullptr
+                           : make_shared<Perimeter>(
+                               list<XYIdx>{burned.begin(), burned.end()},
+                               list<XYIdx>{edge.begin(), edge.end()}
+                             );
+    logging::check_fatal(
+      !probabilities.empty() && probabilities.size() != header.num_probabilities,
+      "Shard {:s} has {:d} output dates instead of {:d}",
+      file_name,
+      header.num_probabilities,
+      probabilities.size()
+    );
+    for (size_t i = 0; i < header.num_probabilities; ++i)
+    {
+      // every shard has the same definitions, so only need maps from the first one
+      const auto for_shard = ProbabilityMap::loadDefinition(in, perimeter);
+      auto seek = probabilities.find(for_shard->time);
+      if (probabilities.end() == seek)
+      {
+        seek = probabilities.emplace(for_shard->time, for_shard).first;
+      }
+      seek->second->loadState(in);
+    }
+    const auto& s = header.start_time;
+    start_time.tm_sec = s[0];
+    start_time.tm_min = s[1];
+    start_time.tm_hour = s[2];
+    start_time.tm_mday = s[3];
+    start_time.tm_mon = s[4];
+    start_time.tm_year = s[5];
+    start_time.tm_wday = s[6];
+    start_time.tm_yday = s[7];
+    start_time.tm_isdst = s[8];
+    logging::note(
+      "Merged shard {:d} of {:d} from {:s}", header.shard_index, shard_count, file_name
+    );
+  }
+  for (size_t i = 0; i < shard_count; ++i)
+  {
+    logging::check_fatal(!shards.contains(i), "Missing shard {:d} of {:d}", i, shard_count);
+  }
+  show_probabilities(probabilities);
+  for (const auto& [time, prob] : probabilities)
+  {
+    std::ignore = prob->saveAll(output_directory, start_time, time, processed);
+  }
+  return 0;
+}
 map<DurationSize, shared_ptr<ProbabilityMap>> Model::runIterations(
   const StartPoint& start_point,
   const DurationSize start,
@@ -836,11 +1272,7 @@ map<DurationSize, shared_ptr<ProbabilityMap>> Model::runIterations(
 {
   // HACK: resolve once and fail if not set already
   static const auto& settings = fs::settings::instance();
-  auto last_date = start_day;
-  for (const auto& i : settings.output_date_offsets.offsets())
-  {
-    last_date = max(static_cast<Day>(start_day + i), last_date);
-  }
+  const auto last_date = find_last_date(start_day);
   // use independent seeds so that if we remove one threshold it doesn't affect the other
   // HACK: seed_seq takes a list of integers now, so multiply and convert to get more digits
   // NOTE: use abs() because negative numbers act differently on arm64 vs x64 vs windows
@@ -879,8 +1311,15 @@ map<DurationSize, shared_ptr<ProbabilityMap>> Model::runIterations(
   };
   auto seed_spread = make_seed("spread", 0);
   auto seed_extinction = make_seed("extinction", 1);
-  mt19937_64 mt_spread(seed_spread);
-  mt19937_64 mt_extinction(seed_extinction);
+  ThresholdSampler sampler_spread(seed_spread, settings.threshold_strata);
+  ThresholdSampler sampler_extinction(seed_extinction, settings.threshold_strata);
+  if (sampler_spread.isStratified())
+  {
+    logging::note(
+      "Using Latin hypercube sampling with {:d} strata for scenario and daily thresholds",
+      +settings.threshold_strata
+    );
+  }
   vector<MathSize> all_sizes{};
   vector<MathSize> means{};
   vector<MathSize> pct{};
@@ -917,12 +1356,89 @@ map<DurationSize, shared_ptr<ProbabilityMap>> Model::runIterations(
     numeric_limits<int>::max()
   ));
   logging::verbose("Setting up initial intensity map with perimeter");
-  auto runs_left = 1;
+  // shards can't stop based on results from other shards, so always run up to the maximum
+  const size_t shard_runs = [&]() -> size_t {
+    if (!settings.is_sharded())
+    {
+      return 0;
+    }
+    const auto total = settings.deterministic
+                       ? 1
+                       : max(
+                           static_cast<size_t>(1),
+                           (settings.maximum_simulation_count + scenarios_per_iteration_ - 1)
+                             / scenarios_per_iteration_
+                         );
+    return total > settings.shard_index
+           ? (total - settings.shard_index - 1) / settings.shard_count + 1
+           : 0;
+  }();
+  if (settings.is_sharded())
+  {
+    logging::note(
+      "Running {:d} iterations for shard {:d} of {:d}",
+      shard_runs,
+      settings.shard_index,
+      settings.shard_count
+    );
+    logging::check_fatal(!settings.resume.empty(), "Can't resume a run that is split into shards");
+  }
+  const auto find_runs_left = [&]() -> size_t {
+    if (settings.is_sharded())
+    {
+      return shard_runs - iterations_done_;
+    }
+    return runs_required(
+      iterations_done_, &all_sizes, &means, &pct, probabilities.rbegin()->second.get(), *this
+    );
+  };
+  size_t runs_left = settings.is_sharded() ? shard_runs : 1;
+  if (!settings.resume.empty())
+  {
+    loadCheckpoint(
+      settings.resume.canonical(),
+      &sampler_extinction,
+      &sampler_spread,
+      &all_sizes,
+      &means,
+      &pct,
+      &probabilities
+    );
+    // use stop conditions from current settings so a finished run can be extended
+    static_cast<void>(check_statistics(all_sizes, pct.size()));
+    runs_left = find_runs_left();
+    logging::note("Need another {:d} iterations", runs_left);
+  }
+  constexpr size_t BYTES_PER_MB = 1024 * 1024;
+  if (0 != settings.memory_limit_mb)
+  {
+    logging::note(
+      "Only starting scenarios while running ones are estimated to use less than {:d} MB",
+      settings.memory_limit_mb
+    );
+  }
+  Model::memory_budget.set_limit(settings.memory_limit_mb * BYTES_PER_MB);
   bool is_being_cancelled = false;
+  mutex mutex_controller{};
+  std::condition_variable controller_changed{};
+  // wake the controller so it decides what to do as soon as anything changes
+  const auto notify_controller = [&]() {
+    {
+      // lock so the change can't happen between the controller checking and waiting
+      std::lock_guard<mutex> lock{mutex_controller};
+    }
+    controller_changed.notify_all();
+  };
+  // controller reads runs_left while holding the lock, so only change it while holding it too
+  const auto set_runs_left = [&](const size_t value) {
+    {
+      std::lock_guard<mutex> lock{mutex_controller};
+      runs_left = value;
+    }
+    controller_changed.notify_all();
+  };
   // HACK: use initial value for type
   auto timer = std::thread([&]() {
-    constexpr auto CHECK_INTERVAL = 1s;
-    bool keep_checking{true};
     const bool is_limited = 0 != settings.maximum_time_seconds;
     const bool with_interim = 0 != interim_save_interval_.count();
     if (!is_limited)
@@ -933,23 +1449,57 @@ map<DurationSize, shared_ptr<ProbabilityMap>> Model::runIterations(
     {
       logging::note("No interim outputs being generated since INTERIM_OUTPUT_INTERVAL = 0");
     }
-    while (keep_checking)
+    std::unique_lock<mutex> lock{mutex_controller};
+    while (true)
     {
       this->last_checked_ = Clock::now();
-      // think we need to check regularly instead of just sleeping so that we can see
-      // if we've done enough runs and need to stop for that reason
-      std::this_thread::sleep_for(CHECK_INTERVAL);
       // set bool so other things don't need to check clock
-      is_out_of_time_ = is_limited && runTime().count() >= timeLimit().count();
+      is_out_of_time_ = is_limited && runTime() >= timeLimit();
       should_output_interim_ =
-        with_interim && timeSinceLastSave().count() >= interimTimeLimit().count();
+        with_interim && timeSinceLastSave() >= interimTimeLimit();
       if (should_output_interim_ && interim_changed_)
       {
+        lock.unlock();
         saveProbabilities(all_probabilities[0], start_day, true);
+        lock.lock();
+      }
+      logging::verbose(
+        "Checking clock [{:d} of {:d}]",
+        runTime().count(),
+        std::chrono::duration_cast<std::chrono::seconds>(timeLimit()).count()
+      );
+      if (0 == runs_left || shouldStop())
+      {
+        break;
+      }
+      // sleep until the next deadline unless a scenario finishes or run state changes first
+      auto wake_at = Clock::time_point::max();
+      const auto wake_after = [&](const Clock::time_point since, const Clock::duration limit) {
+        // a limit too far away to ever be reached can't be added without overflowing
+        if (0 < limit.count() && limit < Clock::time_point::max() - since)
+        {
+          wake_at = min(wake_at, since + limit);
+        }
+      };
+      if (is_limited && !is_out_of_time_)
+      {
+        wake_after(runningSince(), timeLimit());
+      }
+      // if already due then wait for something to change instead of saving the same thing again
+      if (with_interim && !should_output_interim_)
+      {
+        wake_after(no_interim_save_since_, interimTimeLimit());
+      }
+      if (Clock::time_point::max() == wake_at)
+      {
+        controller_changed.wait(lock);
+      }
+      else
+      {
+        controller_changed.wait_until(lock, wake_at);
       }
-      logging::verbose("Checking clock [{:d} of {:d}]", runTime().count(), timeLimit().count());
-      keep_checking = (runs_left > 0 && !shouldStop());
     }
+    lock.unlock();
     if (isOutOfTime())
     {
       logging::warning("Ran out of time - cancelling simulations");
@@ -1002,27 +1552,58 @@ map<DurationSize, shared_ptr<ProbabilityMap>> Model::runIterations(
     }
     if (timer.joinable())
     {
+      notify_controller();
       timer.join();
     }
+    logging::note(
+      "Peak estimated memory for running scenarios was {:0.1f} MB ({:0.1f} MB for largest)",
+      static_cast<MathSize>(Model::memory_budget.peak()) / BYTES_PER_MB,
+      static_cast<MathSize>(Model::memory_budget.largest()) / BYTES_PER_MB
+    );
     return probabilities;
   };
-  // if using surface just run each start through in a loop here
-  size_t cur_start = 0;
+  if (settings.is_surface())
+  {
+    // add straight into maps that interim saves use so nothing needs to be merged per start
+    runSurface(iteration, &all_probabilities[0]);
+    probabilities = all_probabilities[0];
+    set_runs_left(0);
+    return finalize_probabilities();
+  }
+  if (0 == runs_left)
+  {
+    // resumed from a checkpoint that already meets the stop conditions, or shard has nothing
+    return finalize_probabilities();
+  }
+  const auto checkpoint_interval = std::chrono::seconds(settings.checkpoint_interval_seconds);
+  auto last_checkpoint = Clock::now();
+  // only call between iterations so every iteration is either all in checkpoint or not at all
+  const auto save_checkpoint = [&](const bool is_final) {
+    // if out of time then the last iteration might have been cancelled part way through
+    if (0 == checkpoint_interval.count() || isOutOfTime())
+    {
+      return;
+    }
+    if (is_final || Clock::now() - last_checkpoint >= checkpoint_interval)
+    {
+      saveCheckpoint(sampler_extinction, sampler_spread, all_sizes, means, pct, probabilities);
+      last_checkpoint = Clock::now();
+    }
+  };
+  // index of next iteration out of all the iterations every shard draws thresholds for
+  size_t next_iteration = 0;
   auto reset_iter = [&](Iteration& iter) {
-    if (settings.is_surface())
+    if (settings.is_sharded())
     {
-      if (cur_start >= starts_.size())
+      // draw thresholds for iterations other shards run so these match an unsharded run
+      while (settings.shard_index != next_iteration % settings.shard_count)
       {
-        return false;
+        ++next_iteration;
+        iter.skip(&sampler_extinction, &sampler_spread);
       }
-      auto start_cell = starts_[cur_start];
-      iter.reset_with_new_start(start_cell);
-      ++cur_start;
-    }
-    else
-    {
-      iter.reset(&mt_extinction, &mt_spread);
+      ++next_iteration;
     }
+    iter.reset(&sampler_extinction, &sampler_spread);
     return true;
   };
   if (settings.run_async)
@@ -1053,6 +1634,8 @@ map<DurationSize, shared_ptr<ProbabilityMap>> Model::runIterations(
         numeric_limits<int>::max()
       ));
     }
+    // scenarios of current iteration that are done running, which controller lock protects
+    size_t scenarios_finished = 0;
     auto run_scenario = [&](Scenario* s, size_t i, bool is_required) {
       const auto result = s->run(&all_probabilities[i]);
       ++scenarios_done_;
@@ -1091,6 +1674,12 @@ map<DurationSize, shared_ptr<ProbabilityMap>> Model::runIterations(
           }
         }
       }
+      {
+        std::lock_guard<mutex> lock{mutex_controller};
+        ++scenarios_finished;
+      }
+      // wake main loop so iteration gets added as soon as its last scenario finishes
+      controller_changed.notify_all();
       return result;
     };
     logging::debug("Created {:d} iterations to run concurrently", all_iterations.size());
@@ -1110,18 +1699,27 @@ map<DurationSize, shared_ptr<ProbabilityMap>> Model::runIterations(
     cur_iter = 0;
     while (runs_left > 0)
     {
-      // should have completed one iteration, so add it
       auto& iteration = all_iterations[cur_iter];
-      // so now try to loop through and add iterations as they finish
-      // FIX: look at converting so that new threads get started as others complete
-      // - would have to have multiple Iterations so we keep the data from them separate?
-      size_t k = 0;
-      while (k < scenarios_per_iteration_)
       {
-        threads.front().join();
-        threads.pop_front();
-        ++k;
+        // wait for whichever scenario finishes last instead of joining in the order they started
+        std::unique_lock<mutex> lock{mutex_controller};
+        controller_changed.wait(lock, [&]() {
+          return scenarios_per_iteration_ <= scenarios_finished;
+        });
+        scenarios_finished = 0;
+      }
+      // all threads are done running so joining doesn't wait
+      for (auto& t : threads)
+      {
+        t.join();
       }
+      threads.clear();
+      if (isOutOfTime())
+      {
+        // cancelled part way through so don't count what did run
+        return finalize_probabilities();
+      }
+      // should have completed one iteration, so add it
       auto final_sizes = iteration.finalSizes();
       ++iterations_done_;
       for (auto& kv : all_probabilities[cur_iter])
@@ -1132,20 +1730,13 @@ map<DurationSize, shared_ptr<ProbabilityMap>> Model::runIterations(
       }
       if (!add_statistics(&all_sizes, &means, &pct, final_sizes))
       {
+        save_checkpoint(true);
         // ran out of time but timer should cancel everything
         return finalize_probabilities();
       }
-      {
-        if (settings.is_surface())
-        {
-          runs_left = ignitionScenarios() - iterations_done_;
-        }
-        else
-        {
-          runs_left = runs_required(iterations_done_, &all_sizes, &means, &pct, *this);
-          logging::note("Need another {:d} iterations", runs_left);
-        }
-      }
+      set_runs_left(find_runs_left());
+      logging::note("Need another {:d} iterations", runs_left);
+      save_checkpoint(0 == runs_left);
       if (runs_left > 0)
       {
         if (reset_iter(iteration))
@@ -1179,22 +1770,23 @@ map<DurationSize, shared_ptr<ProbabilityMap>> Model::runIterations(
         for (auto s : iteration.getScenarios())
         {
           s->run(&probabilities);
+          notify_controller();
+        }
+        if (isOutOfTime())
+        {
+          // cancelled part way through so don't count sizes from what did run
+          return finalize_probabilities();
         }
         ++iterations_done_;
         if (!add_statistics(&all_sizes, &means, &pct, iteration.finalSizes()))
         {
+          save_checkpoint(true);
           // ran out of time but timer should cance everything
           return finalize_probabilities();
         }
-        if (settings.is_surface())
-        {
-          runs_left = ignitionScenarios() - iterations_done_;
-        }
-        else
-        {
-          runs_left = runs_required(iterations_done_, &all_sizes, &means, &pct, *this);
-          logging::note("Need another {:d} iterations", runs_left);
-        }
+        set_runs_left(find_runs_left());
+        logging::note("Need another {:d} iterations", runs_left);
+        save_checkpoint(0 == runs_left);
       }
     }
   }
@@ -1256,12 +1848,18 @@ int Model::runScenarios(
   }
   else
   {
-    model.readWeather(yesterday, start_point.latitude(), weather_input.canonical());
+    model.readWeather(
+      yesterday,
+      start_point.latitude(),
+      weather_input.canonical(),
+      start_day,
+      find_last_date(start_day)
+    );
     if (model.wx_.empty())
     {
       exit(logging::fatal("No weather provided"));
     }
-    const auto& w = model.wx_.begin()->second;
+    const auto& w = *model.wx_.begin()->second;
     logging::debug("Have weather from day {:d} to {:d}", w.minDate(), w.maxDate());
     const auto numDays = (w.maxDate() - w.minDate() + 1);
     const auto needDays = settings.output_date_offsets.max();
@@ -1296,9 +1894,43 @@ int Model::runScenarios(
     time_left
   );
   logging::debug("Processed {:d} spread events between all scenarios", Scenario::total_steps());
+  logging::debug(
+    "Spread points in {:d} cells over {:d} steps between all scenarios",
+    Scenario::cells_spread(),
+    Scenario::spread_steps()
+  );
+  logging::debug(
+    "Made {:d} allocations from scenario arenas using {:d} blocks from heap",
+    Scenario::arena_allocations(),
+    Scenario::arena_blocks()
+  );
+  logging::debug(
+    "Shared {:d} spread calculations between scenarios with the same weather after doing {:d}",
+    SpreadCache::reused(),
+    SpreadCache::calculated()
+  );
+  if (0 < settings.offset_memo_size)
+  {
+    logging::debug(
+      "Calculated {:d} and reused {:d} spread offset sets, with max position error of {:f} "
+      "cells per minute of spread over {:d} samples",
+      OffsetMemo::computed(),
+      OffsetMemo::reused(),
+      OffsetMemo::maxPositionError(),
+      OffsetMemo::sampled()
+    );
+  }
   show_probabilities(probabilities);
-  // auto final_time =
-  model.saveProbabilities(probabilities, start_day, false);
+  if (settings.is_sharded())
+  {
+    // outputs come from merging this with other shards
+    model.saveShard(probabilities);
+  }
+  else
+  {
+    // auto final_time =
+    model.saveProbabilities(probabilities, start_day, false);
+  }
   // HACK: update last checked time to use in calculation
   model.last_checked_ = Clock::now();
   logging::note("Total simulation time was {:d} seconds", model.runTime().count());
@@ -1310,7 +1942,7 @@ void Model::outputWeather()
   outputWeather(wx_, "wx_hourly_out.csv");
   outputWeather(wx_daily_, "wx_daily_out.csv");
 }
-void Model::outputWeather(map<size_t, FireWeather>& weather, const char* file_name)
+void Model::outputWeather(map<size_t, shared_ptr<FireWeather>>& weather, const char* file_name)
 {
   const auto file_out = string(output_directory_) + file_name;
   const auto file_out_fbp = string(output_directory_) + string("fbp_") + file_name;
@@ -1325,7 +1957,7 @@ void Model::outputWeather(map<size_t, FireWeather>& weather, const char* file_na
   size_t i = 0;
   for (auto& kv : weather)
   {
-    auto& s = kv.second;
+    auto& s = *kv.second;
     // do we need to index this by hour and day?
     // was assuming it started at 0 for first hour and day
     auto& wx = s.getWeather();
@@ -1335,7 +1967,7 @@ void Model::outputWeather(map<size_t, FireWeather>& weather, const char* file_na
     for (size_t j = 0; j < wx_size; ++j)
     {
       size_t day = hour / 24;
-      auto w = wx.at(hour - min_hour);
+      const auto w = s.at(static_cast<DurationSize>(hour) / DAY_HOURS);
       size_t month;
       size_t day_of_month;
       month_and_day(year_, day, &month, &day_of_month);
@@ -14,6 +14,8 @@ using settings::Settings;
 class StartPoint;
 struct Event;
 class Scenario;
+class SpreadCache;
+class ThresholdSampler;
 /**
  * \brief Provides the ability to limit number of threads running at once.
  */
@@ -106,6 +108,168 @@ public:
     }
   }
 };
+/**
+ * \brief Provides the ability to limit how much memory things running at once are estimated to use.
+ */
+class MemoryBudget
+{
+public:
+  /**
+   * \brief Create a MemoryBudget that limits estimated memory used by things running at once
+   * \param limit Estimated memory things can use at once (bytes) (0 is unlimited)
+   */
+  explicit MemoryBudget(const size_t limit) : limit_{limit} { }
+  MemoryBudget(const MemoryBudget& rhs) = delete;
+  MemoryBudget(MemoryBudget&& rhs) = delete;
+  MemoryBudget& operator=(const MemoryBudget& rhs) = delete;
+  MemoryBudget& operator=(MemoryBudget&& rhs) = delete;
+  void set_limit(const size_t limit)
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    logging::debug("Changing MemoryBudget limit from {:d} to {:d}", limit_, limit);
+    limit_ = limit;
+    cv_.notify_all();
+  }
+  size_t limit() { return limit_; }
+  /**
+   * \brief Most memory that things running at once were estimated to use (bytes)
+   * \return Most memory that things running at once were estimated to use (bytes)
+   */
+  size_t peak()
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    return peak_;
+  }
+  /**
+   * \brief Most memory that one thing was estimated to use (bytes)
+   * \return Most memory that one thing was estimated to use (bytes)
+   */
+  size_t largest()
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    return largest_;
+  }
+  /**
+   * \brief Wait until there is enough memory and then reserve it
+   * \param bytes Estimated memory needed to start (bytes)
+   * \return Memory that was reserved (bytes)
+   */
+  size_t reserve(size_t bytes)
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    // assume it will grow as much as the largest thing that ran already did
+    bytes = max(bytes, largest_);
+    // NOTE: always let one thing run so something larger than the limit still runs
+    cv_.wait(l, [&] { return 0 == limit_ || 0 == used_ || used_ + bytes <= limit_; });
+    used_ += bytes;
+    peak_ = max(peak_, used_);
+    return bytes;
+  }
+  /**
+   * \brief Reserve more memory for something that is already running without waiting
+   * \param bytes Memory to add to reservation (bytes)
+   */
+  void grow(const size_t bytes)
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    used_ += bytes;
+    peak_ = max(peak_, used_);
+  }
+  /**
+   * \brief Release reserved memory so something that's waiting can run
+   * \param reserved Memory that was reserved (bytes)
+   * \param used Most memory that was estimated to be used (bytes)
+   */
+  void release(const size_t reserved, const size_t used)
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    used_ -= reserved;
+    largest_ = max(largest_, used);
+    cv_.notify_all();
+  }
+
+private:
+  /**
+   * \brief Mutex for parallel access
+   */
+  std::mutex mutex_;
+  /**
+   * \brief Condition variable to use for checking memory
+   */
+  std::condition_variable cv_;
+  /**
+   * \brief Estimated memory things can use at once (bytes) (0 is unlimited)
+   */
+  size_t limit_;
+  /**
+   * \brief Memory reserved by things that are running (bytes)
+   */
+  size_t used_{0};
+  /**
+   * \brief Most memory that was reserved at once (bytes)
+   */
+  size_t peak_{0};
+  /**
+   * \brief Most memory that one thing was estimated to use (bytes)
+   */
+  size_t largest_{0};
+};
+/**
+ * \brief Indicates a section of code that only starts once a MemoryBudget has memory for it.
+ */
+class MemoryReservation
+{
+  /**
+   * \brief MemoryBudget that this reserves memory from
+   */
+  MemoryBudget& budget_;
+  /**
+   * \brief Memory that is reserved (bytes)
+   */
+  size_t reserved_;
+  /**
+   * \brief Most memory that was estimated to be used (bytes)
+   */
+  size_t used_{0};
+
+public:
+  /**
+   * \brief Constructor
+   * \param budget MemoryBudget to reserve memory from
+   * \param bytes Estimated memory needed to start (bytes)
+   */
+  MemoryReservation(MemoryBudget& budget, const size_t bytes)
+    : budget_{budget}, reserved_{budget.reserve(bytes)}
+  { }
+  MemoryReservation(const MemoryReservation& rhs) = delete;
+  MemoryReservation(MemoryReservation&& rhs) = delete;
+  MemoryReservation& operator=(const MemoryReservation& rhs) = delete;
+  MemoryReservation& operator=(MemoryReservation&& rhs) = delete;
+  /**
+   * \brief Update estimate of memory used, and reserve more if it's more than was reserved
+   * \param bytes Estimated memory being used now (bytes)
+   */
+  void update(const size_t bytes)
+  {
+    used_ = max(used_, bytes);
+    if (used_ > reserved_)
+    {
+      budget_.grow(used_ - reserved_);
+      reserved_ = used_;
+    }
+  }
+  ~MemoryReservation() noexcept
+  {
+    try
+    {
+      budget_.release(reserved_, used_);
+    }
+    catch (const std::exception& ex)
+    {
+      exit(logging::fatal(ex));
+    }
+  }
+};
 /**
  * \brief Contains all the immutable information regarding a simulation that is common between
  * Scenarios.
@@ -135,6 +299,20 @@ public:
     const LazyPath& perimeter,
     const size_t size
   );
+  /**
+   * \brief Add counts from every shard of a run together and save outputs from them
+   *
+   * Shards can't stop based on results from other shards, so each one runs its part of
+   * MAXIMUM_SIMULATIONS. Merged outputs are the same as a run that isn't split only if that
+   * run doesn't stop sooner because of its confidence level or other stop conditions.
+   * \param output_directory Folder to save outputs to
+   * \param file_names Shard files that were saved by runs of each shard
+   * \return Result code (0 if successful)
+   */
+  [[nodiscard]] static int mergeShards(
+    const string_view output_directory,
+    const vector<string>& file_names
+  );
   [[nodiscard]]
   Cell cell(const XYIdx xy) const
   {
@@ -163,8 +341,8 @@ public:
    */
   [[nodiscard]] constexpr Clock::duration timeLimit() const { return time_limit_; }
   /**
-   * \brief Time between generating interim outputs (s)
-   * \return Time between generating interim outputs (s)
+   * \brief Time between generating interim outputs
+   * \return Time between generating interim outputs
    */
   [[nodiscard]] constexpr Clock::duration interimTimeLimit() const
   {
@@ -210,6 +388,26 @@ public:
    * \return How many Scenarios are in each Iteration
    */
   [[nodiscard]] size_t scenarioCount() const noexcept { return wx_.size() * ignitionScenarios(); }
+  /**
+   * \brief SpreadCache shared by Scenarios with the same weather as scenario number
+   * \param id Scenario number
+   * \return SpreadCache to use, or nullptr if no other scenario has the same weather
+   */
+  [[nodiscard]] ptr<SpreadCache> spreadCache(size_t id) const;
+  /**
+   * \brief First hour at or after each hour of weather_daily that fire could spread in
+   *
+   * Hours are skipped if daily FFMC is too low for spread at any time of day, or if no used
+   * fuel could reach the minimum rate of spread with any wind or slope. Only calculated once
+   * for each pair of weather streams.
+   * \param weather Weather stream to use for spread
+   * \param weather_daily Weather stream to use for spread and extinction probability
+   * \return First hour at or after each hour of weather_daily that fire could spread in
+   */
+  [[nodiscard]] ptr<const vector<size_t>> nextSpreadHours(
+    ptr<const FireWeather> weather,
+    ptr<const FireWeather> weather_daily
+  );
   /**
    * \brief Difference between date and the date of minimum foliar moisture content
    * \param time Date to get value for
@@ -219,6 +417,15 @@ public:
   {
     return nd_.at(static_cast<Day>(time));
   }
+  /**
+   * \brief FuelType that does the calculations for each fuel code on date
+   * \param time Date to get value for
+   * \return FuelType that does the calculations for each fuel code on date
+   */
+  [[nodiscard]] const ResolvedFuels& fuels(const DurationSize time) const
+  {
+    return resolved_fuels_[resolved_fuels_by_day_.at(static_cast<Day>(time))];
+  }
   [[nodiscard]] const char* outputDirectory() const { return output_directory_.c_str(); }
   /**
    * \brief Duration that model has run for
@@ -274,11 +481,22 @@ public:
   void setWeather(const FwiWeather& weather, const Day start_day);
   /**
    * \brief Read weather used for Scenarios
+   *
+   * Scenarios that have identical weather between start_day and last_date share one
+   * FireWeather and can reuse SpreadInfo that any of them calculates.
    * \param yesterday FwiWeather for yesterday
    * \param latitude Latitude to calculate for
    * \param filename Weather file to read
+   * \param start_day Start date for simulation
+   * \param last_date End date for simulation
    */
-  void readWeather(const FwiWeather& yesterday, const MathSize latitude, const string& filename);
+  void readWeather(
+    const FwiWeather& yesterday,
+    const MathSize latitude,
+    const string& filename,
+    Day start_day,
+    Day last_date
+  );
   /**
    * \brief Make starts based on desired point and where nearest combustible cells are
    * \param coordinates Coordinates in the Environment to try starting at
@@ -305,6 +523,10 @@ public:
    * \brief Semaphore used to limit how many things run at once
    */
   static Semaphore task_limiter;
+  /**
+   * \brief MemoryBudget used to limit how much memory running Scenarios use
+   */
+  static MemoryBudget memory_budget;
   /**
    * Conditions for yesterday (or constant weather)
    */
@@ -334,6 +556,54 @@ private:
     vector<MathSize>* pct,
     const SafeVector& sizes
   );
+  /**
+   * \brief Update stop conditions based on all sizes that simulations have produced
+   * \param all_sizes All sizes that simulations have produced
+   * \param iterations Number of iterations to report stopping after
+   * \return Whether simulation should keep going
+   */
+  [[nodiscard]] bool check_statistics(const vector<MathSize>& all_sizes, size_t iterations);
+  /**
+   * \brief Save counts and sizes from the iterations this shard ran so they can be merged
+   * \param probabilities Map of times to ProbabilityMap with results from this shard
+   */
+  void saveShard(const map<DurationSize, shared_ptr<ProbabilityMap>>& probabilities) const;
+  /**
+   * \brief Save everything needed to continue from the end of the current iteration
+   * \param sampler_extinction ThresholdSampler used for extinction thresholds
+   * \param sampler_spread ThresholdSampler used for spread thresholds
+   * \param all_sizes All sizes that simulations have produced
+   * \param means Mean sizes per iteration
+   * \param pct 95th percentile sizes per iteration
+   * \param probabilities Map of times to ProbabilityMap with results so far
+   */
+  void saveCheckpoint(
+    const ThresholdSampler& sampler_extinction,
+    const ThresholdSampler& sampler_spread,
+    const vector<MathSize>& all_sizes,
+    const vector<MathSize>& means,
+    const vector<MathSize>& pct,
+    const map<DurationSize, shared_ptr<ProbabilityMap>>& probabilities
+  ) const;
+  /**
+   * \brief Restore everything that was saved by saveCheckpoint()
+   * \param file_name Checkpoint to read
+   * \param sampler_extinction ThresholdSampler used for extinction thresholds
+   * \param sampler_spread ThresholdSampler used for spread thresholds
+   * \param all_sizes All sizes that simulations have produced
+   * \param means Mean sizes per iteration
+   * \param pct 95th percentile sizes per iteration
+   * \param probabilities Map of times to ProbabilityMap to add results to
+   */
+  void loadCheckpoint(
+    const string& file_name,
+    ThresholdSampler* sampler_extinction,
+    ThresholdSampler* sampler_spread,
+    vector<MathSize>* all_sizes,
+    vector<MathSize>* means,
+    vector<MathSize>* pct,
+    map<DurationSize, shared_ptr<ProbabilityMap>>* probabilities
+  );
   /**
    * \brief Start time of simulation
    */
@@ -354,6 +624,21 @@ private:
    * \brief Find all Cell(s) that can burn in entire Environment
    */
   void findAllStarts();
+  /**
+   * \brief Number of threads to run starts with in surface mode
+   * \return Number of threads to run starts with in surface mode
+   */
+  [[nodiscard]] size_t surfaceThreads() const noexcept;
+  /**
+   * \brief Run every start for surface mode, with each thread reusing one Scenario for all of
+   * the starts it runs
+   * \param iteration Iteration with a Scenario for each thread to use
+   * \param probabilities Map of times to ProbabilityMap to add results to
+   */
+  void runSurface(
+    const Iteration& iteration,
+    map<DurationSize, shared_ptr<ProbabilityMap>>* probabilities
+  );
   /**
    * Save probability rasters
    */
@@ -372,13 +657,33 @@ private:
    */
   array<int, MAX_DAYS> nd_{};
   /**
-   * \brief Map of scenario number to weather stream
+   * \brief Distinct FuelTypes to use for each fuel code on any day
+   */
+  vector<ResolvedFuels> resolved_fuels_{};
+  /**
+   * \brief Index into resolved_fuels_ for each day
+   */
+  array<size_t, MAX_DAYS> resolved_fuels_by_day_{};
+  /**
+   * \brief Map of scenario number to weather stream (identical streams are shared)
+   */
+  map<size_t, shared_ptr<FireWeather>> wx_{};
+  /**
+   * \brief Map of scenario number to weather stream (identical streams are shared)
+   */
+  map<size_t, shared_ptr<FireWeather>> wx_daily_{};
+  /**
+   * \brief Map of scenario number to SpreadCache for scenarios that share weather
+   */
+  map<size_t, shared_ptr<SpreadCache>> spread_caches_{};
+  /**
+   * \brief First hour that fire could spread in for each pair of weather streams
    */
-  map<size_t, FireWeather> wx_{};
+  map<pair<ptr<const FireWeather>, ptr<const FireWeather>>, vector<size_t>> next_spread_hours_{};
   /**
-   * \brief Map of scenario number to weather stream
+   * \brief Make sure next_spread_hours_ is only calculated once for each pair of streams
    */
-  map<size_t, FireWeather> wx_daily_{};
+  mutex mutex_next_spread_hours_{};
   /**
    * \brief Cell(s) that can burn closest to start Location
    */
@@ -417,7 +722,7 @@ private:
    * \param weather Weather to write
    * \param file_name Name of file to write to
    */
-  void outputWeather(map<size_t, FireWeather>& weather, const char* file_name);
+  void outputWeather(map<size_t, shared_ptr<FireWeather>>& weather, const char* file_name);
 #endif
   /**
    * \brief What year the weather is for
@@ -38,6 +38,11 @@ public:
    * \return None
    */
   virtual void reset() = 0;
+  /**
+   * \brief Estimate of memory used by observations (bytes)
+   * \return Estimate of memory used by observations (bytes)
+   */
+  [[nodiscard]] virtual size_t memoryUsed() const noexcept = 0;
   /**
    * \brief Make name to save file as
    * \param base_name Base file name
@@ -97,6 +102,11 @@ public:
    * \brief Clear all observations
    */
   void reset() noexcept override { map_.clear(); }
+  /**
+   * \brief Estimate of memory used by observations (bytes)
+   * \return Estimate of memory used by observations (bytes)
+   */
+  [[nodiscard]] size_t memoryUsed() const noexcept override { return map_.memoryUsed(); }
 
 protected:
   /**
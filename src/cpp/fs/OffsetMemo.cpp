@@ -0,0 +1,146 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#include "OffsetMemo.h"
+#include "Settings.h"
+#include "SpreadAlgorithm.h"
+namespace fs
+{
+/**
+ * \brief Compare every this many reused offset sets to offsets for exact inputs
+ */
+static constexpr size_t ERROR_SAMPLE_INTERVAL = 64;
+static atomic<size_t> COMPUTED = 0;
+static atomic<size_t> REUSED = 0;
+static atomic<size_t> SAMPLED = 0;
+static mutex MUTEX_ERROR{};
+static MathSize MAX_POSITION_ERROR = 0.0;
+static OffsetSet calculate_offsets_exact(
+  const OffsetInputs& inputs,
+  const ptr<OffsetSteps> steps = nullptr
+)
+{
+  const auto spread_algorithm =
+    WidestEllipseAlgorithm(MAX_SPREAD_ANGLE, inputs.cell_size, inputs.min_ros);
+  return spread_algorithm.calculate_offsets(
+    horizontal_adjustment(inputs.aspect, inputs.slope),
+    inputs.tfc,
+    Radians{inputs.head_raz},
+    inputs.head_ros,
+    inputs.back_ros,
+    inputs.length_to_breadth,
+    steps
+  );
+}
+size_t OffsetInputsHash::operator()(const OffsetInputs& inputs) const noexcept
+{
+  size_t result = 0;
+  const auto combine = [&result](const auto& value) {
+    result ^= hash<std::remove_cvref_t<decltype(value)>>{}(value) + 0x9e3779b97f4a7c15
+            + (result << 6) + (result >> 2);
+  };
+  // add 0.0 so -0.0 hashes the same as 0.0 since they compare equal
+  combine(inputs.cell_size + 0.0);
+  combine(inputs.min_ros + 0.0);
+  combine(inputs.slope);
+  combine(inputs.aspect);
+  combine(inputs.tfc + 0.0);
+  combine(inputs.head_raz + 0.0);
+  combine(inputs.head_ros + 0.0);
+  combine(inputs.back_ros + 0.0);
+  combine(inputs.length_to_breadth + 0.0);
+  return result;
+}
+OffsetMemo::OffsetMemo(const size_t capacity, const MathSize step) noexcept
+  : capacity_(capacity), step_(step)
+{ }
+OffsetInputs OffsetMemo::quantize(const OffsetInputs& inputs) const noexcept
+{
+  if (0 >= step_)
+  {
+    return inputs;
+  }
+  // relative step so small and large values keep the same precision
+  const auto log_step = log1p(step_);
+  const auto relative = [log_step](const MathSize value) {
+    return (0 >= value) ? value : exp(round(log(value) / log_step) * log_step);
+  };
+  // directions are relative to a full circle
+  const auto angle_step = step_ * Radians::PiX2().value;
+  auto result = inputs;
+  result.min_ros = relative(inputs.min_ros);
+  result.tfc = relative(inputs.tfc);
+  result.head_raz = Radians{round(inputs.head_raz / angle_step) * angle_step}.fix().value;
+  result.head_ros = relative(inputs.head_ros);
+  result.back_ros = relative(inputs.back_ros);
+  result.length_to_breadth = relative(inputs.length_to_breadth);
+  return result;
+}
+OffsetSet OffsetMemo::offsets(const OffsetInputs& inputs)
+{
+  const auto key = quantize(inputs);
+  const auto seek = index_.find(key);
+  if (index_.end() != seek)
+  {
+    ++REUSED;
+    // move to front since it was just used
+    entries_.splice(entries_.begin(), entries_, seek->second);
+    const auto& result = seek->second->second;
+    if (0 < step_ && ERROR_SAMPLE_INTERVAL <= ++since_sample_)
+    {
+      since_sample_ = 0;
+      sampleError(inputs, result);
+    }
+    return result;
+  }
+  ++COMPUTED;
+  if (capacity_ <= entries_.size())
+  {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(key, calculate_offsets_exact(key));
+  index_.emplace(key, entries_.begin());
+  return entries_.front().second;
+}
+void OffsetMemo::sampleError(const OffsetInputs& inputs, const OffsetSet& used)
+{
+  const auto exact = calculate_offsets_exact(inputs);
+  MathSize error = 0.0;
+  for (const auto& e : exact)
+  {
+    // compare to closest offset since quantized inputs might not make the same directions
+    auto closest = std::numeric_limits<MathSize>::infinity();
+    for (const auto& u : used)
+    {
+      const auto x = e.offset.x - u.offset.x;
+      const auto y = e.offset.y - u.offset.y;
+      closest = min(closest, x * x + y * y);
+    }
+    error = max(error, closest);
+  }
+  // offsets are always in used if exact is empty, but only ever happens at thresholds
+  error = used.empty() ? 0.0 : sqrt(error);
+  ++SAMPLED;
+  lock_guard<mutex> lock(MUTEX_ERROR);
+  MAX_POSITION_ERROR = max(MAX_POSITION_ERROR, error);
+}
+size_t OffsetMemo::computed() noexcept { return COMPUTED; }
+size_t OffsetMemo::reused() noexcept { return REUSED; }
+size_t OffsetMemo::sampled() noexcept { return SAMPLED; }
+MathSize OffsetMemo::maxPositionError() noexcept
+{
+  lock_guard<mutex> lock(MUTEX_ERROR);
+  return MAX_POSITION_ERROR;
+}
+OffsetSet calculate_offsets(const OffsetInputs& inputs, const ptr<OffsetSteps> steps)
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  if (0 == settings.offset_memo_size)
+  {
+    return calculate_offsets_exact(inputs, steps);
+  }
+  // one memo per thread so nothing needs to be locked
+  thread_local OffsetMemo memo{settings.offset_memo_size, settings.offset_memo_step};
+  return memo.offsets(inputs);
+}
+}
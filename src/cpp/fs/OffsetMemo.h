@@ -0,0 +1,152 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#ifndef FS_OFFSETMEMO_H
+#define FS_OFFSETMEMO_H
+#include "stdafx.h"
+#include "FireSpread.h"
+namespace fs
+{
+/**
+ * \brief Everything that offsets calculated by WidestEllipseAlgorithm depend on
+ */
+struct OffsetInputs
+{
+  /**
+   * \brief Size of cells (m)
+   */
+  MathSize cell_size;
+  /**
+   * \brief Minimum rate of spread to consider spreading (m/min)
+   */
+  MathSize min_ros;
+  /**
+   * \brief Slope (%)
+   */
+  SlopeSize slope;
+  /**
+   * \brief Aspect of slope (degrees)
+   */
+  AspectSize aspect;
+  /**
+   * \brief Total fuel consumption (kg/m^2)
+   */
+  MathSize tfc;
+  /**
+   * \brief Head fire spread direction (radians)
+   */
+  MathSize head_raz;
+  /**
+   * \brief Head fire rate of spread (m/min)
+   */
+  MathSize head_ros;
+  /**
+   * \brief Back fire rate of spread (m/min)
+   */
+  MathSize back_ros;
+  /**
+   * \brief Length to breadth ratio
+   */
+  MathSize length_to_breadth;
+  bool operator==(const OffsetInputs& rhs) const = default;
+};
+/**
+ * \brief Hash for OffsetInputs so they can be used as keys
+ */
+struct OffsetInputsHash
+{
+  [[nodiscard]] size_t operator()(const OffsetInputs& inputs) const noexcept;
+};
+/**
+ * \brief Bounded least recently used memo of offsets for OffsetInputs.
+ *
+ * Inputs get quantized to a relative step before looking them up, and offsets get calculated
+ * from the quantized inputs, so what gets used for any inputs doesn't depend on what was
+ * calculated before it. A step of 0 only reuses offsets for inputs that are exactly the same.
+ */
+class OffsetMemo
+{
+public:
+  /**
+   * \brief Constructor
+   * \param capacity Maximum number of offset sets to keep
+   * \param step Relative step to quantize inputs to (0 for exact inputs only)
+   */
+  OffsetMemo(size_t capacity, MathSize step) noexcept;
+  OffsetMemo(OffsetMemo&& rhs) noexcept = default;
+  OffsetMemo(const OffsetMemo& rhs) = delete;
+  OffsetMemo& operator=(OffsetMemo&& rhs) noexcept = default;
+  OffsetMemo& operator=(const OffsetMemo& rhs) = delete;
+  /**
+   * \brief Find offsets for inputs, calculating and remembering them if not already known
+   * \param inputs Inputs to find offsets for
+   * \return Offsets for inputs after quantizing them
+   */
+  [[nodiscard]] OffsetSet offsets(const OffsetInputs& inputs);
+  /**
+   * \brief Quantize inputs to the step this uses
+   * \param inputs Inputs to quantize
+   * \return Inputs with every continuous value rounded to step
+   */
+  [[nodiscard]] OffsetInputs quantize(const OffsetInputs& inputs) const noexcept;
+  /**
+   * \brief Number of offset sets that have been calculated by any OffsetMemo
+   * \return Number of offset sets that have been calculated by any OffsetMemo
+   */
+  [[nodiscard]] static size_t computed() noexcept;
+  /**
+   * \brief Number of offset sets that have been reused by any OffsetMemo
+   * \return Number of offset sets that have been reused by any OffsetMemo
+   */
+  [[nodiscard]] static size_t reused() noexcept;
+  /**
+   * \brief Number of reused offset sets that were compared to calculating from exact inputs
+   * \return Number of reused offset sets that were compared to calculating from exact inputs
+   */
+  [[nodiscard]] static size_t sampled() noexcept;
+  /**
+   * \brief Largest distance between an offset from exact inputs and closest reused offset
+   * \return Largest distance between offsets (cells per minute of spread)
+   */
+  [[nodiscard]] static MathSize maxPositionError() noexcept;
+
+private:
+  using Entry = pair<OffsetInputs, OffsetSet>;
+  /**
+   * \brief Remember largest position error between reused offsets and exact offsets
+   * \param inputs Exact inputs
+   * \param used Offsets that were reused for inputs
+   */
+  static void sampleError(const OffsetInputs& inputs, const OffsetSet& used);
+  /**
+   * \brief Entries in order of last use, with most recent first
+   */
+  list<Entry> entries_{};
+  /**
+   * \brief Entry for each set of quantized inputs
+   */
+  unordered_map<OffsetInputs, list<Entry>::iterator, OffsetInputsHash> index_{};
+  /**
+   * \brief Maximum number of offset sets to keep
+   */
+  size_t capacity_;
+  /**
+   * \brief Relative step to quantize inputs to (0 for exact inputs only)
+   */
+  MathSize step_;
+  /**
+   * \brief Number of times offsets have been reused since last sampling error
+   */
+  size_t since_sample_{0};
+};
+/**
+ * \brief Calculate offsets with WidestEllipseAlgorithm, using a memo for the current thread if
+ * OFFSET_MEMO_SIZE is set
+ * \param inputs Inputs to calculate offsets for
+ * \param steps Steps offsets were added in, which are only added to if the memo isn't used
+ * \return Offsets that represent spread under these conditions
+ */
+[[nodiscard]] OffsetSet calculate_offsets(
+  const OffsetInputs& inputs,
+  ptr<OffsetSteps> steps = nullptr
+);
+}
+#endif
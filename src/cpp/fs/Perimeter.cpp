@@ -66,6 +66,9 @@ BurnedMap::BurnedMap(const Grid<unsigned char, unsigned char>& perim_grid, const
 Perimeter::Perimeter(const BurnedMap& burned_map)
   : burned(burned_map.makeList()), edge(burned_map.makeEdge())
 { }
+Perimeter::Perimeter(list<XYIdx>&& burned, list<XYIdx>&& edge)
+  : burned(std::move(burned)), edge(std::move(edge))
+{ }
 BurnedMap make_burned_map(const LazyPath& perim, const Point& point, const Environment& env)
 {
   auto perim_grid = ConstantGrid<unsigned char>::readTiff(perim.canonical(), point);
@@ -42,6 +42,12 @@ public:
    */
   Perimeter(const LazyPath& perim, const Point& point, const Environment& env);
   Perimeter(const XYIdx& location, const size_t size, const Environment& env);
+  /**
+   * \brief Perimeter that was already applied to an Environment somewhere else
+   * \param burned List of all burned Locations
+   * \param edge List of all Locations along the edge of this Perimeter
+   */
+  Perimeter(list<XYIdx>&& burned, list<XYIdx>&& edge);
   /**
    * \brief List of all burned Locations
    */
@@ -1,5 +1,6 @@
 /* SPDX-License-Identifier: AGPL-3.0-or-later */
 #include "ProbabilityMap.h"
+#include "Checkpoint.h"
 #include "GridMap.h"
 #include "IntensityMap.h"
 #include "TimeUtil.h"
@@ -26,14 +27,13 @@ ProbabilityMap::ProbabilityMap(
   const shared_ptr<Perimeter> perimeter
 )
   : all_(GridMap<size_t>(grid_info, 0)), high_(GridMap<size_t>(grid_info, 0)),
-    med_(GridMap<size_t>(grid_info, 0)), low_(GridMap<size_t>(grid_info, 0)), time(time),
+    med_(GridMap<size_t>(grid_info, 0)), low_(GridMap<size_t>(grid_info, 0)),
+    totals_(all_.width(), all_.height()), time(time),
     start_time(start_time), min_value_(min_value), max_value_(max_value), low_max_(low_max),
     med_max_(med_max), perimeter_(perimeter)
 { }
-void ProbabilityMap::addProbabilities(const ProbabilityMap& rhs)
+void ProbabilityMap::addProbabilities(ProbabilityMap& rhs)
 {
-  // HACK: resolve once and fail if not set already
-  static const auto& settings = fs::settings::instance();
 #ifndef DEBUG_PROBABILITY
   logging::check_fatal(rhs.time != time, "Wrong time");
   logging::check_fatal(rhs.start_time != start_time, "Wrong start time");
@@ -45,52 +45,32 @@ void ProbabilityMap::addProbabilities(const ProbabilityMap& rhs)
   lock_guard<mutex> lock(mutex_);
   // need to lock both maps
   lock_guard<mutex> lock_rhs(rhs.mutex_);
-  if (settings.save_intensity)
-  {
-    for (auto&& kv : rhs.low_.data)
-    {
-      low_.data[kv.first] += kv.second;
-    }
-    for (auto&& kv : rhs.med_.data)
-    {
-      med_.data[kv.first] += kv.second;
-    }
-    for (auto&& kv : rhs.high_.data)
-    {
-      high_.data[kv.first] += kv.second;
-    }
-  }
-  for (auto&& kv : rhs.all_.data)
-  {
-    all_.data[kv.first] += kv.second;
-  }
-  for (auto size : rhs.sizes_)
-  {
-    static_cast<void>(insert_sorted(&sizes_, size));
-  }
+  // take everything from rhs directly instead of reducing it first
+  reduceFrom(rhs.idle_shards_, &rhs.totals_);
 }
 void ProbabilityMap::addProbability(const IntensityMap& for_time)
 {
   // HACK: resolve once and fail if not set already
   static const auto& settings = fs::settings::instance();
-  lock_guard<mutex> lock(mutex_);
-  std::for_each(for_time.cbegin(), for_time.cend(), [this](auto&& kv) {
+  // only need to lock to get and return shard, since nothing else uses it in between
+  const auto shard = checkoutShard();
+  std::for_each(for_time.cbegin(), for_time.cend(), [this, shard](auto&& kv) {
     const auto k = kv.first;
     const auto v = kv.second;
-    all_.data[k] += 1;
+    shard->all.mark(k);
     if (settings.save_intensity)
     {
       if (v >= min_value_ && v <= low_max_)
       {
-        low_.data[k] += 1;
+        shard->low.mark(k);
       }
       else if (v > low_max_ && v <= med_max_)
       {
-        med_.data[k] += 1;
+        shard->med.mark(k);
       }
       else if (v > med_max_ && v <= max_value_)
       {
-        high_.data[k] += 1;
+        shard->high.mark(k);
       }
       else
       {
@@ -98,15 +78,181 @@ void ProbabilityMap::addProbability(const IntensityMap& for_time)
       }
     }
   });
-  const auto size = for_time.fireSize();
-  static_cast<void>(insert_sorted(&sizes_, size));
+  // add whole mask at once instead of each cell
+  shard->all.addMarked();
+  if (settings.save_intensity)
+  {
+    shard->low.addMarked();
+    shard->med.addMarked();
+    shard->high.addMarked();
+  }
+  shard->sizes.push_back(for_time.fireSize());
+  returnShard(shard);
+}
+ptr<ProbabilityMap::Shard> ProbabilityMap::checkoutShard()
+{
+  lock_guard<mutex> lock(mutex_);
+  if (idle_shards_.empty())
+  {
+    shards_.push_back(make_unique<Shard>(all_.width(), all_.height()));
+    return shards_.back().get();
+  }
+  const auto shard = idle_shards_.back();
+  idle_shards_.pop_back();
+  return shard;
+}
+void ProbabilityMap::returnShard(ptr<Shard> shard)
+{
+  lock_guard<mutex> lock(mutex_);
+  idle_shards_.push_back(shard);
+}
+void ProbabilityMap::reduceFrom(const vector<ptr<Shard>>& from, ptr<Totals> from_totals)
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  const auto track_error = 0 < settings.maximum_probability_error;
+  const auto track_count = [this](const auto previous, const auto added) {
+    trackCount(previous, added);
+  };
+  const auto move_tile = [&](const size_t t) {
+    for (const auto shard : from)
+    {
+      if (track_error)
+      {
+        shard->all.moveTile(&totals_.all, t, track_count);
+      }
+      else
+      {
+        shard->all.moveTile(&totals_.all, t);
+      }
+      shard->low.moveTile(&totals_.low, t);
+      shard->med.moveTile(&totals_.med, t);
+      shard->high.moveTile(&totals_.high, t);
+    }
+    if (nullptr != from_totals)
+    {
+      if (track_error)
+      {
+        totals_.all.moveTile(&from_totals->all, t, track_count);
+      }
+      else
+      {
+        totals_.all.moveTile(&from_totals->all, t);
+      }
+      totals_.low.moveTile(&from_totals->low, t);
+      totals_.med.moveTile(&from_totals->med, t);
+      totals_.high.moveTile(&from_totals->high, t);
+    }
+  };
+  // tiles are independent so each one can be reduced separately
+  vector<size_t> tiles(totals_.all.numTiles());
+  std::iota(tiles.begin(), tiles.end(), 0);
+  if (track_error)
+  {
+    // counts for standard error are shared between tiles
+    std::for_each(tiles.cbegin(), tiles.cend(), move_tile);
+  }
+  else
+  {
+    std::for_each(
+#if !defined(__APPLE__) || !defined(__clang__)
+      // apple clang doesn't support this?
+      std::execution::par,
+#endif
+      tiles.cbegin(),
+      tiles.cend(),
+      move_tile
+    );
+  }
+  const auto move_sizes = [this](vector<MathSize>* sizes) {
+    for (const auto size : *sizes)
+    {
+      static_cast<void>(insert_sorted(&totals_.sizes, size));
+    }
+    sizes->clear();
+  };
+  for (const auto shard : from)
+  {
+    move_sizes(&shard->sizes);
+  }
+  if (nullptr != from_totals)
+  {
+    move_sizes(&from_totals->sizes);
+  }
 }
-vector<MathSize> ProbabilityMap::getSizes() const { return sizes_; }
+void ProbabilityMap::reduce() { reduceFrom(idle_shards_); }
+void ProbabilityMap::expand()
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  const auto fill = [](const TileCounts& counts, GridMap<size_t>* grid) {
+    grid->clear();
+    counts.forEach([grid](const XYIdx& location, const TileCounts::CountSize count) {
+      grid->data.emplace(location, count);
+    });
+  };
+  fill(totals_.all, &all_);
+  if (settings.save_intensity)
+  {
+    fill(totals_.low, &low_);
+    fill(totals_.med, &med_);
+    fill(totals_.high, &high_);
+  }
+}
+vector<MathSize> ProbabilityMap::getSizes() const { return totals_.sizes; }
 Statistics ProbabilityMap::getStatistics() const { return Statistics{getSizes()}; }
-size_t ProbabilityMap::numSizes() const noexcept { return sizes_.size(); }
-void ProbabilityMap::show() const
+size_t ProbabilityMap::numSizes() const noexcept { return totals_.sizes.size(); }
+void ProbabilityMap::trackCount(const size_t previous, const size_t added)
+{
+  const auto current = previous + added;
+  if (cells_by_count_.size() <= current)
+  {
+    cells_by_count_.resize(current + 1, 0);
+  }
+  if (0 == previous)
+  {
+    ++cells_burned_;
+  }
+  else
+  {
+    --cells_by_count_[previous];
+  }
+  ++cells_by_count_[current];
+  sum_count_ += added;
+  sum_count_squared_ += current * current - previous * previous;
+}
+MathSize ProbabilityMap::standardError(const bool use_mean)
+{
+  lock_guard<mutex> lock(mutex_);
+  reduce();
+  const auto n = static_cast<MathSize>(numSizes());
+  if (0 == numSizes() || 0 == cells_burned_)
+  {
+    return 0.0;
+  }
+  if (use_mean)
+  {
+    // sum of p * (1 - p) over cells is sum(k) / n - sum(k^2) / n^2
+    const auto sum_variance = static_cast<MathSize>(sum_count_) / n
+                            - static_cast<MathSize>(sum_count_squared_) / (n * n);
+    return sqrt(max(0.0, sum_variance) / (n * static_cast<MathSize>(cells_burned_)));
+  }
+  // error is largest for whichever count is closest to half the simulations
+  MathSize max_variance = 0.0;
+  for (size_t k = 1; k < cells_by_count_.size(); ++k)
+  {
+    if (0 < cells_by_count_[k])
+    {
+      const auto p = static_cast<MathSize>(k) / n;
+      max_variance = max(max_variance, p * (1.0 - p));
+    }
+  }
+  return sqrt(max_variance / n);
+}
+void ProbabilityMap::show()
 {
   lock_guard<mutex> lock(mutex_);
+  reduce();
   // even if we only ran the actuals we'll still have multiple scenarios
   // with different randomThreshold values
   const auto day = static_cast<int>(time - floor(start_time));
@@ -197,11 +343,13 @@ void ProbabilityMap::deleteInterim()
   const tm& start_time,
   const DurationSize time,
   const ProcessingStatus processing_status
-) const
+)
 {
   // HACK: resolve once and fail if not set already
   static const auto& settings = fs::settings::instance();
   lock_guard<mutex> lock(mutex_);
+  reduce();
+  expand();
   FileList files{};
   const auto is_interim = processed != processing_status;
   auto t = start_time;
@@ -364,6 +512,92 @@ FileList ProbabilityMap::saveLow(
     low_, output_directory, base_name, static_cast<float>(numSizes()), processing_status
   );
 }
+void ProbabilityMap::saveDefinition(ostream& out) const
+{
+  checkpoint::write_value(out, time);
+  checkpoint::write_value(out, start_time);
+  checkpoint::write_value(out, min_value_);
+  checkpoint::write_value(out, low_max_);
+  checkpoint::write_value(out, med_max_);
+  checkpoint::write_value(out, max_value_);
+  checkpoint::write_value(out, all_.cellSize());
+  checkpoint::write_value(out, all_.xllcorner());
+  checkpoint::write_value(out, all_.yllcorner());
+  checkpoint::write_value(out, all_.xurcorner());
+  checkpoint::write_value(out, all_.yurcorner());
+  const auto& proj4 = all_.proj4();
+  checkpoint::write_values(out, vector<char>{proj4.begin(), proj4.end()});
+}
+shared_ptr<ProbabilityMap> ProbabilityMap::loadDefinition(
+  std::istream& in,
+  const shared_ptr<Perimeter> perimeter
+)
+{
+  const auto time = checkpoint::read_value<DurationSize>(in);
+  const auto start_time = checkpoint::read_value<DurationSize>(in);
+  const auto min_value = checkpoint::read_value<IntensitySize>(in);
+  const auto low_max = checkpoint::read_value<IntensitySize>(in);
+  const auto med_max = checkpoint::read_value<IntensitySize>(in);
+  const auto max_value = checkpoint::read_value<IntensitySize>(in);
+  const auto cell_size = checkpoint::read_value<MathSize>(in);
+  const auto xllcorner = checkpoint::read_value<MathSize>(in);
+  const auto yllcorner = checkpoint::read_value<MathSize>(in);
+  const auto xurcorner = checkpoint::read_value<MathSize>(in);
+  const auto yurcorner = checkpoint::read_value<MathSize>(in);
+  const auto proj4 = checkpoint::read_values<char>(in);
+  return make_shared<ProbabilityMap>(
+    time,
+    start_time,
+    static_cast<int>(min_value),
+    static_cast<int>(low_max),
+    static_cast<int>(med_max),
+    static_cast<int>(max_value),
+    GridBase{
+      cell_size, xllcorner, yllcorner, xurcorner, yurcorner, string{proj4.begin(), proj4.end()}
+    },
+    perimeter
+  );
+}
+void ProbabilityMap::saveState(ostream& out)
+{
+  lock_guard<mutex> lock(mutex_);
+  reduce();
+  checkpoint::write_value(out, time);
+  checkpoint::write_values(out, totals_.sizes);
+  totals_.all.save(out);
+  totals_.low.save(out);
+  totals_.med.save(out);
+  totals_.high.save(out);
+}
+void ProbabilityMap::loadState(std::istream& in)
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  lock_guard<mutex> lock(mutex_);
+  const auto for_time = checkpoint::read_value<DurationSize>(in);
+  logging::check_fatal(
+    for_time != time, "Checkpoint has probabilities for time {:f} instead of {:f}", for_time, time
+  );
+  for (const auto size : checkpoint::read_values<MathSize>(in))
+  {
+    static_cast<void>(insert_sorted(&totals_.sizes, size));
+  }
+  const auto ignore = [](const auto, const auto) {};
+  // track counts the same way reducing would so standard error matches an uninterrupted run
+  if (0 < settings.maximum_probability_error)
+  {
+    totals_.all.load(in, [this](const auto previous, const auto added) {
+      trackCount(previous, added);
+    });
+  }
+  else
+  {
+    totals_.all.load(in, ignore);
+  }
+  totals_.low.load(in, ignore);
+  totals_.med.load(in, ignore);
+  totals_.high.load(in, ignore);
+}
 void ProbabilityMap::reset()
 {
   lock_guard<mutex> lock(mutex_);
@@ -371,6 +605,22 @@ void ProbabilityMap::reset()
   low_.clear();
   med_.clear();
   high_.clear();
-  sizes_.clear();
+  totals_.all.clear();
+  totals_.low.clear();
+  totals_.med.clear();
+  totals_.high.clear();
+  totals_.sizes.clear();
+  for (auto& shard : shards_)
+  {
+    shard->all.clear();
+    shard->low.clear();
+    shard->med.clear();
+    shard->high.clear();
+    shard->sizes.clear();
+  }
+  cells_by_count_.clear();
+  sum_count_squared_ = 0;
+  sum_count_ = 0;
+  cells_burned_ = 0;
 }
 }
@@ -6,6 +6,7 @@
 #include "Perimeter.h"
 #include "Settings.h"
 #include "Statistics.h"
+#include "TileCounts.h"
 #include "Util.h"
 namespace fs
 {
@@ -24,6 +25,10 @@ class Model;
 class IntensityMap;
 /**
  * \brief Map of the percentage of simulations in which a Cell burned in each intensity category.
+ *
+ * Each call to addProbability() counts into a shard that only that caller is using, and shards
+ * only get reduced into the totals when they're needed for output or statistics. Shards keep
+ * their counts as bit planes so each IntensityMap gets added a whole row of a tile at a time.
  */
 class ProbabilityMap
 {
@@ -55,10 +60,10 @@ public:
     const shared_ptr<Perimeter> perimeter
   );
   /**
-   * \brief Combine results from another ProbabilityMap into this one
-   * \param rhs ProbabilityMap to combine from
+   * \brief Move results from another ProbabilityMap into this one
+   * \param rhs ProbabilityMap to take results from
    */
-  void addProbabilities(const ProbabilityMap& rhs);
+  void addProbabilities(ProbabilityMap& rhs);
   /**
    * \brief Add in an IntensityMap to the appropriate probability grid based on each cell burn
    * intensity
@@ -68,7 +73,7 @@ public:
   /**
    * \brief Output Statistics to log
    */
-  void show() const;
+  void show();
   /**
    * \brief Save total, low, moderate, and high maps, and output information to log
    * \param start_time Start time of simulation
@@ -80,7 +85,43 @@ public:
     const tm& start_time,
     DurationSize time,
     const ProcessingStatus processing_status
-  ) const;
+  );
+  /**
+   * \brief Binomial standard error of burn probability over cells that have burned
+   * \param use_mean Use root mean square over cells instead of maximum
+   * \return Standard error of burn probability (0 if nothing added yet)
+   */
+  [[nodiscard]] MathSize standardError(bool use_mean);
+  /**
+   * \brief Number of sizes that have been reduced into totals
+   * \return Number of sizes that have been reduced into totals
+   */
+  [[nodiscard]] size_t numSizes() const noexcept;
+  /**
+   * \brief Write time, intensity ranges, and extent so an empty copy can be made elsewhere
+   * \param out Stream to write to
+   */
+  void saveDefinition(ostream& out) const;
+  /**
+   * \brief Make an empty ProbabilityMap from what was written by saveDefinition()
+   * \param in Stream to read from
+   * \param perimeter Initial ignition grid to apply to outputs
+   * \return Empty ProbabilityMap with same time, intensity ranges, and extent
+   */
+  [[nodiscard]] static shared_ptr<ProbabilityMap> loadDefinition(
+    std::istream& in,
+    const shared_ptr<Perimeter> perimeter
+  );
+  /**
+   * \brief Write counts and sizes that have been added so far to a checkpoint
+   * \param out Stream to write to
+   */
+  void saveState(ostream& out);
+  /**
+   * \brief Add counts and sizes that were written by saveState()
+   * \param in Stream to read from
+   */
+  void loadState(std::istream& in);
   /**
    * \brief Clear maps and return to initial state
    */
@@ -91,6 +132,57 @@ public:
   static void deleteInterim();
 
 private:
+  /**
+   * \brief Counts for each intensity category and sizes of IntensityMaps added to them
+   * \tparam T Type used to store counts
+   */
+  template <class T>
+  struct Counts
+  {
+    Counts(const Idx width, const Idx height)
+      : all(width, height), low(width, height), med(width, height), high(width, height)
+    { }
+    T all;
+    T low;
+    T med;
+    T high;
+    /**
+     * \brief Sizes of IntensityMaps added to this
+     */
+    vector<MathSize> sizes{};
+  };
+  /**
+   * \brief Counts from a single worker that get reduced into totals when needed
+   */
+  using Shard = Counts<TileBitCounts>;
+  /**
+   * \brief Counts that have been reduced from Shards
+   */
+  using Totals = Counts<TileCounts>;
+  /**
+   * \brief Get a Shard that nothing else is using
+   * \return Shard to add counts to
+   */
+  [[nodiscard]] ptr<Shard> checkoutShard();
+  /**
+   * \brief Return a Shard so it can be reduced or reused
+   * \param shard Shard to return
+   */
+  void returnShard(ptr<Shard> shard);
+  /**
+   * \brief Move counts from Shards into totals (must hold mutex_)
+   * \param from Shards to move counts from
+   * \param from_totals Totals to move counts from as well (if not nullptr)
+   */
+  void reduceFrom(const vector<ptr<Shard>>& from, ptr<Totals> from_totals = nullptr);
+  /**
+   * \brief Move counts from Shards that aren't in use into totals (must hold mutex_)
+   */
+  void reduce();
+  /**
+   * \brief Expand totals into maps used for output (must hold mutex_)
+   */
+  void expand();
   /**
    * \brief List of sizes of IntensityMaps that have been added
    * \return List of sizes of IntensityMaps that have been added
@@ -102,10 +194,11 @@ private:
    */
   [[nodiscard]] Statistics getStatistics() const;
   /**
-   * \brief Number of sizes that have been added
-   * \return Number of sizes that have been added
+   * \brief Track change in burn count for a cell so standard error doesn't need a full pass
+   * \param previous Count for cell before change
+   * \param added Amount count for cell is increasing by
    */
-  [[nodiscard]] size_t numSizes() const noexcept;
+  void trackCount(size_t previous, size_t added);
   /**
    * \brief Save list of sizes
    * \param output_directory Directory to save to
@@ -199,25 +292,49 @@ private:
     );
   }
   /**
-   * \brief Map representing all intensities
+   * \brief Map representing all intensities (only filled when saving)
    */
   GridMap<size_t> all_;
   /**
-   * \brief Map representing high intensities
+   * \brief Map representing high intensities (only filled when saving)
    */
   GridMap<size_t> high_;
   /**
-   * \brief Map representing moderate intensities
+   * \brief Map representing moderate intensities (only filled when saving)
    */
   GridMap<size_t> med_;
   /**
-   * \brief Map representing low intensities
+   * \brief Map representing low intensities (only filled when saving)
    */
   GridMap<size_t> low_;
   /**
-   * \brief List of sizes for perimeters that have been added
+   * \brief Counts (and sorted sizes) that have been reduced from Shards
+   */
+  Totals totals_;
+  /**
+   * \brief All Shards that have been created
+   */
+  vector<uptr<Shard>> shards_{};
+  /**
+   * \brief Shards that aren't currently being added to
+   */
+  vector<ptr<Shard>> idle_shards_{};
+  /**
+   * \brief Number of cells with each burn count in all_ (only if tracking error)
+   */
+  vector<size_t> cells_by_count_{};
+  /**
+   * \brief Sum of squares of burn counts in all_ (only if tracking error)
+   */
+  size_t sum_count_squared_{0};
+  /**
+   * \brief Sum of burn counts in all_ (only if tracking error)
+   */
+  size_t sum_count_{0};
+  /**
+   * \brief Number of cells with any burn count in all_ (only if tracking error)
    */
-  vector<MathSize> sizes_{};
+  size_t cells_burned_{0};
 
 public:
   /**
@@ -13,6 +13,8 @@
 #include "Perimeter.h"
 #include "ProbabilityMap.h"
 #include "Settings.h"
+#include "SpreadCache.h"
+#include "TravelTime.h"
 namespace fs
 {
 using std::cout;
@@ -20,6 +22,10 @@ using std::cout;
 static atomic<size_t> COUNT = 0;
 static atomic<size_t> COMPLETED = 0;
 static atomic<size_t> TOTAL_STEPS = 0;
+static atomic<size_t> SPREAD_STEPS = 0;
+static atomic<size_t> CELLS_SPREAD = 0;
+static atomic<size_t> ARENA_ALLOCATIONS = 0;
+static atomic<size_t> ARENA_BLOCKS = 0;
 static std::mutex MUTEX_SIM_COUNTS;
 static map<size_t, size_t> SIM_COUNTS{};
 template <typename T, typename F>
@@ -57,13 +63,19 @@ void Scenario::clear() noexcept
 {
   // HACK: resolve once and fail if not set already
   static const auto& settings = fs::settings::instance();
-  unburnable_.clear();
-  scheduler_ = set<Event>();
-  arrival_ = {};
-  points_ = {};
+  scheduler_.clear();
+  arrival_.clear();
+  points_.cells_.clear();
+  arrivals_.clear();
+  travel_time_.reset();
   if (!settings.is_surface())
   {
-    spread_info_ = {};
+    spread_info_.clear();
+  }
+  // everything using the arena is empty now so it can all be reused at once
+  if (nullptr != arena_)
+  {
+    arena_->release();
   }
   extinction_thresholds_.clear();
   spread_thresholds_by_ros_.clear();
@@ -79,6 +91,10 @@ void Scenario::clear() noexcept
 size_t Scenario::completed() noexcept { return COMPLETED; }
 size_t Scenario::count() noexcept { return COUNT; }
 size_t Scenario::total_steps() noexcept { return TOTAL_STEPS; }
+size_t Scenario::spread_steps() noexcept { return SPREAD_STEPS; }
+size_t Scenario::cells_spread() noexcept { return CELLS_SPREAD; }
+size_t Scenario::arena_allocations() noexcept { return ARENA_ALLOCATIONS; }
+size_t Scenario::arena_blocks() noexcept { return ARENA_BLOCKS; }
 Scenario::~Scenario() { clear(); }
 /*!
  * \page probability Probability of events
@@ -99,7 +115,8 @@ Scenario::~Scenario() { clear(); }
  */
 static void make_threshold(
   vector<ThresholdSize>* thresholds,
-  mt19937_64* mt,
+  ThresholdSampler* sampler,
+  const size_t scenario,
   const Day start_day,
   const Day last_date,
   ThresholdSize (*convert)(double value)
@@ -109,16 +126,15 @@ static void make_threshold(
   static const auto& settings = fs::settings::instance();
   const auto total_weight = settings.threshold_scenario_weight + settings.threshold_daily_weight
                           + settings.threshold_hourly_weight;
-  uniform_real_distribution<ThresholdSize> rand(0.0, 1.0);
-  const auto general = rand(*mt);
+  const auto general = sampler->general(scenario);
   for (size_t i = start_day; i < MAX_DAYS; ++i)
   {
-    const auto daily = rand(*mt);
+    const auto daily = sampler->daily(scenario, static_cast<Day>(i));
     for (auto h = 0; h < DAY_HOURS; ++h)
     {
       // generate no matter what so if we extend the time period the results
       // for the first days don't change
-      const auto hourly = rand(*mt);
+      const auto hourly = sampler->hourly();
       // only save if we're going to use it
       // HACK: +1 so if it's exactly at the end time there's something there
       if (i <= static_cast<size_t>(last_date + 1))
@@ -147,21 +163,38 @@ constexpr V same(const V value) noexcept
 }
 static void make_threshold(
   vector<ThresholdSize>* thresholds,
-  mt19937_64* mt,
+  ThresholdSampler* sampler,
+  const size_t scenario,
   const Day start_day,
   const Day last_date
 )
 {
-  make_threshold(thresholds, mt, start_day, last_date, &same);
+  make_threshold(thresholds, sampler, scenario, start_day, last_date, &same);
+}
+/**
+ * \brief Draw the same random numbers as make_threshold() without keeping them
+ * \param sampler Source of random numbers
+ * \param scenario Index of Scenario within its Iteration
+ * \param start_day First day to draw for
+ */
+static void skip_threshold(ThresholdSampler* sampler, const size_t scenario, const Day start_day)
+{
+  static_cast<void>(sampler->general(scenario));
+  for (size_t i = start_day; i < MAX_DAYS; ++i)
+  {
+    static_cast<void>(sampler->daily(scenario, static_cast<Day>(i)));
+    for (auto h = 0; h < DAY_HOURS; ++h)
+    {
+      static_cast<void>(sampler->hourly());
+    }
+  }
 }
 // HACK: just set next start point here for surface right now
 Scenario* Scenario::reset_with_new_start(const XYIdx& start_xy, ptr<SafeVector> final_sizes)
 {
-  unburnable_.clear();
   start_xy_ = start_xy;
   cancelled_ = false;
   current_time_ = start_time_;
-  intensity_ = nullptr;
   probabilities_ = nullptr;
   final_sizes_ = final_sizes;
   ran_ = false;
@@ -171,8 +204,7 @@ Scenario* Scenario::reset_with_new_start(const XYIdx& start_xy, ptr<SafeVector>
     o->reset();
   }
   current_time_ = start_time_ - 1;
-  points_ = {};
-  intensity_ = make_unique<IntensityMap>(model());
+  resetIntensity();
   // HACK: never reset these if using a surface
   {
     current_time_index_ = numeric_limits<size_t>::max();
@@ -186,15 +218,14 @@ Scenario* Scenario::reset_with_new_start(const XYIdx& start_xy, ptr<SafeVector>
   return this;
 }
 Scenario* Scenario::reset(
-  mt19937_64* mt_extinction,
-  mt19937_64* mt_spread,
+  ThresholdSampler* sampler_extinction,
+  ThresholdSampler* sampler_spread,
+  const size_t index,
   ptr<SafeVector> final_sizes
 )
 {
-  unburnable_.clear();
   cancelled_ = false;
   current_time_ = start_time_;
-  intensity_ = nullptr;
   probabilities_ = nullptr;
   final_sizes_ = final_sizes;
   ran_ = false;
@@ -205,15 +236,16 @@ Scenario* Scenario::reset(
   extinction_thresholds_.resize(num);
   spread_thresholds_by_ros_.resize(num);
   // if these are null then all probability thresholds remain 0
-  if (nullptr != mt_extinction)
+  if (nullptr != sampler_extinction)
   {
-    make_threshold(&extinction_thresholds_, mt_extinction, start_day_, last_date_);
+    make_threshold(&extinction_thresholds_, sampler_extinction, index, start_day_, last_date_);
   }
-  if (nullptr != mt_spread)
+  if (nullptr != sampler_spread)
   {
     make_threshold(
       &spread_thresholds_by_ros_,
-      mt_spread,
+      sampler_spread,
+      index,
       start_day_,
       last_date_,
       &SpreadInfo::calculateRosFromThreshold
@@ -224,10 +256,8 @@ Scenario* Scenario::reset(
     o->reset();
   }
   current_time_ = start_time_ - 1;
-  points_ = {};
-  intensity_ = make_unique<IntensityMap>(model());
-  spread_info_ = {};
-  arrival_ = {};
+  resetIntensity();
+  spread_info_.clear();
   max_ros_ = 0;
   current_time_index_ = numeric_limits<size_t>::max();
   ++COUNT;
@@ -238,6 +268,34 @@ Scenario* Scenario::reset(
   }
   return this;
 }
+void Scenario::skip(
+  ThresholdSampler* sampler_extinction,
+  ThresholdSampler* sampler_spread,
+  const size_t index
+)
+{
+  for (auto sampler : {sampler_extinction, sampler_spread})
+  {
+    if (nullptr != sampler)
+    {
+      skip_threshold(sampler, index, start_day_);
+    }
+  }
+  std::lock_guard<std::mutex> lk(MUTEX_SIM_COUNTS);
+  ++SIM_COUNTS[id_];
+}
+void Scenario::resetIntensity()
+{
+  // reuse existing map so its grids don't need to be allocated again
+  if (nullptr == intensity_)
+  {
+    intensity_ = make_unique<IntensityMap>(model());
+  }
+  else
+  {
+    intensity_->reset();
+  }
+}
 inline string get_log_prefix(const Scenario& scenario) noexcept
 {
   return std::format(
@@ -346,12 +404,17 @@ Scenario::Scenario(
   const Day start_day,
   const Day last_date
 )
-  : current_time_(start_time), unburnable_{}, intensity_(nullptr), perimeter_(perimeter),
-    max_ros_(0), start_xy_(start_cell), weather_(weather), weather_daily_(weather_daily),
-    model_(model), probabilities_(nullptr), final_sizes_(nullptr),
-    start_point_(std::move(start_point)), id_(id), start_time_(start_time),
-    last_save_(weather_->minDate()), simulation_(-1), start_day_(start_day), last_date_(last_date),
-    ran_(false), step_(0),
+  : current_time_(start_time), arena_(make_unique<Arena>()), points_(arena_.get()),
+    unburnable_{}, scheduler_(arena_.get()), intensity_(nullptr), perimeter_(perimeter),
+    // surface keeps spread_info_ between runs so it can't use the arena
+    spread_info_(
+      settings::instance().is_surface() ? std::pmr::get_default_resource() : arena_.get()
+    ),
+    spread_cache_(model->spreadCache(id)), arrival_(arena_.get()), max_ros_(0),
+    start_xy_(start_cell), weather_(weather), weather_daily_(weather_daily), model_(model),
+    probabilities_(nullptr), final_sizes_(nullptr), start_point_(std::move(start_point)), id_(id),
+    start_time_(start_time), last_save_(weather_->minDate()), simulation_(-1),
+    start_day_(start_day), last_date_(last_date), ran_(false), step_(0),
     points_log_(
       LogPoints{model_->outputDirectory(), settings::instance().save_points, id_, start_time_}
     )
@@ -367,6 +430,7 @@ Scenario::Scenario(
     "No weather for last save time {:s}",
     make_timestamp(model->year(), last_save)
   );
+  next_spread_hour_ = model->nextSpreadHours(weather_, weather_daily_);
 }
 void Scenario::saveStats(const DurationSize time) const
 {
@@ -414,12 +478,16 @@ Scenario::Scenario(Scenario&& rhs) noexcept
   : observers_(std::move(rhs.observers_)), save_points_(std::move(rhs.save_points_)),
     extinction_thresholds_(std::move(rhs.extinction_thresholds_)),
     spread_thresholds_by_ros_(std::move(rhs.spread_thresholds_by_ros_)),
-    current_time_(rhs.current_time_), points_(std::move(rhs.points_)),
+    current_time_(rhs.current_time_), arena_(std::move(rhs.arena_)),
+    points_(std::move(rhs.points_)),
     unburnable_(std::move(rhs.unburnable_)), scheduler_(std::move(rhs.scheduler_)),
     intensity_(std::move(rhs.intensity_)), perimeter_(std::move(rhs.perimeter_)),
-    spread_info_(std::move(rhs.spread_info_)), arrival_(std::move(rhs.arrival_)),
+    spread_info_(std::move(rhs.spread_info_)), spread_cache_(rhs.spread_cache_),
+    arrival_(std::move(rhs.arrival_)),
     max_ros_(rhs.max_ros_), start_xy_(std::move(rhs.start_xy_)), weather_(rhs.weather_),
-    weather_daily_(rhs.weather_daily_), model_(rhs.model_), probabilities_(rhs.probabilities_),
+    weather_daily_(rhs.weather_daily_), next_spread_hour_(rhs.next_spread_hour_),
+    arrivals_(std::move(rhs.arrivals_)), travel_time_(std::move(rhs.travel_time_)),
+    model_(rhs.model_), probabilities_(rhs.probabilities_),
     final_sizes_(rhs.final_sizes_), start_point_(std::move(rhs.start_point_)), id_(rhs.id_),
     start_time_(rhs.start_time_), last_save_(rhs.last_save_), simulation_(rhs.simulation_),
     start_day_(rhs.start_day_), last_date_(rhs.last_date_), ran_(rhs.ran_)
@@ -432,14 +500,19 @@ Scenario& Scenario::operator=(Scenario&& rhs) noexcept
     save_points_ = std::move(rhs.save_points_);
     extinction_thresholds_ = std::move(rhs.extinction_thresholds_);
     spread_thresholds_by_ros_ = std::move(rhs.spread_thresholds_by_ros_);
+    // keep arena_ since containers here still allocate from it
     points_ = std::move(rhs.points_);
     current_time_ = rhs.current_time_;
     scheduler_ = std::move(rhs.scheduler_);
     intensity_ = std::move(rhs.intensity_);
     perimeter_ = std::move(rhs.perimeter_);
     start_xy_ = std::move(rhs.start_xy_);
+    spread_cache_ = rhs.spread_cache_;
     weather_ = rhs.weather_;
     weather_daily_ = rhs.weather_daily_;
+    next_spread_hour_ = rhs.next_spread_hour_;
+    arrivals_ = std::move(rhs.arrivals_);
+    travel_time_ = std::move(rhs.travel_time_);
     model_ = rhs.model_;
     probabilities_ = rhs.probabilities_;
     final_sizes_ = rhs.final_sizes_;
@@ -516,8 +589,11 @@ Scenario* Scenario::run(map<DurationSize, shared_ptr<ProbabilityMap>>* probabili
     return true;
   }();
   std::ignore = showed_once;
-  unburnable_ = model_->environment().unburnable();
+  MemoryReservation memory{Model::memory_budget, memoryUsed()};
+  // only undo what the last run burned instead of copying the whole grid again
+  unburnable_.revert(model_->environment().unburnable());
   probabilities_ = probabilities;
+  const auto arena_blocks_before = arena_->blocks();
   logging::verbose("{:s} Setting save points", log_prefix_);
   for (auto time : save_points_)
   {
@@ -573,9 +649,20 @@ Scenario* Scenario::run(map<DurationSize, shared_ptr<ProbabilityMap>>* probabili
   while (!cancelled_ && !scheduler_.empty())
   {
     evaluateNextEvent();
+    memory.update(memoryUsed());
   }
   ++TOTAL_STEPS;
-  unburnable_.clear();
+  // arena was released when reset so everything in it is from this run
+  const auto arena_blocks = arena_->blocks() - arena_blocks_before;
+  ARENA_ALLOCATIONS += arena_->allocations();
+  ARENA_BLOCKS += arena_blocks;
+  logging::verbose(
+    "{:s} Made {:d} allocations (at most {:d} bytes in use) from arena with {:d} new blocks",
+    log_prefix_,
+    arena_->allocations(),
+    arena_->peakBytes(),
+    arena_blocks
+  );
   if (cancelled_)
   {
     return nullptr;
@@ -837,6 +924,137 @@ CellPointsMap apply_offsets_spreadkey(
   }
   return r1;
 }
+/**
+ * \brief Time that waiting from the given time until the next hour ends at
+ * \param time Time to wait from
+ * \return Time that waiting ends at
+ */
+static DurationSize next_hour(const DurationSize time)
+{
+  const auto next_time = static_cast<DurationSize>(time_index(time) + 1) / DAY_HOURS;
+  const auto max_duration = (next_time - time) * DAY_MINUTES;
+  return time + max_duration / DAY_MINUTES;
+}
+void Scenario::calculateSpread(
+  const DurationSize time,
+  const vector<SpreadKey>& keys,
+  const ptr<const FwiWeather> wx
+)
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  const auto this_time = time_index(time);
+  if (current_time_index_ != this_time)
+  {
+    current_time_index_ = this_time;
+    // seemed like it would be good to keep offsets but max_ros_ needs to reset or things slow to
+    // a crawl?
+    if (!settings.is_surface())
+    {
+      spread_info_.clear();
+    }
+    max_ros_ = 0.0;
+  }
+  // calculate spread for every key that isn't known yet at once instead of as each is found
+  vector<SpreadKey> missing{};
+  std::ranges::copy_if(keys, std::back_inserter(missing), [this](const SpreadKey key) {
+    return !spread_info_.contains(key);
+  });
+  // scenarios with the same weather share spread calculated with the lowest minimum ros, and
+  // apply their own minimum ros to it
+  const auto min_ros = SpreadInfo::minimumRos(*this, time);
+  const auto calculate_ros = nullptr == spread_cache_ ? min_ros : settings.minimum_ros;
+  if (nullptr != spread_cache_)
+  {
+    spread_cache_->find(this_time, min_ros, cellSize(), &missing, &spread_info_);
+  }
+  auto spreads = SpreadInfo::calculateAll(*this, time, missing, nd(time), wx, calculate_ros);
+  if (nullptr != spread_cache_ && !missing.empty())
+  {
+    spread_cache_->add(this_time, missing, spreads);
+  }
+  for (size_t i = 0; i < missing.size(); ++i)
+  {
+    if (calculate_ros != min_ros)
+    {
+      spreads[i] = spreads[i].withMinimumRos(min_ros, cellSize());
+    }
+#ifdef DEBUG_SIMULATION
+    const SpreadInfo check{*this, time, missing[i], nd(time), wx};
+    logging::check_equal(spreads[i].headRos(), check.headRos(), "batch head ros");
+    logging::check_equal(spreads[i].maxIntensity(), check.maxIntensity(), "batch intensity");
+    logging::check_equal(
+      spreads[i].lengthToBreadth(), check.lengthToBreadth(), "batch length to breadth"
+    );
+    logging::check_equal(
+      spreads[i].offsets().size(), check.offsets().size(), "batch number of offsets"
+    );
+#endif
+    spread_info_.emplace(missing[i], std::move(spreads[i]));
+  }
+}
+DurationSize Scenario::nextSpreadTime(const DurationSize time, const vector<SpreadKey>& keys)
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  const auto min_date = weather_daily_->minDate();
+  const auto hour_time = [min_date](const size_t hour) {
+    return static_cast<DurationSize>(hour + static_cast<size_t>(DAY_HOURS) * min_date)
+         / DAY_HOURS;
+  };
+  const auto skip_until = [&](const size_t hour) {
+    return (nullptr == next_spread_hour_ || hour >= next_spread_hour_->size())
+           ? hour
+           : (*next_spread_hour_)[hour];
+  };
+  // cells don't change while nothing spreads, so the same keys are used for every hour
+  const auto can_spread = [&](const DurationSize for_time) {
+    const auto hour = time_index(for_time, min_date);
+    if (skip_until(hour) > hour)
+    {
+      return false;
+    }
+    const auto wx = weather(for_time);
+    const auto wx_daily = weather_daily(for_time);
+    if (nullptr == wx || nullptr == wx_daily)
+    {
+      // let spreading fail the way it usually does
+      return true;
+    }
+    // HACK: use the old ffmc for this check to be consistent with previous version
+    if (wx_daily->ffmc.value < minimumFfmcForSpread(for_time))
+    {
+      return false;
+    }
+    calculateSpread(for_time, keys, wx);
+    return std::ranges::any_of(keys, [&](const SpreadKey key) {
+      return spread_info_.at(key).headRos() >= settings.minimum_ros;
+    });
+  };
+  // waiting stops at the first hour at or after the last save
+  auto last_hour = time_index(last_save_, min_date);
+  last_hour += (hour_time(last_hour) < last_save_) ? 1 : 0;
+  auto result = time;
+  size_t waits = 0;
+  while (result < last_save_ && !can_spread(result))
+  {
+    result = next_hour(result);
+    ++waits;
+    // waiting from on the hour always ends exactly on the next hour, so go straight to the
+    // first hour that fire could spread in instead of waiting for each one
+    const auto hour = time_index(result, min_date);
+    if (result == hour_time(hour))
+    {
+      const auto next = max(hour, min(skip_until(hour), last_hour));
+      waits += next - hour;
+      result = hour_time(next);
+    }
+  }
+  // count the step each hour would have been if it had been waited for separately, except for
+  // the event at the result since it counts itself
+  step_ += (0 == waits) ? 0 : waits - 1;
+  return result;
+}
 void Scenario::scheduleFireSpread(const Event& event)
 {
   // HACK: resolve once and fail if not set already
@@ -848,28 +1066,41 @@ void Scenario::scheduleFireSpread(const Event& event)
   current_time_ = time;
   log_prefix_ = get_log_prefix(*this);
   logging::check_fatal(nullptr == wx, "No weather available for time {:f}", time);
+  if (settings.travel_time && !settings.is_surface())
+  {
+    spreadByTravelTime(time);
+    return;
+  }
   const auto next_time = static_cast<DurationSize>(this_time + 1) / DAY_HOURS;
   // should be in minutes?
   const auto max_duration = (next_time - time) * DAY_MINUTES;
-  const auto max_time = time + max_duration / DAY_MINUTES;
+  const auto max_time = next_hour(time);
+  vector<SpreadKey> keys{};
+  for (const auto& kv : points_.cells_)
+  {
+    keys.push_back(cell(kv.first).key());
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  // nothing changes while fire can't spread, so wait until it can instead of every hour
+  if (!settings.is_surface() && arrivals_.empty())
+  {
+    if (const auto spread_time = nextSpreadTime(time, keys); spread_time != time)
+    {
+      addEvent(Event{.time = spread_time, .type = Event::Type::FireSpread});
+      logging::extensive("{:s} Waiting until {:f} for spread", log_prefix_, spread_time);
+      return;
+    }
+  }
   // HACK: use the old ffmc for this check to be consistent with previous version
   if (wx_daily->ffmc.value < minimumFfmcForSpread(time))
   {
+    settleArrivals(max_time);
     addEvent(Event{.time = max_time, .type = Event::Type::FireSpread});
     logging::extensive("{:s} Waiting until {:f} because of FFMC", log_prefix_, max_time);
     return;
   }
-  if (current_time_index_ != this_time)
-  {
-    current_time_index_ = this_time;
-    // seemed like it would be good to keep offsets but max_ros_ needs to reset or things slow to
-    // a crawl?
-    if (!settings.is_surface())
-    {
-      spread_info_ = {};
-    }
-    max_ros_ = 0.0;
-  }
+  calculateSpread(time, keys, wx);
   // get once and keep
   const MathSize ros_min = settings.minimum_ros;
   spreading_points to_spread{};
@@ -916,14 +1147,24 @@ void Scenario::scheduleFireSpread(const Event& event)
   if (to_spread.empty())
   {
     // if no spread then we left everything back in points_ still
+    settleArrivals(max_time);
     logging::verbose("{:s} Waiting until {:f}", log_prefix_, max_time);
     addEvent(Event{.time = max_time, .type = Event::Type::FireSpread});
     return;
   }
-  const auto duration =
+  auto duration =
     ((max_ros_ > 0) ? min(max_duration, settings.maximum_spread_distance * cellSize() / max_ros_)
                     : max_duration);
+  if (1 < settings.spread_rate_classes)
+  {
+    duration = spreadSlowClasses(time, duration, max_duration, &to_spread);
+  }
   const auto new_time = time + duration / DAY_MINUTES;
+  ++SPREAD_STEPS;
+  for (const auto& kv : to_spread)
+  {
+    CELLS_SPREAD += kv.second.size();
+  }
   CellPointsMap cell_pts{};
   auto spread =
     std::views::transform(to_spread, [&](spreading_points::value_type& kv0) -> CellPointsMap {
@@ -943,20 +1184,81 @@ void Scenario::scheduleFireSpread(const Event& event)
     cell_pts.merge(unburnable_, cell_pts_cur);
     ++it;
   }
+  takeArrivals(new_time, &cell_pts);
+  settleSpread(new_time, &cell_pts);
+  logging::extensive(
+    "{:s} Spreading {:d} cells until {:f}", log_prefix_, points_.cells_.size(), new_time
+  );
+  addEvent(Event{.time = new_time, .type = Event::Type::FireSpread});
+}
+DurationSize Scenario::spreadSlowClasses(
+  const DurationSize time,
+  const DurationSize duration,
+  const DurationSize max_duration,
+  spreading_points* to_spread
+)
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  const auto last_class = static_cast<MathSize>(settings.spread_rate_classes - 1);
+  // each class is half as fast as the one before it, so it can take steps twice as long and
+  // still not go further than the maximum spread distance in a step
+  map<SpreadKey, DurationSize> steps{};
+  for (const auto& kv : *to_spread)
+  {
+    const auto ros = spread_info_[kv.first].headRos();
+    const auto spread_class =
+      (ros > 0) ? min(last_class, std::floor(std::log2(max_ros_ / ros))) : 0.0;
+    // steps never go past the end of the hour so all classes are together again by then
+    steps.emplace(kv.first, min(max_duration, duration * std::exp2(spread_class)));
+  }
+  // fastest class that is spreading right now sets the step for the whole front, so this only
+  // spreads slower cells less often and doesn't take fewer steps while any cell is near the
+  // fastest spread this hour
+  const auto fastest = std::ranges::min(std::views::values(steps));
+  auto it = to_spread->begin();
+  while (to_spread->end() != it)
+  {
+    auto& [key, pts] = *it;
+    const auto step = steps.at(key);
+    if (step <= fastest)
+    {
+      ++it;
+      continue;
+    }
+    const auto arrival_time = time + step / DAY_MINUTES;
+    arrivals_[arrival_time].merge(
+      unburnable_, apply_offsets_spreadkey(arrival_time, step, spread_info_[key].offsets(), pts)
+    );
+    CELLS_SPREAD += pts.size();
+    it = to_spread->erase(it);
+  }
+  return fastest;
+}
+void Scenario::takeArrivals(const DurationSize time, CellPointsMap* cell_pts)
+{
+  while (!arrivals_.empty() && arrivals_.begin()->first <= time)
+  {
+    cell_pts->merge(unburnable_, arrivals_.begin()->second);
+    arrivals_.erase(arrivals_.begin());
+  }
+}
+void Scenario::settleSpread(const DurationSize new_time, CellPointsMap* cell_pts)
+{
 #ifdef DEBUG_CELLPOINTS
-  const auto n_c = cell_pts.size();
+  const auto n_c = cell_pts->size();
 #endif
-  cell_pts.remove_if([this](const CellPointsMap::map_value& kv) {
+  cell_pts->remove_if([this](const CellPointsMap::map_value& kv) {
     auto& [location, pts] = kv;
     // clear out if unburnable
     const auto do_clear = unburnable_.at(location);
     return do_clear;
   });
 #ifdef DEBUG_CELLPOINTS
-  logging::note("{:d} cell_pts before remove_if() and {:d} after", n_c, cell_pts.size());
+  logging::note("{:d} cell_pts before remove_if() and {:d} after", n_c, cell_pts->size());
 #endif
   // need to merge new points back into cells that didn't spread
-  points_.merge(unburnable_, cell_pts);
+  points_.merge(unburnable_, *cell_pts);
   // if we move everything out of points_ we can parallelize this check?
   do_each(points_.cells_, [&](CellPointsMap::map_value& kv) {
     auto& [loc, pts] = kv;
@@ -997,18 +1299,73 @@ void Scenario::scheduleFireSpread(const Event& event)
       // not swapping means these points get dropped
     }
   });
+}
+void Scenario::settleArrivals(const DurationSize time)
+{
+  if (arrivals_.empty())
+  {
+    return;
+  }
+  // nothing else spreads before time, so anything still spreading has to arrive now
+  const auto arrival_time = min(time, arrivals_.rbegin()->first);
+  CellPointsMap cell_pts{};
+  takeArrivals(arrivals_.rbegin()->first, &cell_pts);
+  settleSpread(arrival_time, &cell_pts);
+}
+void Scenario::spreadByTravelTime(const DurationSize time)
+{
+  if (nullptr == travel_time_)
+  {
+    travel_time_ = make_unique<TravelTime>(*this, time, last_save_);
+    for (const auto& kv : points_.cells_)
+    {
+      travel_time_->ignite(kv.first);
+    }
+    points_.cells_.clear();
+  }
+  // saves sort before spread at the same time, so burn everything until the next save now
+  auto until = last_save_;
+  for (const auto save : save_points_)
+  {
+    if (save > time)
+    {
+      until = min(until, save);
+    }
+  }
+  const auto arrivals = travel_time_->arrivals(until);
+  for (const auto& event : arrivals)
+  {
+    burn(event);
+  }
   logging::extensive(
-    "{:s} Spreading {:d} cells until {:f}", log_prefix_, points_.cells_.size(), new_time
+    "{:s} Burned {:d} cells found by travel time until {:f}", log_prefix_, arrivals.size(), until
   );
-  addEvent(Event{.time = new_time, .type = Event::Type::FireSpread});
+  if (until < last_save_)
+  {
+    addEvent(Event{.time = until, .type = Event::Type::FireSpread});
+  }
 }
 MathSize Scenario::currentFireSize() const { return intensity_->fireSize(); }
+size_t Scenario::memoryUsed() const noexcept
+{
+  // points, events, and spread information are all allocated from the arena
+  auto result = sizeof(*this) + arena_->bytes() + unburnable_.memoryUsed();
+  if (nullptr != intensity_)
+  {
+    result += intensity_->memoryUsed();
+  }
+  for (const auto& o : observers_)
+  {
+    result += o->memoryUsed();
+  }
+  return result;
+}
 bool Scenario::canBurn(const XYIdx& location) const { return intensity_->canBurn(location); }
 bool Scenario::hasBurned(const XYIdx& location) const { return intensity_->hasBurned(location); }
 void Scenario::endSimulation() noexcept
 {
   logging::verbose("{:s} Ending simulation", log_prefix_);
-  scheduler_ = set<Event>();
+  scheduler_.clear();
 }
 void Scenario::addSaveByOffset(const int offset)
 {
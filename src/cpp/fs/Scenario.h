@@ -2,6 +2,7 @@
 #ifndef FS_SCENARIO_H
 #define FS_SCENARIO_H
 #include "stdafx.h"
+#include "Arena.h"
 #include "CellPoints.h"
 #include "FireSpread.h"
 #include "FireWeather.h"
@@ -11,9 +12,12 @@
 #include "Model.h"
 #include "Settings.h"
 #include "StartPoint.h"
+#include "ThresholdSampler.h"
 namespace fs
 {
 class IObserver;
+class SpreadCache;
+class TravelTime;
 struct Event;
 /**
  * \brief Deleter for IObserver to get around incomplete class with unique_ptr
@@ -43,6 +47,26 @@ public:
    * \return Total number of spread events for all Scenarios
    */
   [[nodiscard]] static size_t total_steps() noexcept;
+  /**
+   * \brief Total number of steps that spread points for all Scenarios
+   * \return Total number of steps that spread points for all Scenarios
+   */
+  [[nodiscard]] static size_t spread_steps() noexcept;
+  /**
+   * \brief Total number of times points in a cell were spread for all Scenarios
+   * \return Total number of times points in a cell were spread for all Scenarios
+   */
+  [[nodiscard]] static size_t cells_spread() noexcept;
+  /**
+   * \brief Total number of allocations from arenas for all Scenarios
+   * \return Total number of allocations from arenas for all Scenarios
+   */
+  [[nodiscard]] static size_t arena_allocations() noexcept;
+  /**
+   * \brief Total number of blocks arenas needed from the heap for all Scenarios
+   * \return Total number of blocks arenas needed from the heap for all Scenarios
+   */
+  [[nodiscard]] static size_t arena_blocks() noexcept;
   virtual ~Scenario();
   Scenario(Scenario&& rhs) noexcept;
   Scenario(const Scenario& rhs) = delete;
@@ -61,16 +85,26 @@ public:
   );
   /**
    * \brief Reset thresholds and set SafeVector to output results to
-   * \param mt_extinction Used for extinction random numbers
-   * \param mt_spread Used for spread random numbers
+   * \param sampler_extinction Used for extinction random numbers
+   * \param sampler_spread Used for spread random numbers
+   * \param index Index of this Scenario within its Iteration
    * \param final_sizes SafeVector to output results to
    * \return This
    */
   [[nodiscard]] Scenario* reset(
-    mt19937_64* mt_extinction,
-    mt19937_64* mt_spread,
+    ThresholdSampler* sampler_extinction,
+    ThresholdSampler* sampler_spread,
+    size_t index,
     ptr<SafeVector> final_sizes
   );
+  /**
+   * \brief Draw the same random numbers as reset() without keeping them or resetting anything
+   * else, but still count the simulation so later ones are numbered the same
+   * \param sampler_extinction Used for extinction random numbers
+   * \param sampler_spread Used for spread random numbers
+   * \param index Index of this Scenario within its Iteration
+   */
+  void skip(ThresholdSampler* sampler_extinction, ThresholdSampler* sampler_spread, size_t index);
   /**
    * \brief Burn cell that Event takes place in
    * \param event Event with cell location
@@ -213,11 +247,69 @@ public:
    * \param event Event to schedule
    */
   void scheduleFireSpread(const Event& event);
+  /**
+   * \brief Calculate SpreadInfo for the hour of the given time for any keys that need it
+   * \param time Time to calculate for
+   * \param keys SpreadKeys to calculate for
+   * \param wx Weather to calculate with
+   */
+  void calculateSpread(DurationSize time, const vector<SpreadKey>& keys, ptr<const FwiWeather> wx);
+  /**
+   * \brief First time that fire can spread, going forward an hour at a time like waiting does
+   * \param time Time to start from
+   * \param keys SpreadKeys for cells that have points in them
+   * \return First time that fire can spread, or first time at or after last save
+   */
+  [[nodiscard]] DurationSize nextSpreadTime(DurationSize time, const vector<SpreadKey>& keys);
+  /**
+   * \brief Spread cells that are much slower than the fastest with longer steps
+   *
+   * The number of steps is still set by the fastest class that is spreading, so this only
+   * reduces how many cells get spread each step.
+   * \param time Time spread starts at
+   * \param duration Duration of step for fastest spread this hour (minutes)
+   * \param max_duration Duration until end of the hour (minutes)
+   * \param to_spread Points to spread, which get removed if they are in a slower class
+   * \return Duration of step for fastest class that is spreading (minutes)
+   */
+  [[nodiscard]] DurationSize spreadSlowClasses(
+    DurationSize time,
+    DurationSize duration,
+    DurationSize max_duration,
+    spreading_points* to_spread
+  );
+  /**
+   * \brief Merge points that spread from slower classes and arrive by the given time
+   * \param time Time to take points that arrive by
+   * \param cell_pts Points to merge arriving points into
+   */
+  void takeArrivals(DurationSize time, CellPointsMap* cell_pts);
+  /**
+   * \brief Merge points that spread into the front, and burn or extinguish cells
+   * \param new_time Time points arrived at
+   * \param cell_pts Points that spread
+   */
+  void settleSpread(DurationSize new_time, CellPointsMap* cell_pts);
+  /**
+   * \brief Settle all points that are still spreading in slower classes
+   * \param time Time that nothing else spreads until
+   */
+  void settleArrivals(DurationSize time);
+  /**
+   * \brief Burn cells that shortest paths through the grid reach before the next save
+   * \param time Time to burn cells from
+   */
+  void spreadByTravelTime(DurationSize time);
   /**
    * \brief Current fire size (ha)
    * \return Current fire size (ha)
    */
   [[nodiscard]] MathSize currentFireSize() const;
+  /**
+   * \brief Estimate of memory used by this while running (bytes)
+   * \return Estimate of memory used by this while running (bytes)
+   */
+  [[nodiscard]] size_t memoryUsed() const noexcept;
   /**
    * \brief Whether or not a Cell can burn
    * \param location Cell
@@ -363,6 +455,10 @@ public:
    * \brief Clear the Event list and all other data
    */
   void clear() noexcept;
+  /**
+   * \brief Make IntensityMap for a new run, reusing the existing one if there is one
+   */
+  void resetIntensity();
 
 protected:
   string log_prefix_{};
@@ -413,6 +509,10 @@ protected:
    * \brief Current time for this Scenario
    */
   DurationSize current_time_;
+  /**
+   * \brief Memory for containers that only need to last for one run of this Scenario
+   */
+  uptr<Arena> arena_;
   CellPointsMap points_;
   /**
    * \brief Contains information on cells that are not burnable
@@ -421,7 +521,7 @@ protected:
   /**
    * \brief Event scheduler used for ordering events
    */
-  set<Event> scheduler_;
+  std::pmr::set<Event> scheduler_;
   /**
    * \brief Map of what intensity each cell has burned at
    */
@@ -433,11 +533,15 @@ protected:
   /**
    * \brief Calculated SpreadInfo for SpreadKey for current time
    */
-  map<SpreadKey, SpreadInfo> spread_info_{};
+  std::pmr::map<SpreadKey, SpreadInfo> spread_info_;
+  /**
+   * \brief SpreadInfo shared with Scenarios that have the same weather, if there are any
+   */
+  ptr<SpreadCache> spread_cache_;
   /**
    * \brief Map of when Cell had first Point arrive in it
    */
-  map<XYIdx, DurationSize> arrival_{};
+  std::pmr::map<XYIdx, DurationSize> arrival_;
   /**
    * \brief Maximum rate of spread for current time
    */
@@ -454,6 +558,18 @@ protected:
    * \brief Weather stream to use for spread and extinction probability
    */
   ptr<const FireWeather> weather_daily_{nullptr};
+  /**
+   * \brief First hour at or after each hour of weather_daily_ that fire could spread in
+   */
+  ptr<const vector<size_t>> next_spread_hour_{nullptr};
+  /**
+   * \brief Points spread by slower spread rate classes, by the time they arrive at
+   */
+  map<DurationSize, CellPointsMap> arrivals_{};
+  /**
+   * \brief Arrival times found as shortest paths, if using those instead of spreading points
+   */
+  uptr<TravelTime> travel_time_{};
   /**
    * \brief Model this Scenario is being run in
    */
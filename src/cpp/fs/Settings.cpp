@@ -103,6 +103,10 @@ constexpr string to_string(const Mode mode)
       return "TEST";
     case Mode::Surface:
       return "SURFACE";
+    case Mode::ConvertWeather:
+      return "CONVERT_WX";
+    case Mode::Merge:
+      return "MERGE";
   }
   exit(logging::fatal("Mode not handled"));
 };
@@ -252,6 +256,7 @@ Settings::Settings(const string dir_binary, const string dir_root) noexcept
     save_individual = get_flag(false, settings_, "SAVE_INDIVIDUAL");
     run_async = get_flag(true, settings_, "RUN_ASYNC");
     deterministic = get_flag(false, settings_, "DETERMINISTIC");
+    travel_time = get_flag(false, settings_, "TRAVEL_TIME");
     mode = get_mode(Mode::Simulation, settings_, "MODE");
     save_as_ascii = get_flag(false, settings_, "SAVE_AS_ASCII");
     save_as_tiff = get_flag(true, settings_, "SAVE_AS_TIFF");
@@ -271,6 +276,38 @@ Settings::Settings(const string dir_binary, const string dir_root) noexcept
     {
       utc_offset = stod(value);
     }
+    if (const auto value = get_value(settings_, "MAXIMUM_PROBABILITY_ERROR", false);
+        "INVALID" != value)
+    {
+      maximum_probability_error = stod(value);
+    }
+    probability_error_mean = get_flag(false, settings_, "PROBABILITY_ERROR_MEAN");
+    if (const auto value = get_value(settings_, "THRESHOLD_STRATA", false); "INVALID" != value)
+    {
+      const auto strata = stol(value);
+      logging::check_fatal(strata < 1, "THRESHOLD_STRATA must be at least 1 but is {:s}", value);
+      threshold_strata = static_cast<size_t>(strata);
+    }
+    if (const auto value = get_value(settings_, "OFFSET_MEMO_SIZE", false); "INVALID" != value)
+    {
+      offset_memo_size = stoul(value);
+    }
+    if (const auto value = get_value(settings_, "OFFSET_MEMO_STEP", false); "INVALID" != value)
+    {
+      offset_memo_step = max(0.0, stod(value));
+    }
+    if (const auto value = get_value(settings_, "SPREAD_RATE_CLASSES", false); "INVALID" != value)
+    {
+      spread_rate_classes = stoul(value);
+    }
+    if (const auto value = get_value(settings_, "CHECKPOINT_INTERVAL", false); "INVALID" != value)
+    {
+      checkpoint_interval_seconds = stoul(value);
+    }
+    if (const auto value = get_value(settings_, "MEMORY_LIMIT", false); "INVALID" != value)
+    {
+      memory_limit_mb = stoul(value);
+    }
     if (const auto value = get_value(settings_, "SALT", false); "INVALID" != value)
     {
       const int v = stoi(value);
@@ -481,7 +518,7 @@ void Settings::saveTo(const string& output_directory) const noexcept
   {
     put("SIZE", "initial fire size (ha) (if no perimeter)", initial_size);
   }
-  if (Mode::Test != mode)
+  if (Mode::Test != mode && Mode::Merge != mode)
   {
     put("START_DATE", "ignition start date (yyyy-mm-dd)", format_date(start_date.value()));
     put("START_TIME", "ignition start time (HH:MM)", format_time(start_date.value()));
@@ -553,6 +590,26 @@ void Settings::saveTo(const string& output_directory) const noexcept
     "weight given to hourly when generating random thresholds",
     threshold_hourly_weight
   );
+  put(
+    "THRESHOLD_STRATA",
+    "strata for sampling scenario and daily thresholds across iterations (0 = independent)",
+    threshold_strata
+  );
+  put(
+    "OFFSET_MEMO_SIZE",
+    "number of spread offset sets to remember per thread (0 = off)",
+    offset_memo_size
+  );
+  put(
+    "OFFSET_MEMO_STEP",
+    "relative step to quantize spread inputs to before reusing offsets (0 = exact inputs only)",
+    offset_memo_step
+  );
+  put(
+    "SPREAD_RATE_CLASSES",
+    "number of spread rate classes that advance with their own step (0 or 1 = one step)",
+    spread_rate_classes
+  );
   /////////////////////////////////////////////////////////////////////////////
   add_section("OUTPUT OPTIONS");
   put("OUTPUT_DATE_OFFSETS", "days to output probability contours for", output_date_offsets.text());
@@ -582,16 +639,41 @@ void Settings::saveTo(const string& output_directory) const noexcept
     "run deterministically (100% chance of spread & survival)  (0 = off, 1 = on)",
     deterministic
   );
+  put(
+    "TRAVEL_TIME",
+    "find arrival times as shortest paths through grid instead of spreading (0 = off, 1 = on)",
+    travel_time
+  );
   put(
     "CONFIDENCE_LEVEL",
     "confidence required before simulation stops (1.0 - (% / 100))",
     confidence_level
   );
+  put(
+    "MAXIMUM_PROBABILITY_ERROR",
+    "standard error of burn probability for last date required before stopping (0 is unused)",
+    maximum_probability_error
+  );
+  put(
+    "PROBABILITY_ERROR_MEAN",
+    "use root mean square instead of maximum error over burned cells (0 = off, 1 = on)",
+    probability_error_mean
+  );
   put(
     "INTERIM_OUTPUT_INTERVAL",
     "time between generating interim outputs (seconds) (0 is no interim outputs)",
     interim_output_interval_seconds
   );
+  put(
+    "CHECKPOINT_INTERVAL",
+    "time between saving checkpoints that runs can be resumed from (seconds) (0 is none)",
+    checkpoint_interval_seconds
+  );
+  put(
+    "MEMORY_LIMIT",
+    "estimated memory running scenarios can use before no more start (MB) (0 is unlimited)",
+    memory_limit_mb
+  );
   put(
     "MAXIMUM_TIME",
     "maximum amount of time to take for simulation (seconds) (0 is unlimited)",
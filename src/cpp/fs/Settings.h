@@ -60,7 +60,9 @@ enum class Mode
 {
   Simulation,
   Test,
-  Surface
+  Surface,
+  ConvertWeather,
+  Merge
 };
 /**
  * \brief Reads and provides access to settings for the simulation.
@@ -86,7 +88,7 @@ public:
   Mode mode{Mode::Simulation};
   // directory to put simulation outputs in
   string output_directory{};
-  // .csv with weather streams
+  // .csv or binary file with weather streams
   LazyPath wx_file_name{};
   // name to use for log file inside output_directory
   string log_file_name{"firestarr.log"};
@@ -103,16 +105,31 @@ public:
   }
   // perimeter to use for igntion (empty if none)
   LazyPath perimeter{};
+  // checkpoint to resume probabilistic run from (empty if none)
+  LazyPath resume{};
+  // which shard of iterations to run (0 based)
+  size_t shard_index{0};
+  // number of shards that iterations are split between (0 if not sharded)
+  size_t shard_count{0};
   // Whether or not to save individual grids
   bool save_individual{false};
   // Whether or not to run things asynchronously where possible
   bool run_async{true};
   // Whether or not to run deterministically (100% chance of spread & survival)
   bool deterministic{false};
+  // Whether or not to find arrival times as shortest paths through the grid instead of spreading
+  // (only when deterministic, since spread thresholds and survival aren't applied)
+  bool travel_time{false};
   // Whether or not this is running in test mode
   constexpr bool is_test() const { return Mode::Test == mode; }
   // Whether or not this is running in surface mode
   constexpr bool is_surface() const { return Mode::Surface == mode; }
+  // Whether or not this is converting a weather file to binary format
+  constexpr bool is_convert_weather() const { return Mode::ConvertWeather == mode; }
+  // Whether or not this is merging shards into outputs
+  constexpr bool is_merge() const { return Mode::Merge == mode; }
+  // Whether or not this is only running one shard of the iterations
+  constexpr bool is_sharded() const { return 0 < shard_count; }
   // Whether or not to save grids as .asc
   bool save_as_ascii{false};
   // Whether or not to save grids as .tif
@@ -157,12 +174,20 @@ public:
   int intensity_max_moderate{0};
   // Confidence required before simulation stops (% / 100)
   ThresholdSize confidence_level{0.0};
+  // Standard error of burn probability for last date required before stopping (0 is unused)
+  ThresholdSize maximum_probability_error{0.0};
+  // Whether to use root mean square instead of maximum standard error over burned cells
+  bool probability_error_mean{false};
   // Salt to use for random seeds
   size_t salt{0};
   // Maximum time simulation can run before it is ended and whatever results it has are used (s)
   size_t maximum_time_seconds{0};
   // Time between generating interim outputs (s)
   size_t interim_output_interval_seconds{0};
+  // Time between saving checkpoints that runs can be resumed from (s)
+  size_t checkpoint_interval_seconds{0};
+  // Estimated memory running scenarios can use before no more are started (MB) (0 is unlimited)
+  size_t memory_limit_mb{0};
   // Minimum number of simulations that must run before stopping
   size_t minimum_simulation_count{0};
   // Minimum number of simulations with any spread that must run before stopping
@@ -175,6 +200,14 @@ public:
   ThresholdSize threshold_daily_weight{0.0};
   // Weight to give to hourly part of thresholds
   ThresholdSize threshold_hourly_weight{0.0};
+  // Number of strata for sampling Scenario and daily parts of thresholds (0 or 1 is independent)
+  size_t threshold_strata{0};
+  // Number of spread offset sets to remember per thread (0 is no memo)
+  size_t offset_memo_size{0};
+  // Relative step to quantize inputs to before looking up spread offsets (0 is exact inputs)
+  MathSize offset_memo_step{0.0};
+  // Number of spread rate classes that each advance with their own step (0 or 1 is one step)
+  size_t spread_rate_classes{0};
   // Root directory that raster inputs are stored in
   LazyPath raster_root{};
   // Name of file that defines fuel lookup table
@@ -205,6 +238,16 @@ public:
   // number of hours to run tests for
   std::optional<MathSize> hours{};
 
+public:
+  // convert-wx mode only variables
+  // binary weather file to write wx_file_name to
+  string wx_output_file_name{};
+
+public:
+  // merge mode only variables
+  // shard files to merge into outputs
+  vector<string> shard_files{};
+
 public:
   // test/surface mode variables
   std::optional<Ffmc> ffmc{};
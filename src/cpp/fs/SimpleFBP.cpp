@@ -9,6 +9,7 @@
 #include "FWI.h"
 #include "Log.h"
 #include "RangeIterator.h"
+#include "SpreadAlgorithm.h"
 #include "unstable.h"
 namespace fs::simplefbp
 {
@@ -569,12 +570,321 @@ vector<int> find_nd_values()
   );
   return {nd_values.begin(), nd_values.end()};
 }
+/**
+ * \brief Largest difference allowed between interpolated rate of spread and calculated value
+ *
+ * ROS changes fastest near 0 ISI for fuels with c < 2, and that is where the error is largest.
+ */
+static constexpr auto EPSILON_INTERPOLATED_ROS = static_cast<MathSize>(2e-2);
+/**
+ * \brief Largest difference allowed between interpolated crown fraction burned and calculated value
+ */
+static constexpr auto EPSILON_INTERPOLATED_CFB = static_cast<MathSize>(1e-5);
+// use steps that don't line up with the table so values in between get checked
+static const auto RANGE_ISI_INTERPOLATED = range(0, 1100, 0.037);
+static const auto RANGE_CFB_INTERPOLATED = range(-10, 110, 0.0013);
+/**
+ * \brief Check that interpolated lookup tables are within error bounds of calculated values
+ *
+ * Checked whether or not USE_FBP_LOOKUP_TABLES is defined so tables can't get worse unnoticed.
+ */
+void check_lookup_tables()
+{
+  logging::info("Checking interpolated lookup tables");
+  size_t num_checked = 0;
+  for (const auto fuel : FuelLookup::Fuels)
+  {
+    // fuels that switch with season or are invalid don't have a rate of spread of their own
+    if (nullptr == fuel || std::isnan(fuel->rosBasicCalculated(0)))
+    {
+      continue;
+    }
+    const auto name = std::format("rosBasic() table for {:s}", FuelType::safeName(fuel));
+    check_range(
+      name.c_str(),
+      "isi",
+      [&](const auto& v) { return fuel->rosBasicInterpolated(v); },
+      [&](const auto& v) { return fuel->rosBasicCalculated(v); },
+      EPSILON_INTERPOLATED_ROS,
+      RANGE_ISI_INTERPOLATED
+    );
+    ++num_checked;
+  }
+  logging::check_fatal(0 == num_checked, "No fuels with rosBasic() tables to check");
+  static const LookupTable<&calculate_crown_fraction_burned, 2, 2, true> cfb{};
+  check_range(
+    "crownFractionBurned() table",
+    "rss - rso",
+    [&](const auto& v) { return cfb(v); },
+    [&](const auto& v) { return calculate_crown_fraction_burned(v); },
+    EPSILON_INTERPOLATED_CFB,
+    RANGE_CFB_INTERPOLATED
+  );
+}
+/**
+ * \brief Maximum relative difference between vector math kernels and std:: functions
+ */
+static constexpr auto EPSILON_VECTOR_MATH = static_cast<MathSize>(1e-15);
+/**
+ * \brief Check vector math kernel against std:: function and against calculating one at a time
+ *
+ * Calculating one value at a time can't use vector instructions, so getting identical bits
+ * means results don't depend on which instructions the compiler used.
+ * \param name Name of kernel
+ * \param values Values to check
+ * \param kernel Called with (values, results, count)
+ * \param expected Called with each value to get expected result
+ */
+template <class F, class G>
+void check_vector_kernel(
+  const char* name,
+  const vector<MathSize>& values,
+  const F& kernel,
+  const G& expected
+)
+{
+  logging::debug("Checking {:s}", name);
+  vector<MathSize> results(values.size());
+  kernel(values.data(), results.data(), values.size());
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    MathSize single;
+    kernel(&values[i], &single, 1);
+    logging::check_fatal(
+      std::bit_cast<uint64_t>(single) != std::bit_cast<uint64_t>(results[i]),
+      "{:s}({:g}) is {:a} for one value but {:a} with others",
+      name,
+      values[i],
+      single,
+      results[i]
+    );
+    const auto e = expected(values[i]);
+    logging::check_fatal(
+      abs(results[i] - e) > EPSILON_VECTOR_MATH * abs(e),
+      "{:s}({:g}) is {:g} but expected {:g}",
+      name,
+      values[i],
+      results[i],
+      e
+    );
+  }
+}
+/**
+ * \brief Check that vector math kernels are accurate and don't depend on vectorization
+ */
+void check_vector_math()
+{
+  logging::info("Checking vector math");
+  const auto angles = range(-10, 10, 0.0013);
+  const auto sines = [](const MathSize* v, MathSize* r, const size_t n) {
+    vector<MathSize> cosines(n);
+    vector_sincos(v, r, cosines.data(), n);
+  };
+  const auto cosines = [](const MathSize* v, MathSize* r, const size_t n) {
+    vector<MathSize> sines(n);
+    vector_sincos(v, sines.data(), r, n);
+  };
+  check_vector_kernel("vector_sincos() sine", angles, sines, [](const auto& v) {
+    return std::sin(v);
+  });
+  check_vector_kernel("vector_sincos() cosine", angles, cosines, [](const auto& v) {
+    return std::cos(v);
+  });
+  check_vector_kernel("vector_exp()", range(-700, 700, 0.037), &vector_exp, [](const auto& v) {
+    return std::exp(v);
+  });
+  check_vector_kernel("vector_log()", range(0.001, 1000, 0.0371), &vector_log, [](const auto& v) {
+    return std::log(v);
+  });
+  for (const auto exponent : {-2.5, 0.5, 1.7, 4.0})
+  {
+    const auto pow_exponent = [exponent](const MathSize* v, MathSize* r, const size_t n) {
+      const vector<MathSize> exponents(n, exponent);
+      vector_pow(v, exponents.data(), r, n);
+    };
+    check_vector_kernel(
+      "vector_pow()",
+      range(0.01, 200, 0.0173),
+      pow_exponent,
+      [exponent](const auto& v) { return std::pow(v, exponent); }
+    );
+  }
+}
+/**
+ * \brief Check that survival probability for many FwiWeather at once is accurate and doesn't
+ * depend on how many are calculated at once
+ */
+void check_survival_probabilities()
+{
+  logging::info("Checking survival probabilities");
+  // results can differ by a few ulp in each exp(), so allow a bit more than that
+  static constexpr auto EPSILON_SURVIVAL = static_cast<MathSize>(1e-13);
+  vector<FwiWeather> weather{};
+  for (const auto ffmc : range(0, 101, 2.3))
+  {
+    for (const auto dmc : range(0, 400, 9.7))
+    {
+      weather.emplace_back(
+        Weather{}, Ffmc{ffmc}, Dmc{dmc}, Dc::Zero(), Isi::Zero(), Bui::Zero(), Fwi::Zero()
+      );
+    }
+  }
+  vector<ThresholdSize> results(weather.size());
+  for (const auto fuel : FuelLookup::Fuels)
+  {
+    if (nullptr == fuel || !fuel->isValid())
+    {
+      continue;
+    }
+    fuel->survivalProbabilities(weather.data(), weather.size(), results.data());
+    for (size_t i = 0; i < weather.size(); ++i)
+    {
+      ThresholdSize single;
+      fuel->survivalProbabilities(&weather[i], 1, &single);
+      logging::check_fatal(
+        std::bit_cast<uint64_t>(single) != std::bit_cast<uint64_t>(results[i]),
+        "{:s} survival is {:a} for one value but {:a} with others",
+        fuel->name(),
+        single,
+        results[i]
+      );
+      const auto expected = fuel->survivalProbability(weather[i]);
+      logging::check_fatal(
+        abs(results[i] - expected) > EPSILON_SURVIVAL,
+        "{:s} survival with FFMC {:f} and DMC {:f} is {:g} but expected {:g}",
+        fuel->name(),
+        weather[i].ffmc.value,
+        weather[i].dmc.value,
+        results[i],
+        expected
+      );
+    }
+  }
+}
+/**
+ * \brief Calculate offsets for a range of conditions
+ * \param calculate Called with (aspect, slope, head_raz, head_ros, back_ros, length_to_breadth)
+ * \return Offsets for every combination of conditions
+ */
+template <class F>
+vector<OffsetSet> calculate_offsets_range(const F& calculate)
+{
+  vector<OffsetSet> result{};
+  for (const SlopeSize slope : {0, 10, 45})
+  {
+    for (const AspectSize aspect : {0, 135, 290})
+    {
+      for (const auto head_raz : range(0, 360, 45))
+      {
+        for (const auto head_ros : {1.0, 5.0, 20.0, 60.0})
+        {
+          for (const auto length_to_breadth : {1.0, 1.3, 2.5, 6.0})
+          {
+            result.push_back(calculate(
+              aspect,
+              slope,
+              Radians::from_degrees(head_raz),
+              head_ros,
+              head_ros / (length_to_breadth * 4.0),
+              length_to_breadth
+            ));
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+/**
+ * \brief Check that offsets don't depend on how horizontal adjustment is called, and log how long
+ * calculating them takes compared to calling adjustment through a std::function
+ */
+void check_spread_algorithm()
+{
+  logging::info("Checking SpreadAlgorithm");
+  static constexpr size_t ROUNDS = 100;
+  const WidestEllipseAlgorithm algorithm{MAX_SPREAD_ANGLE, 100.0, 0.0};
+  const auto calculate_variant = [&](
+                                   const AspectSize aspect,
+                                   const SlopeSize slope,
+                                   const Radians& head_raz,
+                                   const MathSize head_ros,
+                                   const MathSize back_ros,
+                                   const MathSize length_to_breadth
+                                 ) {
+    return algorithm.calculate_offsets(
+      horizontal_adjustment(aspect, slope), 1.5, head_raz, head_ros, back_ros, length_to_breadth
+    );
+  };
+  const auto calculate_function = [&](
+                                    const AspectSize aspect,
+                                    const SlopeSize slope,
+                                    const Radians& head_raz,
+                                    const MathSize head_ros,
+                                    const MathSize back_ros,
+                                    const MathSize length_to_breadth
+                                  ) {
+    const auto adjustment = std::visit(
+      [](const auto& v) { return AdjustmentFunction{v}; }, horizontal_adjustment(aspect, slope)
+    );
+    return algorithm.calculate_offsets_for(
+      adjustment, 1.5, head_raz, head_ros, back_ros, length_to_breadth
+    );
+  };
+  const auto expected = calculate_offsets_range(calculate_function);
+  const auto actual = calculate_offsets_range(calculate_variant);
+  check_equal(expected.size(), actual.size(), "number of offset sets");
+  for (size_t i = 0; i < expected.size(); ++i)
+  {
+    check_equal(expected[i].size(), actual[i].size(), "number of offsets");
+    for (size_t j = 0; j < expected[i].size(); ++j)
+    {
+      const auto& lhs = expected[i][j];
+      const auto& rhs = actual[i][j];
+      logging::check_fatal(
+        lhs.intensity != rhs.intensity || lhs.ros != rhs.ros || lhs.raz != rhs.raz
+          || !(lhs.offset == rhs.offset),
+        "Offset {} of set {} is different when calculated with std::function",
+        j,
+        i
+      );
+    }
+  }
+  size_t num_offsets = 0;
+  for (const auto& offsets : actual)
+  {
+    num_offsets += offsets.size();
+  }
+  const auto time_per_call = [](const auto& calculate) {
+    const auto start = Clock::now();
+    size_t n = 0;
+    for (size_t r = 0; r < ROUNDS; ++r)
+    {
+      n += calculate_offsets_range(calculate).size();
+    }
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    return static_cast<MathSize>(ns.count()) / static_cast<MathSize>(n);
+  };
+  const auto ns_function = time_per_call(calculate_function);
+  const auto ns_variant = time_per_call(calculate_variant);
+  logging::info(
+    "calculate_offsets() takes {:0.0f}ns per call with std::function and {:0.0f}ns with variant "
+    "for {:0.1f} offsets per call",
+    ns_function,
+    ns_variant,
+    static_cast<MathSize>(num_offsets) / static_cast<MathSize>(actual.size())
+  );
+}
 int test_fbp(const int argc, const char* const argv[])
 {
   std::ignore = argc;
   std::ignore = argv;
   logging::info("Testing FBP");
   ND_ALL_VALUES = find_nd_values();
+  check_lookup_tables();
+  check_vector_math();
+  check_survival_probabilities();
+  check_spread_algorithm();
   // for (size_t i = 0; i < FuelLookup::Fuels.size(); ++i)
   // {
   //   auto& a = *simplefbp::SimpleFuels[i];
@@ -6,47 +6,101 @@
 #include "Util.h"
 namespace fs
 {
+#ifdef USE_VECTOR_SINCOS
+/**
+ * \brief Direction (radians) and distance (cells) of each offset until it gets a position
+ */
+struct OffsetScratch
+{
+  vector<MathSize> directions{};
+  vector<MathSize> distances{};
+  vector<MathSize> sines{};
+  vector<MathSize> cosines{};
+};
+/**
+ * \brief Empty scratch space for offsets being calculated on this thread
+ * \return Scratch space with no directions or distances in it
+ */
+[[nodiscard]] static OffsetScratch& offset_scratch() noexcept
+{
+  // keep memory between calls since offsets get calculated for every new spread
+  thread_local OffsetScratch scratch{};
+  scratch.directions.clear();
+  scratch.distances.clear();
+  return scratch;
+}
+/**
+ * \brief Give offsets positions from the direction and distance kept for each one
+ *
+ * Every direction goes through vector_sincos() at once instead of calling sin() and cos() for
+ * each offset while they are being added.
+ * \param scratch Direction and distance for each offset, in the same order
+ * \param offsets Offsets to place
+ */
+static void place_offsets(OffsetScratch& scratch, OffsetSet& offsets) noexcept
+{
+  const auto n = offsets.size();
+  scratch.sines.resize(n);
+  scratch.cosines.resize(n);
+  vector_sincos(scratch.directions.data(), scratch.sines.data(), scratch.cosines.data(), n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    offsets[i].offset = Offset{
+      static_cast<XYSize>(scratch.distances[i] * scratch.sines[i]),
+      static_cast<XYSize>(scratch.distances[i] * scratch.cosines[i])
+    };
+  }
+}
+#endif
 HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const SlopeSize slope)
 {
-  // do everything we can to avoid calling trig functions unnecessarily
-  constexpr auto no_correction = [](const Radians&) noexcept { return 1.0; };
+  // do check once and use adjustment that just returns 1.0 if no slope
   if (0 == slope)
   {
-    // do check once and make function just return 1.0 if no slope
-    return no_correction;
+    return FlatAdjustment{};
   }
-  const auto b_semi = cos(atan(slope / 100.0));
-  const Radians slope_radians{Degrees{slope_azimuth}};
-  const auto do_correction = [=](const Radians& theta) noexcept {
-    // never gets called if isInvalid() so don't check
-    // figure out how far the ground distance is in map distance horizontally
-    const auto angle_unrotated = theta - slope_radians;
-    // if (to_degrees(angle_unrotated) == 270 || to_degrees(angle_unrotated) == 90)
-    // {
-    //   // CHECK: if we're going directly across the slope then horizontal distance is same as
-    //   spread
-    //   // distance
-    //   return 1.0;
-    // }
-    const auto tan_u = tan(angle_unrotated);
-    const auto y = b_semi / sqrt(b_semi * tan_u * (b_semi * tan_u) + 1.0);
-    const auto x = y * tan_u;
-    // CHECK: Pretty sure you can't spread farther horizontally than the spread distance, regardless
-    // of angle?
-    return min(1.0, sqrt(x * x + y * y));
-  };
-  return do_correction;
+  return SlopeAdjustment{slope_azimuth, slope};
 }
 [[nodiscard]] OffsetSet OriginalSpreadAlgorithm::calculate_offsets(
-  HorizontalAdjustment correction_factor,
+  const HorizontalAdjustment& correction_factor,
+  const MathSize tfc,
+  const Radians& head_raz,
+  const MathSize head_ros,
+  const MathSize back_ros,
+  const MathSize length_to_breadth,
+  const ptr<OffsetSteps> steps
+) const noexcept
+{
+  return std::visit(
+    [&](const auto& adjustment) {
+      return calculate_offsets_for(
+        adjustment, tfc, head_raz, head_ros, back_ros, length_to_breadth, steps
+      );
+    },
+    correction_factor
+  );
+}
+template <class Adjustment>
+[[nodiscard]] OffsetSet OriginalSpreadAlgorithm::calculate_offsets_for(
+  const Adjustment& correction_factor,
   MathSize tfc,
   const Radians& head_raz,
   MathSize head_ros,
   MathSize back_ros,
-  MathSize length_to_breadth
+  MathSize length_to_breadth,
+  const ptr<OffsetSteps> steps
 ) const noexcept
 {
   OffsetSet offsets{};
+#ifdef USE_VECTOR_SINCOS
+  auto& scratch = offset_scratch();
+#endif
+  const auto end_step = [&](const bool stops) {
+    if (nullptr != steps)
+    {
+      steps->push_back(OffsetStep{offsets.size(), stops});
+    }
+  };
   const auto add_offset = [&, tfc](const Radians& direction, const MathSize ros) {
     if (ros < min_ros_)
     {
@@ -55,6 +109,12 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
     const auto ros_cell = ros / cell_size_;
     const auto intensity = static_cast<IntensitySize>(fire_intensity(tfc, ros));
     // spreading, so figure out offset from current point
+#ifdef USE_VECTOR_SINCOS
+    // place_offsets() gives this a position once all offsets are added
+    scratch.directions.push_back(direction.value);
+    scratch.distances.push_back(ros_cell);
+    offsets.push_back(ROSOffset{intensity, ros, direction.asDegrees(), Offset{}});
+#else
     offsets.push_back(ROSOffset{
       intensity,
       ros,
@@ -64,6 +124,7 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
         static_cast<XYSize>(ros_cell * cos(direction))
       }
     });
+#endif
     return true;
   };
   // if not over spread threshold then don't spread
@@ -72,6 +133,7 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
   {
     return offsets;
   }
+  end_step(true);
   const auto a = (head_ros + back_ros) / 2.0;
   const auto c = a - back_ros;
   const auto flank_ros = a / length_to_breadth;
@@ -111,15 +173,18 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
     return add_offsets(angle_radians, calculate_ros(angle_radians));
   };
   bool added = add_offset(head_raz, head_ros);
+  end_step(true);
   MathSize i = max_angle_;
   while (added && i < 90)
   {
     added = add_offsets_calc_ros(Radians::from_degrees(i));
+    end_step(true);
     i += max_angle_;
   }
   if (added)
   {
     added = add_offsets(Radians::D_090(), flank_ros * sqrt(a_sq_sub_c_sq) / a);
+    end_step(true);
     i = 90 + max_angle_;
     while (added && i < 180)
     {
@@ -134,21 +199,55 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
       {
         const auto direction{Radians{head_raz}.to_heading().fix()};
         static_cast<void>(!add_offset(direction, back_ros * correction_factor(direction)));
+        end_step(true);
       }
     }
   }
+#ifdef USE_VECTOR_SINCOS
+  place_offsets(scratch, offsets);
+#endif
   return offsets;
 }
 [[nodiscard]] OffsetSet WidestEllipseAlgorithm::calculate_offsets(
-  const HorizontalAdjustment correction_factor,
+  const HorizontalAdjustment& correction_factor,
   const MathSize tfc,
   const Radians& head_raz,
   const MathSize head_ros,
   const MathSize back_ros,
-  const MathSize length_to_breadth
+  const MathSize length_to_breadth,
+  const ptr<OffsetSteps> steps
+) const noexcept
+{
+  return std::visit(
+    [&](const auto& adjustment) {
+      return calculate_offsets_for(
+        adjustment, tfc, head_raz, head_ros, back_ros, length_to_breadth, steps
+      );
+    },
+    correction_factor
+  );
+}
+template <class Adjustment>
+[[nodiscard]] OffsetSet WidestEllipseAlgorithm::calculate_offsets_for(
+  const Adjustment& correction_factor,
+  const MathSize tfc,
+  const Radians& head_raz,
+  const MathSize head_ros,
+  const MathSize back_ros,
+  const MathSize length_to_breadth,
+  const ptr<OffsetSteps> steps
 ) const noexcept
 {
   OffsetSet offsets{};
+#ifdef USE_VECTOR_SINCOS
+  auto& scratch = offset_scratch();
+#endif
+  const auto end_step = [&](const bool stops) {
+    if (nullptr != steps)
+    {
+      steps->push_back(OffsetStep{offsets.size(), stops});
+    }
+  };
   const auto add_offset = [&, tfc](const Radians& direction, const MathSize ros) {
 #ifdef DEBUG_POINTS
     const auto s0 = offsets.size();
@@ -161,6 +260,12 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
     const auto ros_cell = ros / cell_size_;
     const auto intensity = static_cast<IntensitySize>(fire_intensity(tfc, ros));
     // spreading, so figure out offset from current point
+#ifdef USE_VECTOR_SINCOS
+    // place_offsets() gives this a position once all offsets are added
+    scratch.directions.push_back(direction.value);
+    scratch.distances.push_back(ros_cell);
+    offsets.push_back(ROSOffset{intensity, ros, Direction{direction}, Offset{}});
+#else
     offsets.push_back(ROSOffset{
       intensity,
       ros,
@@ -170,6 +275,7 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
         static_cast<XYSize>(ros_cell * cos(direction))
       }
     });
+#endif
 #ifdef DEBUG_POINTS
     const auto s1 = offsets.size();
     logging::check_equal(s0 + 1, s1, "offsets.size()");
@@ -184,6 +290,7 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
     // #endif
     return offsets;
   }
+  end_step(true);
 #ifdef DEBUG_POINTS
   logging::check_fatal(offsets.empty(), "offsets.empty()");
 #endif
@@ -242,6 +349,7 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
     theta = min(Radians{acos(cur_x)}, last_theta + step_max);
     angle = ellipse_angle(length_to_breadth, Radians{theta});
     added = add_offsets_calc_ros(angle);
+    end_step(true);
     cur_x = cos(theta);
     last_theta = theta;
     if (theta > (STEP_MAX / 2.0))
@@ -258,11 +366,14 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
   {
     angle = ellipse_angle(length_to_breadth, Radians{(Radians::D_090() + theta) / 2.0});
     added = add_offsets_calc_ros(angle);
+    // doesn't stop since whether or not 90 is added decides that
+    end_step(false);
     // always just do one between the last angle and 90
     theta = Radians::D_090();
     // ++num_angles;
     angle = ellipse_angle(length_to_breadth, Radians{theta});
     added = add_offsets(Radians::D_090(), flank_ros * sqrt(a_sq_sub_c_sq) / a);
+    end_step(true);
     cur_x = cos(theta);
     last_theta = theta;
   }
@@ -280,6 +391,7 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
       break;
     }
     added = add_offsets_calc_ros(angle);
+    end_step(true);
     cur_x = cos(theta);
     last_theta = theta;
     cur_x -= step_x;
@@ -292,6 +404,7 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
     {
       const auto direction{Radians{head_raz}.to_heading().fix()};
       static_cast<void>(!add_offset(direction, back_ros * correction_factor(direction)));
+      end_step(true);
     }
   }
 #ifdef DEBUG_POINTS
@@ -299,7 +412,64 @@ HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const
   {
     logging::check_fatal(offsets.empty(), "Empty when ros of {:f} >= {:f}", head_ros, min_ros_);
   }
+#endif
+#ifdef USE_VECTOR_SINCOS
+  place_offsets(scratch, offsets);
 #endif
   return offsets;
 }
+template OffsetSet OriginalSpreadAlgorithm::calculate_offsets_for(
+  const FlatAdjustment&,
+  MathSize,
+  const Radians&,
+  MathSize,
+  MathSize,
+  MathSize,
+  ptr<OffsetSteps>
+) const noexcept;
+template OffsetSet OriginalSpreadAlgorithm::calculate_offsets_for(
+  const SlopeAdjustment&,
+  MathSize,
+  const Radians&,
+  MathSize,
+  MathSize,
+  MathSize,
+  ptr<OffsetSteps>
+) const noexcept;
+template OffsetSet OriginalSpreadAlgorithm::calculate_offsets_for(
+  const AdjustmentFunction&,
+  MathSize,
+  const Radians&,
+  MathSize,
+  MathSize,
+  MathSize,
+  ptr<OffsetSteps>
+) const noexcept;
+template OffsetSet WidestEllipseAlgorithm::calculate_offsets_for(
+  const FlatAdjustment&,
+  MathSize,
+  const Radians&,
+  MathSize,
+  MathSize,
+  MathSize,
+  ptr<OffsetSteps>
+) const noexcept;
+template OffsetSet WidestEllipseAlgorithm::calculate_offsets_for(
+  const SlopeAdjustment&,
+  MathSize,
+  const Radians&,
+  MathSize,
+  MathSize,
+  MathSize,
+  ptr<OffsetSteps>
+) const noexcept;
+template OffsetSet WidestEllipseAlgorithm::calculate_offsets_for(
+  const AdjustmentFunction&,
+  MathSize,
+  const Radians&,
+  MathSize,
+  MathSize,
+  MathSize,
+  ptr<OffsetSteps>
+) const noexcept;
 }
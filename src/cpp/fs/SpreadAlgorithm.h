@@ -3,21 +3,80 @@
 #define FS_SPREADALGORITHM_H
 #include "stdafx.h"
 #include "FireSpread.h"
+#include "unstable.h"
 namespace fs
 {
-using HorizontalAdjustment = std::function<MathSize(const Radians&)>;
+/**
+ * \brief Horizontal distance adjustment when there is no slope, which never changes anything
+ */
+struct FlatAdjustment
+{
+  [[nodiscard]] constexpr MathSize operator()(const Radians&) const noexcept { return 1.0; }
+};
+/**
+ * \brief Horizontal distance adjustment for spread in a direction on a slope
+ */
+class SlopeAdjustment
+{
+public:
+  /**
+   * \brief Constructor
+   * \param slope_azimuth Aspect of slope (degrees)
+   * \param slope Slope (%)
+   */
+  SlopeAdjustment(const AspectSize slope_azimuth, const SlopeSize slope) noexcept
+    : b_semi_(cos(atan(slope / 100.0))), slope_radians_(Degrees{slope_azimuth})
+  { }
+  /**
+   * \brief Ratio of horizontal distance to spread distance in direction
+   * \param theta Direction of spread
+   * \return Ratio of horizontal distance to spread distance in direction
+   */
+  [[nodiscard]] MathSize operator()(const Radians& theta) const noexcept
+  {
+    // never gets called if isInvalid() so don't check
+    // figure out how far the ground distance is in map distance horizontally
+    const auto angle_unrotated = theta - slope_radians_;
+    const auto tan_u = tan(angle_unrotated);
+    const auto y = b_semi_ / sqrt(b_semi_ * tan_u * (b_semi_ * tan_u) + 1.0);
+    const auto x = y * tan_u;
+    // CHECK: Pretty sure you can't spread farther horizontally than the spread distance, regardless
+    // of angle?
+    return min(1.0, sqrt(x * x + y * y));
+  }
+
+private:
+  /**
+   * \brief Semi-minor axis of ellipse that slope projects a circle onto
+   */
+  MathSize b_semi_;
+  /**
+   * \brief Aspect of slope
+   */
+  Radians slope_radians_;
+};
+/**
+ * \brief Horizontal distance adjustment called through a std::function, which is how it used to be
+ * done, so calculate_offsets_for() can be compared against it
+ */
+using AdjustmentFunction = function<MathSize(const Radians&)>;
+/**
+ * \brief Horizontal distance adjustment that decides between flat and sloped once per calculation
+ */
+using HorizontalAdjustment = std::variant<FlatAdjustment, SlopeAdjustment>;
 HorizontalAdjustment horizontal_adjustment(const AspectSize slope_azimuth, const SlopeSize slope);
 class SpreadAlgorithm
 {
 public:
   virtual ~SpreadAlgorithm() = default;
   [[nodiscard]] virtual OffsetSet calculate_offsets(
-    HorizontalAdjustment correction_factor,
+    const HorizontalAdjustment& correction_factor,
     MathSize tfc,
     const Radians& head_raz,
     MathSize head_ros,
     MathSize back_ros,
-    MathSize length_to_breadth
+    MathSize length_to_breadth,
+    ptr<OffsetSteps> steps = nullptr
   ) const noexcept = 0;
 };
 class BaseSpreadAlgorithm : public SpreadAlgorithm
@@ -37,26 +96,60 @@ class OriginalSpreadAlgorithm : public BaseSpreadAlgorithm
 public:
   using BaseSpreadAlgorithm::BaseSpreadAlgorithm;
   [[nodiscard]] OffsetSet calculate_offsets(
-    HorizontalAdjustment correction_factor,
+    const HorizontalAdjustment& correction_factor,
     MathSize tfc,
     const Radians& head_raz,
     MathSize head_ros,
     MathSize back_ros,
-    MathSize length_to_breadth
+    MathSize length_to_breadth,
+    ptr<OffsetSteps> steps = nullptr
   ) const noexcept override;
+  /**
+   * \brief Calculate offsets with adjustment type known at compile time
+   *
+   * Instantiated for FlatAdjustment, SlopeAdjustment and AdjustmentFunction. If steps isn't
+   * nullptr, each group of offsets that gets added together is added to it.
+   */
+  template <class Adjustment>
+  [[nodiscard]] OffsetSet calculate_offsets_for(
+    const Adjustment& correction_factor,
+    MathSize tfc,
+    const Radians& head_raz,
+    MathSize head_ros,
+    MathSize back_ros,
+    MathSize length_to_breadth,
+    ptr<OffsetSteps> steps = nullptr
+  ) const noexcept;
 };
 class WidestEllipseAlgorithm : public BaseSpreadAlgorithm
 {
 public:
   using BaseSpreadAlgorithm::BaseSpreadAlgorithm;
   [[nodiscard]] OffsetSet calculate_offsets(
-    HorizontalAdjustment correction_factor,
+    const HorizontalAdjustment& correction_factor,
     MathSize tfc,
     const Radians& head_raz,
     MathSize head_ros,
     MathSize back_ros,
-    MathSize length_to_breadth
+    MathSize length_to_breadth,
+    ptr<OffsetSteps> steps = nullptr
   ) const noexcept override;
+  /**
+   * \brief Calculate offsets with adjustment type known at compile time
+   *
+   * Instantiated for FlatAdjustment, SlopeAdjustment and AdjustmentFunction. If steps isn't
+   * nullptr, each group of offsets that gets added together is added to it.
+   */
+  template <class Adjustment>
+  [[nodiscard]] OffsetSet calculate_offsets_for(
+    const Adjustment& correction_factor,
+    MathSize tfc,
+    const Radians& head_raz,
+    MathSize head_ros,
+    MathSize back_ros,
+    MathSize length_to_breadth,
+    ptr<OffsetSteps> steps = nullptr
+  ) const noexcept;
 };
 }
 #endif
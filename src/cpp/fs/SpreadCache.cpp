@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#include "SpreadCache.h"
+namespace fs
+{
+/**
+ * \brief Number of hours to keep SpreadInfo for
+ */
+static constexpr size_t MAX_HOURS = DAY_HOURS;
+static atomic<size_t> REUSED{0};
+static atomic<size_t> CALCULATED{0};
+size_t SpreadCache::reused() noexcept { return REUSED; }
+size_t SpreadCache::calculated() noexcept { return CALCULATED; }
+SpreadCache::HourSpread& SpreadCache::forHour(const size_t hour)
+{
+  auto seek = by_hour_.find(hour);
+  if (by_hour_.end() == seek)
+  {
+    if (MAX_HOURS <= by_hour_.size())
+    {
+      // forget whichever hour was used least recently
+      by_hour_.erase(std::min_element(
+        by_hour_.begin(),
+        by_hour_.end(),
+        [](const auto& a, const auto& b) { return a.second.first < b.second.first; }
+      ));
+    }
+    seek = by_hour_.emplace(hour, pair<size_t, HourSpread>{0, HourSpread{}}).first;
+  }
+  seek->second.first = ++uses_;
+  return seek->second.second;
+}
+void SpreadCache::find(
+  const size_t hour,
+  const MathSize min_ros,
+  const MathSize cell_size,
+  vector<SpreadKey>* keys,
+  std::pmr::map<SpreadKey, SpreadInfo>* spread_info
+)
+{
+  vector<pair<SpreadKey, SpreadInfo>> found{};
+  {
+    lock_guard<mutex> lock(mutex_);
+    const auto& for_hour = forHour(hour);
+    std::erase_if(*keys, [&](const SpreadKey key) {
+      const auto seek = for_hour.find(key);
+      if (for_hour.end() == seek)
+      {
+        return false;
+      }
+      found.emplace_back(key, seek->second);
+      return true;
+    });
+  }
+  REUSED += found.size();
+  // apply this minimum without holding the lock
+  for (const auto& [key, spread] : found)
+  {
+    spread_info->emplace(key, spread.withMinimumRos(min_ros, cell_size));
+  }
+}
+void SpreadCache::add(
+  const size_t hour,
+  const vector<SpreadKey>& keys,
+  const vector<SpreadInfo>& spreads
+)
+{
+  lock_guard<mutex> lock(mutex_);
+  auto& for_hour = forHour(hour);
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    for_hour.emplace(keys[i], spreads[i]);
+  }
+  CALCULATED += keys.size();
+}
+}
@@ -0,0 +1,86 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#ifndef FS_SPREADCACHE_H
+#define FS_SPREADCACHE_H
+#include "stdafx.h"
+#include "FireSpread.h"
+namespace fs
+{
+/**
+ * \brief SpreadInfo calculated by any Scenario that uses the same weather stream.
+ *
+ * Spread is kept as calculated with the lowest minimum rate of spread any Scenario can have,
+ * so it only depends on the hour and the attributes of the Cell. Scenarios with identical
+ * weather can use what any of them already calculated and only need to leave out offsets that
+ * are too slow if their own minimum rate of spread is higher. Only the most recently used hours
+ * are kept.
+ */
+class SpreadCache
+{
+public:
+  SpreadCache() = default;
+  ~SpreadCache() = default;
+  SpreadCache(SpreadCache&& rhs) = delete;
+  SpreadCache(const SpreadCache& rhs) = delete;
+  SpreadCache& operator=(SpreadCache&& rhs) = delete;
+  SpreadCache& operator=(const SpreadCache& rhs) = delete;
+  /**
+   * \brief Put SpreadInfo that is already known into spread_info and remove keys for it
+   * \param hour Hour spread is for
+   * \param min_ros Minimum rate of spread for the Scenario at this time (m/min)
+   * \param cell_size Size of cells (m)
+   * \param keys Keys to find SpreadInfo for, which get removed if found
+   * \param spread_info Map to put SpreadInfo that was found into
+   */
+  void find(
+    size_t hour,
+    MathSize min_ros,
+    MathSize cell_size,
+    vector<SpreadKey>* keys,
+    std::pmr::map<SpreadKey, SpreadInfo>* spread_info
+  );
+  /**
+   * \brief Remember SpreadInfo so other Scenarios can use it
+   * \param hour Hour spread is for
+   * \param keys Keys that SpreadInfo is for
+   * \param spreads SpreadInfo calculated with the lowest minimum rate of spread for each key,
+   * in the same order as keys
+   */
+  void add(
+    size_t hour,
+    const vector<SpreadKey>& keys,
+    const vector<SpreadInfo>& spreads
+  );
+  /**
+   * \brief Number of SpreadInfo that have been found by any SpreadCache
+   * \return Number of SpreadInfo that have been found by any SpreadCache
+   */
+  [[nodiscard]] static size_t reused() noexcept;
+  /**
+   * \brief Number of SpreadInfo that have been added to any SpreadCache
+   * \return Number of SpreadInfo that have been added to any SpreadCache
+   */
+  [[nodiscard]] static size_t calculated() noexcept;
+
+private:
+  using HourSpread = map<SpreadKey, SpreadInfo>;
+  /**
+   * \brief Find SpreadInfo for hour and mark it as most recently used
+   * \param hour Hour to find SpreadInfo for
+   * \return SpreadInfo for hour
+   */
+  HourSpread& forHour(size_t hour);
+  /**
+   * \brief Make sure only one thread uses this at a time
+   */
+  mutex mutex_{};
+  /**
+   * \brief When each hour was last used, and SpreadInfo for it
+   */
+  map<size_t, pair<size_t, HourSpread>> by_hour_{};
+  /**
+   * \brief Number of times any hour has been used
+   */
+  size_t uses_{0};
+};
+}
+#endif
@@ -54,6 +54,37 @@ static const LookupTable<&calculate_standard_foliar_moisture_isi> STANDARD_FOLIA
  * \return Length to Breadth ratio [ST-X-3 eq 79]
  */
 static const LookupTable<&calculate_standard_length_to_breadth> STANDARD_LENGTH_TO_BREADTH{};
+/**
+ * \brief Initial rate of spread (m/min) [ST-X-3 eq 26]
+ * \tparam A Rate of spread parameter a [ST-X-3 table 6]
+ * \tparam B Rate of spread parameter b * 10000 [ST-X-3 table 6]
+ * \tparam C Rate of spread parameter c * 100 [ST-X-3 table 6]
+ * \param isi Initial Spread Index
+ * \return Initial rate of spread (m/min) [ST-X-3 eq 26]
+ */
+template <int A, int B, int C>
+[[nodiscard]] static MathSize calculate_standard_ros_basic(const MathSize isi) noexcept
+{
+  return A * pow(1.0 - exp(-B / 10000.0 * isi), C / 100.0);
+}
+/**
+ * \brief Initial rate of spread (m/min) [ST-X-3 eq 26] interpolated for every 0.1 ISI
+ * \tparam A Rate of spread parameter a [ST-X-3 table 6]
+ * \tparam B Rate of spread parameter b * 10000 [ST-X-3 table 6]
+ * \tparam C Rate of spread parameter c * 100 [ST-X-3 table 6]
+ */
+template <int A, int B, int C>
+using StandardRosBasicTable = LookupTable<&calculate_standard_ros_basic<A, B, C>, 3, 1, true>;
+#ifdef USE_FBP_LOOKUP_TABLES
+/**
+ * \brief Initial rate of spread (m/min) [ST-X-3 eq 26] interpolated for every 0.1 ISI
+ * \tparam A Rate of spread parameter a [ST-X-3 table 6]
+ * \tparam B Rate of spread parameter b * 10000 [ST-X-3 table 6]
+ * \tparam C Rate of spread parameter c * 100 [ST-X-3 table 6]
+ */
+template <int A, int B, int C>
+static const StandardRosBasicTable<A, B, C> STANDARD_ROS_BASIC{};
+#endif
 /**
  * \brief A FuelBase made of a standard fuel type.
  * \tparam A Rate of spread parameter a [ST-X-3 table 6]
@@ -132,6 +163,34 @@ public:
    * \return Initial rate of spread (m/min) [ST-X-3 eq 26]
    */
   [[nodiscard]] MathSize rosBasic(const MathSize isi) const noexcept
+  {
+#ifdef USE_FBP_LOOKUP_TABLES
+    return STANDARD_ROS_BASIC<A, B, C>(isi);
+#else
+    return calculate_standard_ros_basic<A, B, C>(isi);
+#endif
+  }
+  /**
+   * \brief Initial rate of spread (m/min) [ST-X-3 eq 26] from interpolated lookup table
+   * \param isi Initial Spread Index
+   * \return Initial rate of spread (m/min) [ST-X-3 eq 26]
+   */
+  [[nodiscard]] MathSize rosBasicInterpolated(const MathSize isi) const noexcept override
+  {
+#ifdef USE_FBP_LOOKUP_TABLES
+    return STANDARD_ROS_BASIC<A, B, C>(isi);
+#else
+    // only made if checked, since rosBasic() doesn't use it
+    static const StandardRosBasicTable<A, B, C> table{};
+    return table(isi);
+#endif
+  }
+  /**
+   * \brief Initial rate of spread (m/min) [ST-X-3 eq 26] calculated without lookup table
+   * \param isi Initial Spread Index
+   * \return Initial rate of spread (m/min) [ST-X-3 eq 26]
+   */
+  [[nodiscard]] MathSize rosBasicCalculated(const MathSize isi) const noexcept override
   {
     return a() * pow(1.0 - exp(negB() * isi), c());
   }
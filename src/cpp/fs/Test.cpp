@@ -76,7 +76,7 @@ public:
     addEvent(Event{.time = end_date, .type = Event::Type::EndSimulation});
     last_save_ = end_date;
     // cast to avoid warning
-    std::ignore = reset(nullptr, nullptr, final_sizes);
+    std::ignore = reset(nullptr, nullptr, 0, final_sizes);
   }
 };
 void showSpread(const SpreadInfo& spread, ptr<const FwiWeather> w, const FuelType* fuel)
@@ -203,6 +203,11 @@ string run_test(
   logging::debug("Starting simulation");
   // NOTE: don't want to reset first because TestScenabuirio handles what that does
   scenario.run(&probabilities);
+  logging::debug(
+    "Spread points in {:d} cells over {:d} steps",
+    Scenario::cells_spread(),
+    Scenario::spread_steps()
+  );
   logging::note("Saving results for {:s} in {:s}", test_name, output_directory);
   std::ignore = scenario.saveObservers(output_directory, test_name);
   logging::note("Final Size: {:0.0f}, ROS: {:0.2f}", scenario.currentFireSize(), info.headRos());
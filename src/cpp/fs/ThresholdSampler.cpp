@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#include "ThresholdSampler.h"
+#include "Checkpoint.h"
+#include "Log.h"
+namespace fs
+{
+static mt19937_64 make_strata_engine(const std::seed_seq& seed)
+{
+  // extend the original seed so stratum draws are independent of the main stream
+  // without consuming anything from it
+  vector<std::seed_seq::result_type> values{};
+  seed.param(std::back_inserter(values));
+  values.push_back(static_cast<std::seed_seq::result_type>(values.size()));
+  std::seed_seq seed_strata(values.begin(), values.end());
+  return mt19937_64(seed_strata);
+}
+ThresholdSampler::ThresholdSampler(std::seed_seq& seed, const size_t strata)
+  : mt_(seed), mt_strata_(make_strata_engine(seed)), strata_(strata)
+{
+  logging::check_fatal(
+    strata_ > numeric_limits<uint32_t>::max(), "Too many strata for thresholds: {:d}", strata_
+  );
+}
+void ThresholdSampler::nextIteration()
+{
+  if (isStratified() && 0 == (iteration_ % strata_))
+  {
+    // new block so every dimension needs a new order for strata
+    for (auto& p : permutations_)
+    {
+      p.clear();
+    }
+  }
+  ++iteration_;
+}
+ThresholdSize ThresholdSampler::stratified(const size_t dimension)
+{
+  if (dimension >= permutations_.size())
+  {
+    permutations_.resize(dimension + 1);
+  }
+  auto& p = permutations_[dimension];
+  if (p.empty())
+  {
+    // Fisher-Yates with raw engine output so order is the same on every platform
+    p.resize(strata_);
+    std::iota(p.begin(), p.end(), 0);
+    for (auto i = strata_ - 1; i > 0; --i)
+    {
+      std::swap(p[i], p[static_cast<size_t>(mt_strata_() % (i + 1))]);
+    }
+  }
+  // nextIteration() has already been called for this iteration
+  const auto stratum = p[(iteration_ - 1) % strata_];
+  return (stratum + rand_(mt_strata_)) / static_cast<ThresholdSize>(strata_);
+}
+ThresholdSize ThresholdSampler::general(const size_t scenario)
+{
+  if (!isStratified())
+  {
+    return rand_(mt_);
+  }
+  return stratified(scenario * (MAX_DAYS + 1));
+}
+ThresholdSize ThresholdSampler::daily(const size_t scenario, const Day day)
+{
+  if (!isStratified())
+  {
+    return rand_(mt_);
+  }
+  return stratified(scenario * (MAX_DAYS + 1) + day + 1);
+}
+ThresholdSize ThresholdSampler::hourly() { return rand_(mt_); }
+void ThresholdSampler::save(ostream& out) const
+{
+  checkpoint::write_value<uint64_t>(out, strata_);
+  checkpoint::write_value<uint64_t>(out, iteration_);
+  checkpoint::write_engine(out, mt_);
+  checkpoint::write_engine(out, mt_strata_);
+  checkpoint::write_value<uint64_t>(out, permutations_.size());
+  for (const auto& p : permutations_)
+  {
+    checkpoint::write_values(out, p);
+  }
+}
+void ThresholdSampler::load(std::istream& in)
+{
+  const auto strata = static_cast<size_t>(checkpoint::read_value<uint64_t>(in));
+  logging::check_fatal(
+    strata != strata_, "Checkpoint uses {:d} strata for thresholds instead of {:d}", strata, strata_
+  );
+  iteration_ = static_cast<size_t>(checkpoint::read_value<uint64_t>(in));
+  checkpoint::read_engine(in, &mt_);
+  checkpoint::read_engine(in, &mt_strata_);
+  permutations_.resize(static_cast<size_t>(checkpoint::read_value<uint64_t>(in)));
+  for (auto& p : permutations_)
+  {
+    p = checkpoint::read_values<uint32_t>(in);
+  }
+}
+}
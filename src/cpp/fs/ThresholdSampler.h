@@ -0,0 +1,99 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#ifndef FS_THRESHOLDSAMPLER_H
+#define FS_THRESHOLDSAMPLER_H
+#include "stdafx.h"
+namespace fs
+{
+/**
+ * \brief Source of the uniform random numbers that make up Scenario thresholds.
+ *
+ * With 0 or 1 strata this draws everything independently from a single mt19937_64
+ * in the same order as always. With more strata, the Scenario and daily components
+ * use Latin hypercube sampling across blocks of that many Iterations, while the hourly
+ * component stays independent.
+ */
+class ThresholdSampler
+{
+public:
+  /**
+   * \brief Constructor
+   * \param seed Seed to use for random numbers
+   * \param strata Number of strata to split Scenario and daily components into
+   */
+  ThresholdSampler(std::seed_seq& seed, size_t strata);
+  ThresholdSampler(const ThresholdSampler& rhs) = delete;
+  ThresholdSampler(ThresholdSampler&& rhs) noexcept = default;
+  ThresholdSampler& operator=(const ThresholdSampler& rhs) = delete;
+  ThresholdSampler& operator=(ThresholdSampler&& rhs) noexcept = default;
+  /**
+   * \brief Start generating thresholds for the next Iteration
+   */
+  void nextIteration();
+  /**
+   * \brief Scenario-wide component of threshold
+   * \param scenario Index of Scenario within Iteration
+   * \return Value in [0, 1)
+   */
+  [[nodiscard]] ThresholdSize general(size_t scenario);
+  /**
+   * \brief Daily component of threshold
+   * \param scenario Index of Scenario within Iteration
+   * \param day Day to get component for
+   * \return Value in [0, 1)
+   */
+  [[nodiscard]] ThresholdSize daily(size_t scenario, Day day);
+  /**
+   * \brief Hourly component of threshold
+   * \return Value in [0, 1)
+   */
+  [[nodiscard]] ThresholdSize hourly();
+  /**
+   * \brief Whether Scenario and daily components are stratified
+   * \return Whether Scenario and daily components are stratified
+   */
+  [[nodiscard]] bool isStratified() const noexcept { return strata_ > 1; }
+  /**
+   * \brief Write state to a checkpoint so thresholds can continue from the same place
+   * \param out Stream to write to
+   */
+  void save(ostream& out) const;
+  /**
+   * \brief Restore state that was written by save()
+   * \param in Stream to read from
+   */
+  void load(std::istream& in);
+
+private:
+  /**
+   * \brief Value for the current Iteration from the stratum assigned to a dimension
+   * \param dimension Dimension to get value for
+   * \return Value in [0, 1)
+   */
+  [[nodiscard]] ThresholdSize stratified(size_t dimension);
+  /**
+   * \brief Engine for independent draws
+   */
+  mt19937_64 mt_;
+  /**
+   * \brief Engine for stratum permutations and jitter within strata
+   */
+  mt19937_64 mt_strata_;
+  /**
+   * \brief Distribution used for all draws
+   */
+  uniform_real_distribution<ThresholdSize> rand_{0.0, 1.0};
+  /**
+   * \brief Number of strata (and Iterations per block)
+   */
+  size_t strata_;
+  /**
+   * \brief Number of Iterations started
+   */
+  size_t iteration_{0};
+  /**
+   * \brief Order strata are used in for each dimension in the current block
+   */
+  vector<vector<uint32_t>> permutations_{};
+};
+}
+#endif
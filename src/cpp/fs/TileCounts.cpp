@@ -0,0 +1,114 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#include "TileCounts.h"
+namespace fs
+{
+TileCounts::TileCounts(const Idx width, const Idx height)
+  : tiles_x_(static_cast<size_t>((width + COUNT_TILE_WIDTH - 1) / COUNT_TILE_WIDTH))
+{
+  const auto tiles_y = static_cast<size_t>((height + COUNT_TILE_WIDTH - 1) / COUNT_TILE_WIDTH);
+  tiles_.resize(tiles_x_ * tiles_y);
+  used_.resize(tiles_.size(), false);
+}
+TileBitCounts::TileBitCounts(const Idx width, const Idx height)
+  : tiles_x_(
+      static_cast<size_t>((width + TileCounts::COUNT_TILE_WIDTH - 1) / TileCounts::COUNT_TILE_WIDTH)
+    )
+{
+  const auto tiles_y =
+    static_cast<size_t>((height + TileCounts::COUNT_TILE_WIDTH - 1) / TileCounts::COUNT_TILE_WIDTH);
+  tiles_.resize(tiles_x_ * tiles_y);
+  used_.resize(tiles_.size(), false);
+}
+void TileBitCounts::addMarked()
+{
+  for (const auto t : marked_)
+  {
+    auto& tile = *tiles_[t];
+    // ripple carry through planes a whole row of cells at a time
+    auto carry = tile.marked;
+    for (size_t i = 0;; ++i)
+    {
+      if (std::all_of(carry.cbegin(), carry.cend(), [](const Word w) { return 0 == w; }))
+      {
+        break;
+      }
+      if (tile.planes.size() == i)
+      {
+        tile.planes.emplace_back();
+      }
+      auto& plane = tile.planes[i];
+      for (size_t r = 0; r < plane.size(); ++r)
+      {
+        const auto overflow = plane[r] & carry[r];
+        plane[r] ^= carry[r];
+        carry[r] = overflow;
+      }
+    }
+    tile.marked.fill(0);
+    tile.is_marked = false;
+    used_[t] = true;
+  }
+  marked_.clear();
+}
+void TileBitCounts::expandTile(const size_t tile, TileCounts::Tile* counts)
+{
+  auto& planes = tiles_[tile]->planes;
+  for (size_t i = 0; i < planes.size(); ++i)
+  {
+    auto& plane = planes[i];
+    for (size_t r = 0; r < plane.size(); ++r)
+    {
+      auto word = plane[r];
+      // only visit cells that have this bit set
+      while (0 != word)
+      {
+        const auto c = static_cast<size_t>(std::countr_zero(word));
+        (*counts)[r * TileCounts::COUNT_TILE_WIDTH + c] += TileCounts::CountSize{1} << i;
+        word &= word - 1;
+      }
+    }
+    plane.fill(0);
+  }
+}
+void TileBitCounts::clear() noexcept
+{
+  for (size_t t = 0; t < tiles_.size(); ++t)
+  {
+    if (nullptr != tiles_[t])
+    {
+      for (auto& plane : tiles_[t]->planes)
+      {
+        plane.fill(0);
+      }
+      tiles_[t]->marked.fill(0);
+      tiles_[t]->is_marked = false;
+    }
+    used_[t] = false;
+  }
+  marked_.clear();
+}
+void TileCounts::clear() noexcept
+{
+  for (size_t t = 0; t < tiles_.size(); ++t)
+  {
+    if (used_[t])
+    {
+      tiles_[t]->fill(0);
+      used_[t] = false;
+    }
+  }
+}
+void TileCounts::save(ostream& out) const
+{
+  checkpoint::write_value<uint64_t>(out, tiles_.size());
+  checkpoint::write_value<uint64_t>(out, std::count(used_.cbegin(), used_.cend(), true));
+  for (size_t t = 0; t < tiles_.size(); ++t)
+  {
+    if (used_[t])
+    {
+      checkpoint::write_value<uint64_t>(out, t);
+      checkpoint::write_value(out, *tiles_[t]);
+    }
+  }
+}
+}
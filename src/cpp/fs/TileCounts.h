@@ -0,0 +1,337 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#ifndef FS_TILECOUNTS_H
+#define FS_TILECOUNTS_H
+#include "stdafx.h"
+#include "Checkpoint.h"
+#include "Location.h"
+namespace fs
+{
+/**
+ * \brief Dense count for every cell in a grid, allocated one tile at a time as cells in
+ * that tile get counted.
+ */
+class TileCounts
+{
+public:
+  /**
+   * \brief Type used for count in each cell
+   */
+  using CountSize = uint32_t;
+  /**
+   * \brief Width and height of each tile (cells)
+   */
+  static constexpr Idx COUNT_TILE_WIDTH = 64;
+  /**
+   * \brief Number of cells in each tile
+   */
+  static constexpr size_t TILE_CELLS = static_cast<size_t>(COUNT_TILE_WIDTH) * COUNT_TILE_WIDTH;
+  using Tile = array<CountSize, TILE_CELLS>;
+  /**
+   * \brief Constructor
+   * \param width Width of grid (cells)
+   * \param height Height of grid (cells)
+   */
+  TileCounts(Idx width, Idx height);
+  TileCounts(TileCounts&& rhs) noexcept = default;
+  TileCounts(const TileCounts& rhs) = delete;
+  TileCounts& operator=(TileCounts&& rhs) noexcept = default;
+  TileCounts& operator=(const TileCounts& rhs) = delete;
+  /**
+   * \brief Add one to count for Location
+   * \param location Location to increment count for
+   */
+  void increment(const XYIdx& location)
+  {
+    const auto t = tileIndex(location);
+    auto& tile = tiles_[t];
+    if (nullptr == tile)
+    {
+      tile = make_unique<Tile>();
+    }
+    used_[t] = true;
+    ++(*tile)[cellIndex(location)];
+  }
+  /**
+   * \brief Number of tiles covering grid
+   * \return Number of tiles covering grid
+   */
+  [[nodiscard]] size_t numTiles() const noexcept { return tiles_.size(); }
+  /**
+   * \brief Add counts for a tile from another TileCounts and zero them there
+   *
+   * Different tiles can be moved in parallel.
+   * \param rhs TileCounts to take counts from
+   * \param tile Index of tile to move
+   * \param on_change Called with (previous, added) for every cell that changes
+   */
+  template <class F>
+  void moveTile(TileCounts* rhs, const size_t tile, F&& on_change)
+  {
+    if (!rhs->used_[tile])
+    {
+      return;
+    }
+    addTile(tile, *rhs->tiles_[tile], on_change);
+    rhs->tiles_[tile]->fill(0);
+    rhs->used_[tile] = false;
+  }
+  /**
+   * \brief Add counts for every cell in a tile
+   *
+   * Different tiles can be added in parallel.
+   * \param tile Index of tile to add to
+   * \param counts Counts to add for each cell in tile
+   * \param on_change Called with (previous, added) for every cell that changes
+   */
+  template <class F>
+  void addTile(const size_t tile, const Tile& counts, F&& on_change)
+  {
+    auto& to = tiles_[tile];
+    if (nullptr == to)
+    {
+      to = make_unique<Tile>();
+    }
+    used_[tile] = true;
+    for (size_t i = 0; i < TILE_CELLS; ++i)
+    {
+      if (0 != counts[i])
+      {
+        on_change((*to)[i], counts[i]);
+        (*to)[i] += counts[i];
+      }
+    }
+  }
+  /**
+   * \brief Add counts for a tile from another TileCounts and zero them there
+   * \param rhs TileCounts to take counts from
+   * \param tile Index of tile to move
+   */
+  void moveTile(TileCounts* rhs, const size_t tile)
+  {
+    moveTile(rhs, tile, [](const CountSize, const CountSize) {});
+  }
+  /**
+   * \brief Call function for every Location with a count that isn't 0
+   * \param fct Called with (location, count)
+   */
+  template <class F>
+  void forEach(F&& fct) const
+  {
+    for (size_t t = 0; t < tiles_.size(); ++t)
+    {
+      if (!used_[t])
+      {
+        continue;
+      }
+      const auto& tile = *tiles_[t];
+      const auto x0 = static_cast<Idx>((t % tiles_x_) * COUNT_TILE_WIDTH);
+      const auto y0 = static_cast<Idx>((t / tiles_x_) * COUNT_TILE_WIDTH);
+      for (size_t i = 0; i < TILE_CELLS; ++i)
+      {
+        if (0 != tile[i])
+        {
+          fct(
+            XYIdx{
+              static_cast<Idx>(x0 + i % COUNT_TILE_WIDTH),
+              static_cast<Idx>(y0 + i / COUNT_TILE_WIDTH)
+            },
+            tile[i]
+          );
+        }
+      }
+    }
+  }
+  /**
+   * \brief Set all counts to 0 but keep tiles allocated for reuse
+   */
+  void clear() noexcept;
+  /**
+   * \brief Write every tile that has counts to a checkpoint
+   * \param out Stream to write to
+   */
+  void save(ostream& out) const;
+  /**
+   * \brief Add counts for tiles that were written by save()
+   * \param in Stream to read from
+   * \param on_change Called with (previous, added) for every cell that changes
+   */
+  template <class F>
+  void load(std::istream& in, F&& on_change)
+  {
+    const auto num_tiles = static_cast<size_t>(checkpoint::read_value<uint64_t>(in));
+    logging::check_fatal(
+      num_tiles != tiles_.size(),
+      "Checkpoint has counts for {:d} tiles instead of {:d}",
+      num_tiles,
+      tiles_.size()
+    );
+    const auto num_used = static_cast<size_t>(checkpoint::read_value<uint64_t>(in));
+    for (size_t i = 0; i < num_used; ++i)
+    {
+      const auto t = static_cast<size_t>(checkpoint::read_value<uint64_t>(in));
+      logging::check_fatal(t >= tiles_.size(), "Invalid tile {:d} in checkpoint", t);
+      addTile(t, checkpoint::read_value<Tile>(in), on_change);
+    }
+  }
+
+private:
+  [[nodiscard]] size_t tileIndex(const XYIdx& location) const noexcept
+  {
+    return static_cast<size_t>(location.y_value() / COUNT_TILE_WIDTH) * tiles_x_
+         + static_cast<size_t>(location.x_value() / COUNT_TILE_WIDTH);
+  }
+  [[nodiscard]] static size_t cellIndex(const XYIdx& location) noexcept
+  {
+    return static_cast<size_t>(location.y_value() % COUNT_TILE_WIDTH) * COUNT_TILE_WIDTH
+         + static_cast<size_t>(location.x_value() % COUNT_TILE_WIDTH);
+  }
+  /**
+   * \brief Number of tiles in each row
+   */
+  size_t tiles_x_;
+  /**
+   * \brief Tiles that have been allocated (nullptr if never used)
+   */
+  vector<uptr<Tile>> tiles_{};
+  /**
+   * \brief Whether each tile might have any count that isn't 0
+   */
+  vector<uint8_t> used_{};
+};
+/**
+ * \brief Counts for every cell in a grid kept as bit planes, so adding a mask of cells only
+ * takes a few word operations for every 64 cells.
+ *
+ * Cells get marked one at a time and then every marked cell gets added at once. Counts are
+ * only expanded to integers when they get moved into a TileCounts.
+ */
+class TileBitCounts
+{
+public:
+  /**
+   * \brief Word holding one bit for each cell in a row of a tile
+   */
+  using Word = uint64_t;
+  static_assert(sizeof(Word) * 8 == TileCounts::COUNT_TILE_WIDTH);
+  /**
+   * \brief One Word for each row in a tile
+   */
+  using Plane = array<Word, TileCounts::COUNT_TILE_WIDTH>;
+  /**
+   * \brief Constructor
+   * \param width Width of grid (cells)
+   * \param height Height of grid (cells)
+   */
+  TileBitCounts(Idx width, Idx height);
+  TileBitCounts(TileBitCounts&& rhs) noexcept = default;
+  TileBitCounts(const TileBitCounts& rhs) = delete;
+  TileBitCounts& operator=(TileBitCounts&& rhs) noexcept = default;
+  TileBitCounts& operator=(const TileBitCounts& rhs) = delete;
+  /**
+   * \brief Mark Location so it gets counted on next call to addMarked()
+   * \param location Location to mark
+   */
+  void mark(const XYIdx& location)
+  {
+    const auto t = static_cast<size_t>(location.y_value() / TileCounts::COUNT_TILE_WIDTH) * tiles_x_
+                 + static_cast<size_t>(location.x_value() / TileCounts::COUNT_TILE_WIDTH);
+    auto& tile = tiles_[t];
+    if (nullptr == tile)
+    {
+      tile = make_unique<Tile>();
+    }
+    if (!tile->is_marked)
+    {
+      tile->is_marked = true;
+      marked_.push_back(t);
+    }
+    tile->marked[location.y_value() % TileCounts::COUNT_TILE_WIDTH] |=
+      Word{1} << (location.x_value() % TileCounts::COUNT_TILE_WIDTH);
+  }
+  /**
+   * \brief Add one to count for every marked cell and clear marks
+   */
+  void addMarked();
+  /**
+   * \brief Number of tiles covering grid
+   * \return Number of tiles covering grid
+   */
+  [[nodiscard]] size_t numTiles() const noexcept { return tiles_.size(); }
+  /**
+   * \brief Add counts for a tile into a TileCounts and zero them here
+   *
+   * Different tiles can be moved in parallel.
+   * \param to TileCounts to add counts to
+   * \param tile Index of tile to move
+   * \param on_change Called with (previous, added) for every cell that changes in to
+   */
+  template <class F>
+  void moveTile(TileCounts* to, const size_t tile, F&& on_change)
+  {
+    if (!used_[tile])
+    {
+      return;
+    }
+    TileCounts::Tile counts{};
+    expandTile(tile, &counts);
+    to->addTile(tile, counts, on_change);
+    used_[tile] = false;
+  }
+  /**
+   * \brief Add counts for a tile into a TileCounts and zero them here
+   * \param to TileCounts to add counts to
+   * \param tile Index of tile to move
+   */
+  void moveTile(TileCounts* to, const size_t tile)
+  {
+    moveTile(to, tile, [](const TileCounts::CountSize, const TileCounts::CountSize) {});
+  }
+  /**
+   * \brief Set all counts to 0 but keep tiles allocated for reuse
+   */
+  void clear() noexcept;
+
+private:
+  /**
+   * \brief Marks and bit planes for counts of one tile
+   */
+  struct Tile
+  {
+    /**
+     * \brief Cells marked since last addMarked()
+     */
+    Plane marked{};
+    /**
+     * \brief Bit i of count for each cell is in planes[i]
+     */
+    vector<Plane> planes{};
+    /**
+     * \brief Whether this is in list of marked tiles
+     */
+    bool is_marked{false};
+  };
+  /**
+   * \brief Convert bit planes for tile to integer counts and zero them
+   * \param tile Index of tile to expand
+   * \param counts Counts to fill in
+   */
+  void expandTile(size_t tile, TileCounts::Tile* counts);
+  /**
+   * \brief Number of tiles in each row
+   */
+  size_t tiles_x_;
+  /**
+   * \brief Tiles that have been allocated (nullptr if never used)
+   */
+  vector<uptr<Tile>> tiles_{};
+  /**
+   * \brief Whether each tile might have any count that isn't 0
+   */
+  vector<uint8_t> used_{};
+  /**
+   * \brief Tiles with any cells marked since last addMarked()
+   */
+  vector<size_t> marked_{};
+};
+}
+#endif
@@ -0,0 +1,275 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#include "TravelTime.h"
+#include "FuelLookup.h"
+#include "Scenario.h"
+#include "Settings.h"
+namespace fs
+{
+/**
+ * \brief Whether a cell is a move on its own, or just further along the line of a closer one
+ * \param x Column of cell relative to cell spreading
+ * \param y Row of cell relative to cell spreading
+ * \return Whether cell is a move on its own
+ */
+static constexpr bool is_move(const Idx x, const Idx y)
+{
+  return 1 == std::gcd(x, y);
+}
+/**
+ * \brief Cells that fire spreads to from a cell, relative to that cell
+ */
+static constexpr auto MOVES = [] {
+  array<pair<Idx, Idx>, TravelTime::NUM_MOVES> result{};
+  size_t i = 0;
+  for (Idx x = -TravelTime::MOVE_RADIUS; x <= TravelTime::MOVE_RADIUS; ++x)
+  {
+    for (Idx y = -TravelTime::MOVE_RADIUS; y <= TravelTime::MOVE_RADIUS; ++y)
+    {
+      if (is_move(x, y))
+      {
+        // fails to compile if NUM_MOVES is too small
+        result.at(i++) = {x, y};
+      }
+    }
+  }
+  return result;
+}();
+static_assert(
+  [] {
+    size_t count = 0;
+    for (Idx x = -TravelTime::MOVE_RADIUS; x <= TravelTime::MOVE_RADIUS; ++x)
+    {
+      for (Idx y = -TravelTime::MOVE_RADIUS; y <= TravelTime::MOVE_RADIUS; ++y)
+      {
+        count += is_move(x, y);
+      }
+    }
+    return count;
+  }() == TravelTime::NUM_MOVES,
+  "NUM_MOVES must match number of moves within MOVE_RADIUS"
+);
+/**
+ * \brief Direction the move goes in, from -1 to 1 in each axis
+ * \param move Move to find direction of
+ * \return Direction the move goes in, from -1 to 1 in each axis
+ */
+static constexpr pair<Idx, Idx> step_of(const pair<Idx, Idx>& move)
+{
+  return {static_cast<Idx>((move.first > 0) - (move.first < 0)),
+          static_cast<Idx>((move.second > 0) - (move.second < 0))};
+}
+/**
+ * \brief Cross product of two vectors
+ * \param ax X component of first vector
+ * \param ay Y component of first vector
+ * \param bx X component of second vector
+ * \param by Y component of second vector
+ * \return Cross product of two vectors
+ */
+static constexpr MathSize cross(
+  const MathSize ax,
+  const MathSize ay,
+  const MathSize bx,
+  const MathSize by
+)
+{
+  return ax * by - ay * bx;
+}
+TravelTime::TravelTime(
+  const Scenario& scenario,
+  const DurationSize start_time,
+  const DurationSize end_time
+)
+  : scenario_(&scenario), start_time_(start_time), end_time_(end_time)
+{ }
+void TravelTime::ignite(const XYIdx& location)
+{
+  if (arrived_.insert(location).second)
+  {
+    relax(location, start_time_);
+  }
+}
+vector<Event> TravelTime::arrivals(const DurationSize time)
+{
+  vector<Event> result{};
+  while (!queue_.empty() && queue_.top().first <= time)
+  {
+    const auto [arrival, location] = queue_.top();
+    queue_.pop();
+    // anything that got somewhere sooner already made this arrival pointless
+    if (!arrived_.insert(location).second)
+    {
+      continue;
+    }
+    auto seek = best_.find(location);
+    result.emplace_back(seek->second);
+    best_.erase(seek);
+    relax(location, arrival);
+  }
+  return result;
+}
+const TravelTime::Rates& TravelTime::ratesFor(const DurationSize time, const SpreadKey key)
+{
+  // HACK: resolve once and fail if not set already
+  static const auto& settings = fs::settings::instance();
+  const auto hour = time_index(time);
+  auto seek = rates_.find({hour, key});
+  if (rates_.end() != seek)
+  {
+    return seek->second;
+  }
+  Rates rates{};
+  // use the same time for the whole hour no matter which arrival needs it first
+  const auto for_time = max(start_time_, to_time(hour));
+  const auto wx = scenario_->weather(for_time);
+  const auto wx_daily = scenario_->weather_daily(for_time);
+  // HACK: use the old ffmc for this check to be consistent with spreading points
+  if (nullptr != wx && nullptr != wx_daily
+      && wx_daily->ffmc.value >= scenario_->minimumFfmcForSpread(for_time))
+  {
+    const SpreadInfo spread{*scenario_, for_time, key, scenario_->nd(for_time), wx};
+    if (!spread.isNotSpreading() && spread.headRos() >= settings.minimum_ros)
+    {
+      // offsets go all the way around in order of direction they spread in
+      auto offsets = spread.offsets();
+      std::ranges::sort(offsets, {}, [](const ROSOffset& r) {
+        return std::atan2(r.offset.y, r.offset.x);
+      });
+      for (size_t i = 0; i < NUM_MOVES; ++i)
+      {
+        const auto& [move_x, move_y] = MOVES[i];
+        const auto length = std::hypot(move_x, move_y);
+        const auto ux = move_x / length;
+        const auto uy = move_y / length;
+        auto& [rate, closest] = rates[i];
+        rate = 0.0;
+        for (size_t j = 0; j < offsets.size(); ++j)
+        {
+          const auto& p = offsets[j];
+          const auto& q = offsets[(j + 1) % offsets.size()];
+          const auto dx = q.offset.x - p.offset.x;
+          const auto dy = q.offset.y - p.offset.y;
+          // an edge that turns half way around or more means nothing spreads that way
+          if (cross(p.offset.x, p.offset.y, q.offset.x, q.offset.y) <= 0 && offsets.size() > 2)
+          {
+            continue;
+          }
+          const auto denominator = cross(ux, uy, dx, dy);
+          if (0 == denominator)
+          {
+            continue;
+          }
+          // point along the edge that a ray in the direction of the move crosses it at
+          const auto along = cross(p.offset.x, p.offset.y, ux, uy) / denominator;
+          const auto distance = cross(p.offset.x, p.offset.y, dx, dy) / denominator;
+          if (along < 0 || along > 1 || distance <= rate)
+          {
+            continue;
+          }
+          rate = distance;
+          closest = (along < 0.5) ? p : q;
+        }
+      }
+    }
+  }
+  return rates_.emplace(pair<size_t, SpreadKey>{hour, key}, rates).first->second;
+}
+DurationSize TravelTime::travel(
+  const DurationSize time,
+  const SpreadKey key,
+  const size_t move,
+  ptr<const ROSOffset>* offset
+)
+{
+  const auto& [move_x, move_y] = MOVES[move];
+  auto remaining = std::hypot(static_cast<MathSize>(move_x), static_cast<MathSize>(move_y));
+  auto now = time;
+  while (now < end_time_)
+  {
+    const auto& [rate, closest] = ratesFor(now, key)[move];
+    const auto until = min(end_time_, to_time(time_index(now) + 1));
+    if (rate > 0)
+    {
+      const auto available = (until - now) * DAY_MINUTES;
+      if (remaining <= rate * available)
+      {
+        *offset = &closest;
+        return now + remaining / rate / DAY_MINUTES;
+      }
+      remaining -= rate * available;
+    }
+    now = until;
+  }
+  return numeric_limits<DurationSize>::infinity();
+}
+void TravelTime::relax(const XYIdx& location, const DurationSize time)
+{
+  const auto key = scenario_->cell(location).key();
+  const auto can_enter = [&](const Idx x, const Idx y) {
+    return x >= 0 && y >= 0 && x < scenario_->width() && y < scenario_->height()
+        && !is_null_fuel(scenario_->cell(XYIdx{x, y}));
+  };
+  for (size_t i = 0; i < NUM_MOVES; ++i)
+  {
+    const auto& move = MOVES[i];
+    const auto x = static_cast<Idx>(location.x_value() + move.first);
+    const auto y = static_cast<Idx>(location.y_value() + move.second);
+    if (!can_enter(x, y))
+    {
+      continue;
+    }
+    const XYIdx to{x, y};
+    if (arrived_.contains(to) || !scenario_->canBurn(to))
+    {
+      continue;
+    }
+    const auto [step_x, step_y] = step_of(move);
+    // a move can't jump over something that blocks both cells its line passes between
+    const auto steps = max(abs(move.first), abs(move.second));
+    auto blocked = false;
+    for (Idx k = 1; !blocked && k < steps; ++k)
+    {
+      const auto along_x = static_cast<MathSize>(k * move.first) / steps;
+      const auto along_y = static_cast<MathSize>(k * move.second) / steps;
+      blocked = !can_enter(
+                  static_cast<Idx>(location.x_value() + std::floor(along_x)),
+                  static_cast<Idx>(location.y_value() + std::floor(along_y))
+                )
+             && !can_enter(
+                  static_cast<Idx>(location.x_value() + std::ceil(along_x)),
+                  static_cast<Idx>(location.y_value() + std::ceil(along_y))
+                );
+    }
+    if (blocked)
+    {
+      continue;
+    }
+    ptr<const ROSOffset> offset = nullptr;
+    const auto arrival = travel(time, key, i, &offset);
+    if (arrival > end_time_)
+    {
+      continue;
+    }
+    const auto seek = best_.find(to);
+    if (best_.end() != seek && seek->second.time <= arrival)
+    {
+      continue;
+    }
+    const XYIdx toward{
+      static_cast<Idx>(location.x_value() + step_x), static_cast<Idx>(location.y_value() + step_y)
+    };
+    best_.insert_or_assign(
+      to,
+      Event{
+        .time = arrival,
+        .xy = to,
+        .ros = offset->ros,
+        .intensity = offset->intensity,
+        .raz = offset->raz,
+        .source = location.relativeIndex(toward)
+      }
+    );
+    queue_.emplace(arrival, to);
+  }
+}
+}
@@ -0,0 +1,124 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#ifndef FS_TRAVELTIME_H
+#define FS_TRAVELTIME_H
+#include "stdafx.h"
+#include <queue>
+#include "Event.h"
+#include "FireSpread.h"
+namespace fs
+{
+class Scenario;
+/**
+ * \brief Finds when fire arrives in each cell as the shortest path through the grid, instead of
+ * spreading points.
+ *
+ * Cells spread to every cell within a few cells of them that isn't further along the same line as
+ * a closer one, so there are enough directions that the head of a long narrow fire stays round.
+ * The rate of spread in a direction is where a ray in that direction crosses the shape that the
+ * offsets from SpreadInfo make, so it uses the same spread as points do. Rates change every hour,
+ * so travel between cells keeps going at whatever rate each hour has until it gets there. Fire
+ * always survives in cells it arrives in, so results are only comparable to spreading points when
+ * running deterministically.
+ */
+class TravelTime
+{
+public:
+  /**
+   * \brief Furthest that a cell spreads to directly in either axis
+   */
+  static constexpr Idx MOVE_RADIUS = 4;
+  /**
+   * \brief Number of directions that cells spread to other cells in
+   */
+  static constexpr size_t NUM_MOVES = 48;
+  /**
+   * \brief Constructor
+   * \param scenario Scenario to find arrival times for
+   * \param start_time Time that fire starts spreading at
+   * \param end_time Time to stop looking for arrivals at
+   */
+  TravelTime(const Scenario& scenario, DurationSize start_time, DurationSize end_time);
+  ~TravelTime() = default;
+  TravelTime(TravelTime&& rhs) noexcept = default;
+  TravelTime(const TravelTime& rhs) = delete;
+  TravelTime& operator=(TravelTime&& rhs) noexcept = default;
+  TravelTime& operator=(const TravelTime& rhs) = delete;
+  /**
+   * \brief Start spreading from a cell that is already burning
+   * \param location Location of cell that is burning
+   */
+  void ignite(const XYIdx& location);
+  /**
+   * \brief Find cells that fire arrives in by the given time, in the order it arrives in them
+   * \param time Time to find arrivals until
+   * \return Events to burn each cell that fire arrives in
+   */
+  [[nodiscard]] vector<Event> arrivals(DurationSize time);
+
+private:
+  /**
+   * \brief Rate of spread towards each move (cells/min), and the offset closest to that direction
+   */
+  using Rates = array<pair<MathSize, ROSOffset>, NUM_MOVES>;
+  /**
+   * \brief Rates of spread for a cell during the hour that contains the given time
+   * \param time Time to find rates for
+   * \param key SpreadKey for cell that fire is spreading from
+   * \return Rates of spread towards each move, which are all 0 if fire can't spread
+   */
+  [[nodiscard]] const Rates& ratesFor(DurationSize time, SpreadKey key);
+  /**
+   * \brief Find when fire that leaves a cell at the given time gets to the cell for a move
+   * \param time Time fire leaves cell at
+   * \param key SpreadKey for cell that fire is spreading from
+   * \param move Index of move to the other cell
+   * \param offset ROSOffset that fire arrives with
+   * \return Time fire arrives at, or after end time if it never does
+   */
+  [[nodiscard]] DurationSize travel(
+    DurationSize time,
+    SpreadKey key,
+    size_t move,
+    ptr<const ROSOffset>* offset
+  );
+  /**
+   * \brief Update arrival time of every cell that fire in the given cell can reach sooner
+   * \param location Location of cell that fire has arrived in
+   * \param time Time fire arrived at
+   */
+  void relax(const XYIdx& location, DurationSize time);
+  /**
+   * \brief Scenario to find arrival times for
+   */
+  ptr<const Scenario> scenario_;
+  /**
+   * \brief Time that fire starts spreading at
+   */
+  DurationSize start_time_;
+  /**
+   * \brief Time to stop looking for arrivals at
+   */
+  DurationSize end_time_;
+  /**
+   * \brief Rates for each hour and SpreadKey that have been needed so far
+   */
+  map<pair<size_t, SpreadKey>, Rates> rates_{};
+  /**
+   * \brief Earliest known arrival in each cell that is reachable, and the Event to burn it with
+   */
+  map<XYIdx, Event> best_{};
+  /**
+   * \brief Cells that fire has already arrived in
+   */
+  set<XYIdx> arrived_{};
+  /**
+   * \brief Cells to look at next, ordered by when fire arrives in them
+   */
+  std::priority_queue<
+    pair<DurationSize, XYIdx>,
+    vector<pair<DurationSize, XYIdx>>,
+    std::greater<pair<DurationSize, XYIdx>>>
+    queue_{};
+};
+}
+#endif
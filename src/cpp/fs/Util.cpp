@@ -176,22 +176,36 @@ DurationSize to_time(
 {
   return to_time(to_tm(year, month, day, hour, minute));
 }
-void read_date(istringstream* iss, string* str, tm* t)
+string_view next_field(string_view* text, const char delimiter) noexcept
 {
+  const auto end = text->find(delimiter);
+  const auto field = text->substr(0, end);
+  text->remove_prefix((string_view::npos == end) ? text->size() : end + 1);
+  return field;
+}
+int64_t read_date(string_view* text, tm* t)
+{
+  using namespace std::chrono;
   *t = {};
-  // Date
-  getline(iss, str, ',');
-  string ds;
-  istringstream dss(*str);
-  getline(dss, ds, '-');
-  t->tm_year = stoi(ds) - TM_YEAR_OFFSET;
-  getline(dss, ds, '-');
-  t->tm_mon = stoi(ds) - TM_MONTH_OFFSET;
-  getline(dss, ds, ' ');
-  t->tm_mday = stoi(ds);
-  getline(dss, ds, ':');
-  t->tm_hour = stoi(ds);
-  logging::verbose("Date is {:s}", format_datetime(*t));
+  auto date = next_field(text, ',');
+  const auto year_value = parse_number<int>(next_field(&date, '-'));
+  const auto month_value = parse_number<unsigned>(next_field(&date, '-'));
+  const auto day_value = parse_number<unsigned>(next_field(&date, ' '));
+  const auto hour = parse_number<int>(next_field(&date, ':'));
+  const year_month_day ymd{year{year_value}, month{month_value}, day{day_value}};
+  if (!ymd.ok() || 0 > hour || DAY_HOURS <= hour)
+  {
+    throw runtime_error(std::format(
+      "{:d}-{:02d}-{:02d} {:02d}:00 is not a valid date", year_value, month_value, day_value, hour
+    ));
+  }
+  const sys_days days{ymd};
+  t->tm_year = year_value - TM_YEAR_OFFSET;
+  t->tm_mon = static_cast<int>(month_value) - TM_MONTH_OFFSET;
+  t->tm_mday = static_cast<int>(day_value);
+  t->tm_hour = hour;
+  t->tm_yday = static_cast<int>((days - sys_days{ymd.year() / January / 1}).count());
+  return static_cast<int64_t>(days.time_since_epoch().count()) * DAY_HOURS + hour;
 }
 UsageCount::~UsageCount() { logging::note("{:s} called {:d} times", for_what_, count_.load()); }
 UsageCount::UsageCount(string for_what) noexcept : count_(0), for_what_(std::move(for_what)) { }
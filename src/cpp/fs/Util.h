@@ -242,12 +242,48 @@ DurationSize to_time(
   const int minute
 );
 /**
- * \brief Read a date from the given stream
- * \param iss Stream to read from
- * \param str string to read date into
- * \param t tm to parse date into
+ * \brief Remove the first field from text
+ * \param text Text to take field from, which gets moved past the field and delimiter
+ * \param delimiter Character that ends field
+ * \return Text before delimiter, or all of text if there is no delimiter
  */
-void read_date(istringstream* iss, string* str, tm* t);
+string_view next_field(string_view* text, char delimiter) noexcept;
+/**
+ * \brief Parse a number from text, ignoring whitespace around it
+ * \tparam T Type of number to parse
+ * \param text Text to parse
+ * \return Number represented by text
+ * \throws runtime_error if text is not a number
+ */
+template <typename T>
+[[nodiscard]] T parse_number(string_view text)
+{
+  constexpr auto whitespace = " \t\r\n";
+  const auto first = text.find_first_not_of(whitespace);
+  text = (string_view::npos == first)
+         ? string_view{}
+         : text.substr(first, text.find_last_not_of(whitespace) - first + 1);
+  // from_chars() doesn't accept a leading '+' but stod() and stoi() do
+  const auto number = (text.starts_with('+')) ? text.substr(1) : text;
+  T value{};
+  const auto end = number.data() + number.size();
+  const auto [ptr, ec] = std::from_chars(number.data(), end, value);
+  if (std::errc{} != ec || end != ptr || number.empty())
+  {
+    throw runtime_error(std::format("'{:s}' is not a valid number", text));
+  }
+  return value;
+}
+/**
+ * \brief Read a date in 'YYYY-MM-DD HH' format from the start of text, without using mktime()
+ *
+ * Anything after the hour (i.e. minutes and seconds) is ignored.
+ * \param text Text to read from, which gets moved past the date and the comma after it
+ * \param t tm to parse date into (year, month, day of month, hour, and day of year are set)
+ * \return Number of hours since epoch, for checking that times are sequential
+ * \throws runtime_error if text does not start with a valid date
+ */
+int64_t read_date(string_view* text, tm* t);
 /**
  * \brief Provides the ability to determine how many times something is used during a simulation.
  */
@@ -410,32 +446,6 @@ void month_and_day(
 {
   return Radians{atan2(sin(theta) / length_to_breadth, cos(theta))}.fix();
 }
-// make a set of shared pointers that compares the underlying objects
-template <class T>
-struct sp_less
-{
-  bool operator()(const std::shared_ptr<T>& lhs, const std::shared_ptr<T>& rhs) const
-  {
-    if (!lhs || !rhs)
-    {
-      return !lhs && rhs;
-    }
-    return *lhs < *rhs;
-  }
-};
-template <class T>
-class sp_set : public std::set<shared_ptr<T>, sp_less<T>>
-{
-  using base = std::set<shared_ptr<T>, sp_less<T>>;
-
-public:
-  template <class... Args>
-  auto sp_emplace(Args&&... args)
-  {
-    // make it so emplace will work on object type and not shared_ptr
-    return base::emplace(new T(std::forward<Args>(args)...));
-  }
-};
 inline string find_value(
   const string_view key,
   const string_view within,
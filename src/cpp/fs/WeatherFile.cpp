@@ -0,0 +1,505 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#include "WeatherFile.h"
+#include "Input.h"
+#include "Log.h"
+#include "MappedFile.h"
+#include "Util.h"
+namespace fs
+{
+/**
+ * \brief Start of every binary weather file
+ */
+static constexpr array<char, 8> WEATHER_MAGIC{'F', 'S', 'W', 'E', 'A', 'T', 'H', 'R'};
+static constexpr uint64_t WEATHER_VERSION = 1;
+/**
+ * \brief Value that reads differently if file was written on machine with other byte order
+ */
+static constexpr uint64_t WEATHER_BYTE_ORDER = 0x0102030405060708ULL;
+/**
+ * \brief Number of hourly values for each row, in the same order as .csv columns
+ */
+static constexpr size_t NUM_HOURLY_COLUMNS = 11;
+/**
+ * \brief Header at start of binary weather file.
+ *
+ * Header is followed by:
+ *   - scenario for each stream (uint64_t)
+ *   - hourly columns of PREC, TEMP, RH, WS, WD, FFMC, DMC, DC, ISI, BUI, FWI (MathSize),
+ *     each with every hour from start of min_date to end of max_date for each stream in turn
+ *   - daily column of 24 hour precip accumulation at noon (MathSize), with every day from
+ *     min_date to max_date for each stream in turn, and NaN for days without a noon row
+ */
+struct WeatherFileHeader
+{
+  array<char, 8> magic;
+  uint64_t version;
+  uint64_t byte_order;
+  uint64_t num_scenarios;
+  int64_t min_date;
+  int64_t max_date;
+  int64_t year;
+};
+/**
+ * \brief Hourly and daily weather for one scenario, read from consecutive rows of input
+ */
+struct ScenarioWeatherRows
+{
+  /**
+   * \brief Scenario that rows are for
+   */
+  size_t scenario;
+  /**
+   * \brief Text of rows for scenario
+   */
+  string_view rows;
+  /**
+   * \brief Day, hour, and weather for each row, in order
+   */
+  vector<tuple<Day, int, FwiWeather>> hourly{};
+  /**
+   * \brief Daily weather calculated at noon of each day
+   */
+  map<Day, FwiWeather> daily{};
+  Day min_date = numeric_limits<Day>::max();
+  Day max_date = numeric_limits<Day>::min();
+  /**
+   * \brief Year of last row
+   */
+  YearSize year = 0;
+  /**
+   * \brief Why rows could not be read (empty if they were read successfully)
+   */
+  string error{};
+};
+/**
+ * \brief Read rows for a scenario and calculate daily weather from them
+ * \param yesterday FwiWeather for yesterday
+ * \param latitude Latitude to calculate for
+ * \param rows Rows to read, which get updated with what was read or why they couldn't be
+ */
+static void read_scenario_rows(
+  const FwiWeather& yesterday,
+  const MathSize latitude,
+  ScenarioWeatherRows* rows
+) noexcept
+{
+  try
+  {
+    logging::debug("Loading scenario {:d}...", rows->scenario);
+    auto prev = &yesterday;
+    // HACK: adding to original object if we don't do this?
+    auto apcp_24h = yesterday.prec.value;
+    auto prev_hour = numeric_limits<int64_t>::min();
+    auto text = rows->rows;
+    while (!text.empty())
+    {
+      auto row = next_field(&text, '\n');
+      // scenario was already checked when splitting rows up
+      if (next_field(&row, ',').empty())
+      {
+        continue;
+      }
+      struct tm t{};
+      const auto cur_hour = read_date(&row, &t);
+      rows->year = t.tm_year + TM_YEAR_OFFSET;
+      const auto day = static_cast<Day>(t.tm_yday);
+      if (1 == rows->scenario && !rows->hourly.empty() && day < rows->min_date)
+      {
+        rows->error = "Weather input file crosses year boundary or dates are not sequential";
+        return;
+      }
+      rows->min_date = min(rows->min_date, day);
+      rows->max_date = max(rows->max_date, day);
+      if (numeric_limits<int64_t>::min() != prev_hour && 1 != cur_hour - prev_hour)
+      {
+        rows->error = std::format(
+          "Expected sequential hours in weather input but rows are {:f} hours away from each other",
+          static_cast<MathSize>(cur_hour - prev_hour)
+        );
+        return;
+      }
+      prev_hour = cur_hour;
+      const auto w = read_fwi_weather(&row);
+      if (0 > w.prec.value)
+      {
+        rows->error = std::format("Hourly weather precip {:f} is negative", w.prec.value);
+        return;
+      }
+      rows->hourly.emplace_back(day, t.tm_hour, w);
+      apcp_24h += w.prec.value;
+      logging::extensive(
+        "Adding {:f} to precip results in accumulation of {:f}", w.prec.value, apcp_24h
+      );
+      if (12 == t.tm_hour)
+      {
+        // we just hit noon on a new day, so add the daily value
+        if (rows->daily.contains(day))
+        {
+          rows->error = "Day already exists";
+          return;
+        }
+        const auto month = t.tm_mon + 1;
+        prev = &rows->daily
+                  .emplace(
+                    day,
+                    FwiWeather{
+                      *prev, month, latitude, w.temperature, w.rh, w.wind, Precipitation(apcp_24h)
+                    }
+                  )
+                  .first->second;
+        // new 24 hour period
+        logging::extensive("Resetting daily precip to {:f} from {:f}", 0.0, apcp_24h);
+        apcp_24h = 0;
+      }
+    }
+  }
+  catch (const std::exception& ex)
+  {
+    rows->error = ex.what();
+  }
+}
+/**
+ * \brief Read weather streams from .csv weather file contents
+ * \param filename Name of file, for error messages
+ * \param text Contents of file
+ * \param yesterday FwiWeather for day before weather starts
+ * \param latitude Latitude to calculate daily indices for
+ * \return Weather streams in file
+ */
+static WeatherStreams read_weather_csv(
+  const string& filename,
+  string_view text,
+  const FwiWeather& yesterday,
+  const MathSize latitude
+)
+{
+  logging::info("Reading scenarios from '{:s}'", filename);
+  // read header line
+  string header{next_field(&text, '\n')};
+  // get rid of whitespace
+  header.erase(std::remove(header.begin(), header.end(), ' '), header.end());
+  header.erase(std::remove(header.begin(), header.end(), '\r'), header.end());
+  constexpr auto expected_header = "Scenario,Date,PREC,TEMP,RH,WS,WD,FFMC,DMC,DC,ISI,BUI,FWI";
+  logging::check_fatal(
+    expected_header != header,
+    "Input CSV must have columns in this order:\n'{:s}'\n but got:\n'{:s}'",
+    expected_header,
+    header
+  );
+  // split into blocks of rows for each scenario so they can be read in parallel
+  vector<ScenarioWeatherRows> scenarios{};
+  set<size_t> seen{};
+  while (!text.empty())
+  {
+    const auto row_start = text.data();
+    auto row = next_field(&text, '\n');
+    const auto field = next_field(&row, ',');
+    if (field.empty())
+    {
+      continue;
+    }
+    // HACK: ignore date and just worry about relative order??
+    size_t cur = 0;
+    try
+    {
+      cur = static_cast<size_t>(parse_number<int>(field));
+    }
+    catch (const std::exception& ex)
+    {
+      logging::fatal(
+        ex, "Error reading weather file {:s}: {:s} is not a valid integer", filename, field
+      );
+    }
+    if (scenarios.empty() || scenarios.back().scenario != cur)
+    {
+      logging::check_fatal(
+        !seen.insert(cur).second, "Weather for scenario {:d} is not in consecutive rows", cur
+      );
+      scenarios.push_back({.scenario = cur, .rows = {row_start, 0}});
+    }
+    auto& rows = scenarios.back().rows;
+    rows = {rows.data(), static_cast<size_t>(text.data() - rows.data())};
+  }
+  std::for_each(
+#if !defined(__APPLE__) || !defined(__clang__)
+    // apple clang doesn't support this?
+    std::execution::par,
+#endif
+    scenarios.begin(),
+    scenarios.end(),
+    [&](ScenarioWeatherRows& rows) { read_scenario_rows(yesterday, latitude, &rows); }
+  );
+  WeatherStreams result{};
+  for (const auto& rows : scenarios)
+  {
+    logging::check_fatal(
+      !rows.error.empty(),
+      "Error reading weather file {:s} for scenario {:d}: {:s}",
+      filename,
+      rows.scenario,
+      rows.error
+    );
+    result.min_date = min(result.min_date, rows.min_date);
+    result.max_date = max(result.max_date, rows.max_date);
+    result.year = rows.year;
+  }
+  for (auto& rows : scenarios)
+  {
+    // HACK: can be up until rest of year since start date
+    vector<FwiWeather> s((result.max_date - result.min_date + 1) * DAY_HOURS);
+    for (const auto& [day, hour, w] : rows.hourly)
+    {
+      const auto for_time = (day - result.min_date) * DAY_HOURS + hour;
+      logging::verbose("for_time == {:d}", for_time);
+      s.at(static_cast<size_t>(for_time)) = w;
+    }
+    result.scenarios.push_back(rows.scenario);
+    result.hourly.push_back(std::move(s));
+    result.daily.push_back(std::move(rows.daily));
+  }
+  return result;
+}
+/**
+ * \brief Read value from binary weather file
+ * \param data Start of values
+ * \param i Index of value to read
+ * \return Value at index
+ */
+template <typename T>
+[[nodiscard]] static T load(const char* const data, const size_t i) noexcept
+{
+  // HACK: memcpy() instead of casting so alignment and aliasing don't matter
+  T value;
+  std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+  return value;
+}
+/**
+ * \brief Read weather streams from binary weather file contents
+ * \param filename Name of file, for error messages
+ * \param text Contents of file
+ * \param yesterday FwiWeather for day before weather starts
+ * \param latitude Latitude to calculate daily indices for
+ * \return Weather streams in file
+ */
+static WeatherStreams read_weather_binary(
+  const string& filename,
+  const string_view text,
+  const FwiWeather& yesterday,
+  const MathSize latitude
+)
+{
+  logging::info("Reading binary scenarios from '{:s}'", filename);
+  WeatherFileHeader header{};
+  logging::check_fatal(
+    text.size() < sizeof header, "Binary weather file {:s} is too small", filename
+  );
+  std::memcpy(&header, text.data(), sizeof header);
+  logging::check_fatal(
+    WEATHER_BYTE_ORDER != header.byte_order,
+    "Binary weather file {:s} was written on a machine with different byte order",
+    filename
+  );
+  logging::check_fatal(
+    WEATHER_VERSION != header.version,
+    "Binary weather file {:s} is version {:d} but expected version {:d}",
+    filename,
+    header.version,
+    WEATHER_VERSION
+  );
+  const auto num_scenarios = static_cast<size_t>(header.num_scenarios);
+  const auto num_days = static_cast<size_t>(header.max_date - header.min_date + 1);
+  const auto num_hours = num_days * DAY_HOURS;
+  const auto expected_size = sizeof header
+                           + sizeof(uint64_t) * num_scenarios
+                           + sizeof(MathSize) * NUM_HOURLY_COLUMNS * num_scenarios * num_hours
+                           + sizeof(MathSize) * num_scenarios * num_days;
+  logging::check_fatal(
+    header.min_date > header.max_date || expected_size != text.size(),
+    "Binary weather file {:s} should be {:d} bytes but is {:d}",
+    filename,
+    expected_size,
+    text.size()
+  );
+  const auto ids = text.data() + sizeof header;
+  const auto hourly = ids + sizeof(uint64_t) * num_scenarios;
+  const auto column_size = sizeof(MathSize) * num_scenarios * num_hours;
+  const auto daily = hourly + NUM_HOURLY_COLUMNS * column_size;
+  WeatherStreams result{
+    .min_date = static_cast<Day>(header.min_date),
+    .max_date = static_cast<Day>(header.max_date),
+    .year = static_cast<YearSize>(header.year),
+    .scenarios = vector<size_t>(num_scenarios),
+    .hourly = vector<vector<FwiWeather>>(num_scenarios),
+    .daily = vector<map<Day, FwiWeather>>(num_scenarios)
+  };
+  vector<size_t> streams(num_scenarios);
+  std::iota(streams.begin(), streams.end(), 0);
+  std::for_each(
+#if !defined(__APPLE__) || !defined(__clang__)
+    // apple clang doesn't support this?
+    std::execution::par,
+#endif
+    streams.begin(),
+    streams.end(),
+    [&](const size_t stream) {
+      result.scenarios.at(stream) = static_cast<size_t>(load<uint64_t>(ids, stream));
+      auto& s = result.hourly.at(stream);
+      s.reserve(num_hours);
+      const auto value = [&](const size_t column, const size_t hour) {
+        return load<MathSize>(hourly + column * column_size, stream * num_hours + hour);
+      };
+      for (size_t hour = 0; hour < num_hours; ++hour)
+      {
+        s.emplace_back(
+          Temperature{value(1, hour)},
+          RelativeHumidity{value(2, hour)},
+          Wind{Speed{value(3, hour)}, Direction{Degrees{value(4, hour)}}},
+          Precipitation{value(0, hour)},
+          Ffmc{value(5, hour)},
+          Dmc{value(6, hour)},
+          Dc{value(7, hour)},
+          Isi{value(8, hour)},
+          Bui{value(9, hour)},
+          Fwi{value(10, hour)}
+        );
+      }
+      auto& s_daily = result.daily.at(stream);
+      auto prev = &yesterday;
+      for (size_t i = 0; i < num_days; ++i)
+      {
+        auto apcp_24h = load<MathSize>(daily, stream * num_days + i);
+        if (std::isnan(apcp_24h))
+        {
+          continue;
+        }
+        const auto noon = i * DAY_HOURS + 12;
+        if (s_daily.empty() && 0 != yesterday.prec.value)
+        {
+          // first day was saved without yesterday's precip, so add up in the same order as .csv
+          apcp_24h = yesterday.prec.value;
+          for (size_t hour = 0; hour <= noon; ++hour)
+          {
+            apcp_24h += s.at(hour).prec.value;
+          }
+        }
+        const auto day = static_cast<Day>(header.min_date + static_cast<int64_t>(i));
+        size_t month;
+        size_t day_of_month;
+        month_and_day(result.year, day, &month, &day_of_month);
+        const auto& w = s.at(noon);
+        prev = &s_daily
+                  .emplace(
+                    day,
+                    FwiWeather{
+                      *prev,
+                      static_cast<int>(month),
+                      latitude,
+                      w.temperature,
+                      w.rh,
+                      w.wind,
+                      Precipitation(apcp_24h)
+                    }
+                  )
+                  .first->second;
+      }
+    }
+  );
+  return result;
+}
+/**
+ * \brief Whether or not file contents are a binary weather file
+ * \param text Contents of file
+ * \return Whether or not file contents are a binary weather file
+ */
+static bool is_weather_binary(const string_view text) noexcept
+{
+  return text.starts_with(string_view{WEATHER_MAGIC.data(), WEATHER_MAGIC.size()});
+}
+WeatherStreams read_weather_streams(
+  const string& filename,
+  const FwiWeather& yesterday,
+  const MathSize latitude
+)
+{
+  const MappedFile in{filename};
+  logging::check_fatal(!in.isOpen(), "Could not open input weather file {:s}", filename);
+  return is_weather_binary(in.text())
+         ? read_weather_binary(filename, in.text(), yesterday, latitude)
+         : read_weather_csv(filename, in.text(), yesterday, latitude);
+}
+/**
+ * \brief Write values to binary weather file
+ * \param out Stream to write to
+ * \param values Values to write
+ */
+template <typename T>
+static void write_values(ofstream& out, const vector<T>& values)
+{
+  out.write(reinterpret_cast<const char*>(values.data()), sizeof(T) * values.size());
+}
+int convert_weather(const string& file_in, const string& file_out)
+{
+  const MappedFile in{file_in};
+  logging::check_fatal(!in.isOpen(), "Could not open input weather file {:s}", file_in);
+  logging::check_fatal(
+    is_weather_binary(in.text()), "Weather file {:s} is already in binary format", file_in
+  );
+  // daily indices don't get saved so it doesn't matter what they start from, but precip does
+  const auto streams = read_weather_csv(file_in, in.text(), FwiWeather::Zero(), 0.0);
+  logging::check_fatal(streams.scenarios.empty(), "No weather in file {:s}", file_in);
+  ofstream out{file_out, std::ios::binary};
+  logging::check_fatal(!out.is_open(), "Cannot open file {:s} for output", file_out);
+  const WeatherFileHeader header{
+    .magic = WEATHER_MAGIC,
+    .version = WEATHER_VERSION,
+    .byte_order = WEATHER_BYTE_ORDER,
+    .num_scenarios = streams.scenarios.size(),
+    .min_date = streams.min_date,
+    .max_date = streams.max_date,
+    .year = streams.year
+  };
+  out.write(reinterpret_cast<const char*>(&header), sizeof header);
+  write_values(out, vector<uint64_t>{streams.scenarios.begin(), streams.scenarios.end()});
+  const array<function<MathSize(const FwiWeather&)>, NUM_HOURLY_COLUMNS> columns{
+    [](const FwiWeather& w) { return w.prec.value; },
+    [](const FwiWeather& w) { return w.temperature.value; },
+    [](const FwiWeather& w) { return w.rh.value; },
+    [](const FwiWeather& w) { return w.wind.speed.value; },
+    [](const FwiWeather& w) { return w.wind.direction.value; },
+    [](const FwiWeather& w) { return w.ffmc.value; },
+    [](const FwiWeather& w) { return w.dmc.value; },
+    [](const FwiWeather& w) { return w.dc.value; },
+    [](const FwiWeather& w) { return w.isi.value; },
+    [](const FwiWeather& w) { return w.bui.value; },
+    [](const FwiWeather& w) { return w.fwi.value; }
+  };
+  vector<MathSize> values{};
+  for (const auto& column : columns)
+  {
+    for (const auto& s : streams.hourly)
+    {
+      values.resize(s.size());
+      std::transform(s.begin(), s.end(), values.begin(), column);
+      write_values(out, values);
+    }
+  }
+  for (const auto& s_daily : streams.daily)
+  {
+    values.clear();
+    for (auto day = streams.min_date; day <= streams.max_date; ++day)
+    {
+      const auto seek = s_daily.find(day);
+      values.push_back(
+        (s_daily.end() == seek) ? numeric_limits<MathSize>::quiet_NaN() : seek->second.prec.value
+      );
+    }
+    write_values(out, values);
+  }
+  out.close();
+  logging::check_fatal(out.fail(), "Could not close file {:s}", file_out);
+  logging::note(
+    "Converted {:d} scenarios from {:s} to {:s}", streams.scenarios.size(), file_in, file_out
+  );
+  return 0;
+}
+}
@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+#ifndef FS_WEATHERFILE_H
+#define FS_WEATHERFILE_H
+#include "stdafx.h"
+#include "FWI.h"
+namespace fs
+{
+/**
+ * \brief Hourly and daily weather for every scenario in a weather input file
+ */
+struct WeatherStreams
+{
+  /**
+   * \brief First day that has weather
+   */
+  Day min_date = numeric_limits<Day>::max();
+  /**
+   * \brief Last day that has weather
+   */
+  Day max_date = numeric_limits<Day>::min();
+  /**
+   * \brief Year of last row of weather
+   */
+  YearSize year = 0;
+  /**
+   * \brief Scenario for each stream, in the order they were in the file
+   */
+  vector<size_t> scenarios{};
+  /**
+   * \brief Hourly weather from start of min_date to end of max_date for each scenario
+   */
+  vector<vector<FwiWeather>> hourly{};
+  /**
+   * \brief Daily weather calculated at noon of each day for each scenario
+   */
+  vector<map<Day, FwiWeather>> daily{};
+};
+/**
+ * \brief Read weather streams from .csv or binary weather file
+ *
+ * Binary files are detected by their contents, so they don't need any specific extension.
+ * \param filename File to read
+ * \param yesterday FwiWeather for day before weather starts
+ * \param latitude Latitude to calculate daily indices for
+ * \return Weather streams in file
+ */
+[[nodiscard]] WeatherStreams read_weather_streams(
+  const string& filename,
+  const FwiWeather& yesterday,
+  MathSize latitude
+);
+/**
+ * \brief Convert .csv weather file into binary format that can be read without parsing
+ * \param file_in .csv weather file to read
+ * \param file_out Binary weather file to write
+ * \return 0 if converted successfully
+ */
+int convert_weather(const string& file_in, const string& file_out);
+}
+#endif
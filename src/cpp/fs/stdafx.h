@@ -10,9 +10,11 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <bitset>
 #include <cassert>
 #include <cerrno>
+#include <charconv>
 #include <chrono>
 #include <compare>
 #include <condition_variable>
@@ -34,7 +36,9 @@
 #include <locale>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <numeric>
 #include <random>
 #include <ranges>
 #include <regex>
@@ -45,6 +49,7 @@
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 #include <sys/stat.h>
 #include "unstable.h"
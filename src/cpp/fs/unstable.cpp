@@ -1,8 +1,246 @@
 /* SPDX-License-Identifier: AGPL-3.0-or-later */
 #include "unstable.h"
+#include <bit>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 namespace fs
 {
 MathSize cos(const MathSize angle) noexcept { return static_cast<MathSize>(std::cos(angle)); }
 MathSize sin(const MathSize angle) noexcept { return static_cast<MathSize>(std::sin(angle)); }
+// NOTE: coefficients and argument reduction follow fdlibm, but everything is written so that
+// every element goes through exactly the same operations and loops can be vectorized
+/**
+ * \brief Adding and subtracting this rounds values with magnitude < 2^51 to nearest integer,
+ * and leaves that integer in the low bits of the sum
+ */
+static constexpr MathSize SHIFTER = 0x1.8p52;
+static constexpr int64_t SHIFTER_BITS = std::bit_cast<int64_t>(SHIFTER);
+static constexpr uint64_t MANTISSA_BITS = 0x000fffffffffffffULL;
+static constexpr uint64_t ONE_BITS = 0x3ff0000000000000ULL;
+static constexpr MathSize INFINITE = std::numeric_limits<MathSize>::infinity();
+static constexpr MathSize NOT_A_NUMBER = std::numeric_limits<MathSize>::quiet_NaN();
+static constexpr MathSize LN2_HI = 6.93147180369123816490e-01;
+static constexpr MathSize LN2_LO = 1.90821492927058770002e-10;
+static constexpr MathSize LOG2_E = 1.44269504088896338700e+00;
+/**
+ * \brief Multiplying by this splits a value into halves with 26 bits each
+ */
+static constexpr MathSize SPLITTER = 0x1p27 + 1.0;
+static constexpr MathSize SQRT2 = 1.41421356237309514547e+00;
+static constexpr MathSize TWO_OVER_PI = 6.36619772367581382433e-01;
+// pi / 2 split so that multiplying first two parts by quadrant is exact for quadrant < 2^20
+static constexpr MathSize PIO2_1 = 1.57079632673412561417e+00;
+static constexpr MathSize PIO2_2 = 6.07710050630396597660e-11;
+static constexpr MathSize PIO2_3 = 2.02226624871116645580e-21;
+/**
+ * \brief Largest angle that argument reduction is accurate for
+ */
+static constexpr MathSize MAX_REDUCED_ANGLE = 1e6;
+static constexpr MathSize S1 = -1.66666666666666324348e-01;
+static constexpr MathSize S2 = 8.33333333332248946124e-03;
+static constexpr MathSize S3 = -1.98412698298579493134e-04;
+static constexpr MathSize S4 = 2.75573137070700676789e-06;
+static constexpr MathSize S5 = -2.50507602534068634195e-08;
+static constexpr MathSize S6 = 1.58969099521155010221e-10;
+static constexpr MathSize C1 = 4.16666666666666019037e-02;
+static constexpr MathSize C2 = -1.38888888888741095749e-03;
+static constexpr MathSize C3 = 2.48015872894767294178e-05;
+static constexpr MathSize C4 = -2.75573143513906633035e-07;
+static constexpr MathSize C5 = 2.08757232129817482790e-09;
+static constexpr MathSize C6 = -1.13596475577881948265e-11;
+static constexpr MathSize P1 = 1.66666666666666019037e-01;
+static constexpr MathSize P2 = -2.77777777770155933842e-03;
+static constexpr MathSize P3 = 6.61375632143793436117e-05;
+static constexpr MathSize P4 = -1.65339022054652515390e-06;
+static constexpr MathSize P5 = 4.13813679705723846039e-08;
+static constexpr MathSize LG1 = 6.666666666666735130e-01;
+static constexpr MathSize LG2 = 3.999999999940941908e-01;
+static constexpr MathSize LG3 = 2.857142874366239149e-01;
+static constexpr MathSize LG4 = 2.222219843214978396e-01;
+static constexpr MathSize LG5 = 1.818357216161805012e-01;
+static constexpr MathSize LG6 = 1.531383769920937332e-01;
+static constexpr MathSize LG7 = 1.479819860511658591e-01;
+/**
+ * \brief Values above this overflow exp()
+ */
+static constexpr MathSize EXP_MAX = 7.09782712893383973096e+02;
+/**
+ * \brief Values below this underflow exp()
+ */
+static constexpr MathSize EXP_MIN = -7.45133219101941108420e+02;
+static inline void sincos_one(const MathSize x, MathSize& sine, MathSize& cosine) noexcept
+{
+  // reduce to [-pi/4, pi/4] and remember which quadrant it was in
+  const auto t = x * TWO_OVER_PI + SHIFTER;
+  const auto j = t - SHIFTER;
+  const auto quadrant = std::bit_cast<uint64_t>(t) & 3;
+  const auto r = ((x - j * PIO2_1) - j * PIO2_2) - j * PIO2_3;
+  const auto z = r * r;
+  const auto s = r + z * r * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+  const auto p = z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+  const auto hz = 0.5 * z;
+  const auto w = 1.0 - hz;
+  const auto c = w + (((1.0 - w) - hz) + z * p);
+  sine = (0 == quadrant) ? s : ((1 == quadrant) ? c : ((2 == quadrant) ? -s : -c));
+  cosine = (0 == quadrant) ? c : ((1 == quadrant) ? -s : ((2 == quadrant) ? -c : s));
+}
+static inline MathSize exp_one(const MathSize x) noexcept
+{
+  // clamp so scaling stays in range, and fix overflow and underflow after
+  const auto v = (x > EXP_MAX) ? EXP_MAX : ((x < EXP_MIN) ? EXP_MIN : x);
+  // reduce to v = n * ln(2) + r
+  const auto t = v * LOG2_E + SHIFTER;
+  const auto n_float = t - SHIFTER;
+  const auto n = std::bit_cast<int64_t>(t) - SHIFTER_BITS;
+  const auto hi = v - n_float * LN2_HI;
+  const auto lo = n_float * LN2_LO;
+  const auto r = hi - lo;
+  const auto r_sq = r * r;
+  const auto c = r - r_sq * (P1 + r_sq * (P2 + r_sq * (P3 + r_sq * (P4 + r_sq * P5))));
+  const auto y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+  // scale by 2^n in two steps if 2^n itself would be subnormal or overflow
+  const auto is_small = n < -1021;
+  const auto is_big = n > 1023;
+  const auto bias = is_small ? 1023 + 100 : (is_big ? 1023 - 1 : 1023);
+  const auto scale = std::bit_cast<MathSize>(static_cast<uint64_t>(n + bias) << 52);
+  const auto factor = is_small ? 0x1p-100 : (is_big ? 2.0 : 1.0);
+  const auto result = y * scale * factor;
+  return (x > EXP_MAX) ? INFINITE : ((x < EXP_MIN) ? 0.0 : result);
+}
+/**
+ * \brief Split log(x) for finite x > 0 into k * ln(2) rounded to 32 bits and the rest
+ */
+static inline void log_parts(const MathSize x, MathSize& hi, MathSize& lo) noexcept
+{
+  // scale subnormal values up so exponent and mantissa can be split
+  const auto is_subnormal = x < std::numeric_limits<MathSize>::min();
+  const auto v = is_subnormal ? x * 0x1p54 : x;
+  const auto bits = std::bit_cast<uint64_t>(v);
+  // reduce to x = 2^k * m with m in [sqrt(2) / 2, sqrt(2))
+  const auto m_raw = std::bit_cast<MathSize>((bits & MANTISSA_BITS) | ONE_BITS);
+  const auto is_over = m_raw > SQRT2;
+  const auto m = is_over ? m_raw * 0.5 : m_raw;
+  const auto k = static_cast<int64_t>(bits >> 52) - (is_subnormal ? 1023 + 54 : 1023)
+               + (is_over ? 1 : 0);
+  // convert with the same trick as rounding so it doesn't depend on instruction set
+  const auto k_float = std::bit_cast<MathSize>(k + SHIFTER_BITS) - SHIFTER;
+  const auto f = m - 1.0;
+  const auto s = f / (2.0 + f);
+  const auto z = s * s;
+  const auto w = z * z;
+  const auto t1 = w * (LG2 + w * (LG4 + w * LG6));
+  const auto t2 = z * (LG1 + w * (LG3 + w * (LG5 + w * LG7)));
+  const auto r = t2 + t1;
+  const auto hfsq = 0.5 * f * f;
+  hi = k_float * LN2_HI;
+  lo = -((hfsq - (s * (hfsq + r) + k_float * LN2_LO)) - f);
+}
+static inline MathSize log_one(const MathSize x) noexcept
+{
+  MathSize hi;
+  MathSize lo;
+  log_parts(x, hi, lo);
+  // NaN fails every comparison so ends up as NaN
+  return (0.0 == x) ? -INFINITE
+       : (INFINITE == x) ? INFINITE
+       : (x > 0.0) ? hi + lo
+                    : NOT_A_NUMBER;
+}
+/**
+ * \brief Split value into two halves that can be multiplied by other halves exactly
+ */
+static inline void split(const MathSize value, MathSize& hi, MathSize& lo) noexcept
+{
+  const auto c = SPLITTER * value;
+  hi = c - (c - value);
+  lo = value - hi;
+}
+static inline MathSize pow_one(const MathSize base, const MathSize exponent) noexcept
+{
+  MathSize log_hi;
+  MathSize log_lo;
+  log_parts(base, log_hi, log_lo);
+  // log_hi is large but exact, so keep the error from multiplying it by exponent
+  const auto product = exponent * log_hi;
+  MathSize e_hi;
+  MathSize e_lo;
+  split(exponent, e_hi, e_lo);
+  MathSize l_hi;
+  MathSize l_lo;
+  split(log_hi, l_hi, l_lo);
+  const auto product_error =
+    ((e_hi * l_hi - product) + e_hi * l_lo + e_lo * l_hi) + e_lo * l_lo;
+  const auto rest = exponent * log_lo;
+  const auto sum = product + rest;
+  const auto rest_rounded = sum - product;
+  const auto sum_error = (product - (sum - rest_rounded)) + (rest - rest_rounded);
+  // exp(sum + tail) = exp(sum) * (1 + tail) since tail is tiny
+  const auto tail = product_error + sum_error;
+  const auto e = exp_one(sum);
+  // tail is meaningless if sum is already too big or small for exp()
+  const auto kept_tail = (std::abs(sum) <= -EXP_MIN) ? tail : 0.0;
+  const auto result = e + e * kept_tail;
+  // 0 and infinity to a power are 0 or infinity depending on which way the exponent goes
+  const auto extreme = ((0.0 == base) == (exponent > 0.0)) ? 0.0 : INFINITE;
+  const auto is_extreme = (0.0 == base) | (INFINITE == base);
+  // NaN fails every comparison so ends up as NaN
+  const auto value = is_extreme ? extreme : ((base > 0.0) ? result : NOT_A_NUMBER);
+  return (0.0 == exponent) ? 1.0 : value;
+}
+void vector_sincos(
+  const MathSize* const angles,
+  MathSize* const sines,
+  MathSize* const cosines,
+  const std::size_t count
+) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    sincos_one(angles[i], sines[i], cosines[i]);
+  }
+  // reduction isn't accurate enough for these, but they shouldn't happen for directions
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (!(std::abs(angles[i]) <= MAX_REDUCED_ANGLE))
+    {
+      sines[i] = fs::sin(angles[i]);
+      cosines[i] = fs::cos(angles[i]);
+    }
+  }
+}
+void vector_exp(
+  const MathSize* const values,
+  MathSize* const results,
+  const std::size_t count
+) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    results[i] = exp_one(values[i]);
+  }
+}
+void vector_log(
+  const MathSize* const values,
+  MathSize* const results,
+  const std::size_t count
+) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    results[i] = log_one(values[i]);
+  }
+}
+void vector_pow(
+  const MathSize* const bases,
+  const MathSize* const exponents,
+  MathSize* const results,
+  const std::size_t count
+) noexcept
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    results[i] = pow_one(bases[i], exponents[i]);
+  }
+}
 }
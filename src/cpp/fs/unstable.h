@@ -1,6 +1,7 @@
 /* SPDX-License-Identifier: AGPL-3.0-or-later */
 #ifndef FS_UNSTABLE_H
 #define FS_UNSTABLE_H
+#include <cstddef>
 namespace fs
 {
 /**
@@ -11,5 +12,49 @@ using MathSize = double;
 // in debug vs release version
 MathSize cos(const MathSize angle) noexcept;
 MathSize sin(const MathSize angle) noexcept;
+// Kernels for arrays of values that only use +, -, *, / and bit operations in a fixed order
+// without fusing multiply and add, so they give the same bits whether the compiler uses SSE2,
+// AVX2, AVX-512 or no vector instructions at all, and in debug vs release version.
+// Results are within a few ulp of std:: functions, but are not always identical to them.
+/**
+ * \brief Calculate sine and cosine of angles
+ * \param angles Angles (radians) - values with magnitude over 1e6 use std::sin and std::cos
+ * \param sines Array to put sine of each angle into
+ * \param cosines Array to put cosine of each angle into
+ * \param count Number of values
+ */
+void vector_sincos(
+  const MathSize* angles,
+  MathSize* sines,
+  MathSize* cosines,
+  std::size_t count
+) noexcept;
+/**
+ * \brief Calculate e raised to power of values
+ * \param values Values to calculate for
+ * \param results Array to put results into
+ * \param count Number of values
+ */
+void vector_exp(const MathSize* values, MathSize* results, std::size_t count) noexcept;
+/**
+ * \brief Calculate natural logarithm of values
+ * \param values Values to calculate for
+ * \param results Array to put results into
+ * \param count Number of values
+ */
+void vector_log(const MathSize* values, MathSize* results, std::size_t count) noexcept;
+/**
+ * \brief Calculate bases raised to power of exponents, as exp(exponent * log(base))
+ * \param bases Bases to raise to powers (must not be negative)
+ * \param exponents Exponents to raise bases to
+ * \param results Array to put results into
+ * \param count Number of values
+ */
+void vector_pow(
+  const MathSize* bases,
+  const MathSize* exponents,
+  MathSize* results,
+  std::size_t count
+) noexcept;
 }
 #endif
@@ -22,25 +22,14 @@ struct line_type
   MathSize wind;
   MathSize prcp;
 };
-int test_fwi_file(
-  const char* file_in,
-  const char* file_out,
-  const MathSize latitude = DEFAULT_LATITUDE
-)
+const vector<line_type>& read_fwi_file(const char* file_in)
 {
   string line;
   MathSize temp, rhum, wind, prcp;
   int month, day;
-  /* Initialize FMC, DMC, and DC */
-  Ffmc ffmc0{85.0};
-  Dmc dmc0{6.0};
-  Dc dc0{15.0};
-  Ffmc ffmc0_{ffmc0};
-  Dmc dmc0_{dmc0};
-  Dc dc0_{dc0};
   // HACK: load file once and buffer
   static map<string, vector<line_type>> buffered_files{};
-  auto buffer = buffered_files[file_in];
+  auto& buffer = buffered_files[file_in];
   if (buffer.empty())
   {
     /* Open input and output files */
@@ -48,7 +37,7 @@ int test_fwi_file(
     if (!inputFile.is_open())
     {
       cout << "Unable to open input data file";
-      return -1;
+      return buffer;
     }
     while (getline(inputFile, line))
     {
@@ -58,8 +47,28 @@ int test_fwi_file(
     }
     inputFile.close();
   }
-  buffered_files[file_in] = buffer;
-  assert(buffered_files[file_in].size() == buffer.size());
+  return buffer;
+}
+int test_fwi_file(
+  const char* file_in,
+  const char* file_out,
+  const MathSize latitude = DEFAULT_LATITUDE
+)
+{
+  MathSize temp, rhum, wind, prcp;
+  int month;
+  /* Initialize FMC, DMC, and DC */
+  Ffmc ffmc0{85.0};
+  Dmc dmc0{6.0};
+  Dc dc0{15.0};
+  Ffmc ffmc0_{ffmc0};
+  Dmc dmc0_{dmc0};
+  Dc dc0_{dc0};
+  const auto& buffer = read_fwi_file(file_in);
+  if (buffer.empty())
+  {
+    return -1;
+  }
   ofstream outputFile;
   if (nullptr != file_out)
   {
@@ -76,7 +85,6 @@ int test_fwi_file(
   for (auto line : buffer)
   {
     month = line.month;
-    day = line.day;
     temp = line.temp;
     rhum = line.rhum;
     wind = line.wind;
@@ -141,6 +149,115 @@ int test_fwi_file(
   }
   return 0;
 }
+/**
+ * \brief Change weather for each member so they don't all calculate the same thing
+ * \param line Weather to change
+ * \param member Member to change weather for
+ * \return Weather for member
+ */
+line_type for_member(const line_type& line, const size_t member)
+{
+  const auto m = static_cast<MathSize>(member);
+  return {
+    line.month,
+    line.day,
+    line.temp + 0.7 * static_cast<MathSize>(member % 9) - 3.0,
+    std::clamp(line.rhum * (0.7 + 0.02 * m), 0.0, 100.0),
+    line.wind * (0.4 + 0.05 * m),
+    line.prcp * 0.75 * static_cast<MathSize>(member % 4) + ((0 == member % 11) ? 2.0 : 0.0)
+  };
+}
+void set_weather(FwiColumns* columns, const size_t i, const line_type& line)
+{
+  columns->temperature[i] = line.temp;
+  columns->rh[i] = line.rhum;
+  columns->wind[i] = line.wind;
+  columns->prec[i] = line.prcp;
+}
+int test_fwi_batch(const char* file_in, const MathSize latitude)
+{
+  static constexpr size_t MEMBERS = 37;
+  // kernels are within a few ulp of std:: functions, but that can add up over days
+  static constexpr MathSize EPSILON_BATCH = 1e-9;
+  const auto& buffer = read_fwi_file(file_in);
+  if (buffer.empty())
+  {
+    return -1;
+  }
+  FwiColumns daily{MEMBERS};
+  FwiColumns hourly{MEMBERS};
+  // calculate last member by itself too, since it shouldn't matter what other members do
+  FwiColumns single{1};
+  vector<Ffmc> ffmc(MEMBERS, Ffmc{85.0});
+  vector<Dmc> dmc(MEMBERS, Dmc{6.0});
+  vector<Dc> dc(MEMBERS, Dc{15.0});
+  vector<Ffmc> ffmc_hourly{ffmc};
+  for (auto* c : {&daily, &hourly, &single})
+  {
+    std::ranges::fill(c->ffmc, ffmc[0].value);
+    std::ranges::fill(c->dmc, dmc[0].value);
+    std::ranges::fill(c->dc, dc[0].value);
+  }
+  const auto check_same = [](const vector<MathSize>& lhs, const MathSize rhs, const char* name) {
+    logging::check_fatal(
+      lhs[MEMBERS - 1] != rhs,
+      "Batch {:s} depends on other members: {:g} vs {:g}",
+      name,
+      lhs[MEMBERS - 1],
+      rhs
+    );
+  };
+  for (const auto& line : buffer)
+  {
+    for (size_t i = 0; i < MEMBERS; ++i)
+    {
+      const auto wx = for_member(line, i);
+      set_weather(&daily, i, wx);
+      set_weather(&hourly, i, wx);
+    }
+    set_weather(&single, 0, for_member(line, MEMBERS - 1));
+    calculate_daily(&daily, line.month, latitude);
+    calculate_daily(&single, line.month, latitude);
+    // use each day as an hour, with the build-up index from that day
+    hourly.bui = daily.bui;
+    calculate_hourly(&hourly);
+    for (size_t i = 0; i < MEMBERS; ++i)
+    {
+      const auto wx = for_member(line, i);
+      const Temperature temp{wx.temp};
+      const RelativeHumidity rhum{wx.rhum};
+      const Speed wind{wx.wind};
+      const Precipitation prcp{wx.prcp};
+      ffmc[i] = Ffmc{temp, rhum, wind, prcp, ffmc[i]};
+      dmc[i] = Dmc{temp, rhum, prcp, dmc[i], line.month, latitude};
+      dc[i] = Dc{temp, prcp, dc[i], line.month, latitude};
+      const Isi isi{wind, ffmc[i]};
+      const Bui bui{dmc[i], dc[i]};
+      logging::check_tolerance(EPSILON_BATCH, daily.ffmc[i], ffmc[i].value, "batch ffmc");
+      logging::check_tolerance(EPSILON_BATCH, daily.dmc[i], dmc[i].value, "batch dmc");
+      logging::check_tolerance(EPSILON_BATCH, daily.dc[i], dc[i].value, "batch dc");
+      logging::check_tolerance(EPSILON_BATCH, daily.isi[i], isi.value, "batch isi");
+      logging::check_tolerance(EPSILON_BATCH, daily.bui[i], bui.value, "batch bui");
+      logging::check_tolerance(EPSILON_BATCH, daily.fwi[i], Fwi{isi, bui}.value, "batch fwi");
+      ffmc_hourly[i] = hourly_ffmc(temp, rhum, wind, prcp, ffmc_hourly[i]);
+      const Isi isi_hourly{wind, ffmc_hourly[i]};
+      logging::check_tolerance(
+        EPSILON_BATCH, hourly.ffmc[i], ffmc_hourly[i].value, "batch hourly ffmc"
+      );
+      logging::check_tolerance(EPSILON_BATCH, hourly.isi[i], isi_hourly.value, "batch hourly isi");
+      logging::check_tolerance(
+        EPSILON_BATCH, hourly.fwi[i], Fwi{isi_hourly, bui}.value, "batch hourly fwi"
+      );
+    }
+    check_same(daily.ffmc, single.ffmc[0], "ffmc");
+    check_same(daily.dmc, single.dmc[0], "dmc");
+    check_same(daily.dc, single.dc[0], "dc");
+    check_same(daily.isi, single.isi[0], "isi");
+    check_same(daily.bui, single.bui[0], "bui");
+    check_same(daily.fwi, single.fwi[0], "fwi");
+  }
+  return 0;
+}
 int compare_files(const string file0, const string file1)
 {
   logging::info("Comparing {:s} to {:s}", file0, file1);
@@ -204,6 +321,7 @@ int test_fwi(const int argc, const char* const argv[])
   constexpr auto LATITUDE_MIN{-90.0};
   constexpr auto LATITUDE_MAX{90.0};
   constexpr auto STEP{0.001};
+  constexpr auto STEP_BATCH{0.5};
   make_directory_recursive("test/output/fwi");
   if (const auto ret = test_fwi_files(FILE_EXPECTED, FILE_IN, FILE_OUT); 0 != ret)
   {
@@ -233,6 +351,20 @@ int test_fwi(const int argc, const char* const argv[])
   {
     return ret;
   }
+  logging::info(
+    "Testing batch calculations across latitude range [{:+g}, {:+g}] with step {:g}",
+    LATITUDE_MIN,
+    LATITUDE_MAX,
+    STEP_BATCH
+  );
+  for (auto i = 0; LATITUDE_MIN + i * STEP_BATCH <= LATITUDE_MAX; ++i)
+  {
+    if (auto ret = test_fwi_batch(FILE_IN, LATITUDE_MIN + i * STEP_BATCH); 0 != ret)
+    {
+      logging::error("Batch calculation from {:s} failed", FILE_IN);
+      return ret;
+    }
+  }
   logging::note("Testing FWI calculations succeeded");
   return 0;
 }
@@ -0,0 +1,95 @@
+#!/bin/bash
+# check that stopping a run and resuming it from a checkpoint gives the same results as not stopping
+IS_PASTED=
+if [[ "$0" =~ "/bash" ]]; then
+  DIR_TEST=`realpath test`
+  IS_PASTED=1
+else
+  set -e
+  DIR_TEST="$(dirname $(realpath "$0"))"
+fi
+DIR_ROOT=$(dirname "${DIR_TEST}")
+DIR_SUB=hourly
+DIR_IN="${DIR_TEST}/input/${DIR_SUB}"
+DIR_OUT="${DIR_TEST}/output/resume"
+DIR_FULL="${DIR_OUT}/full"
+DIR_STOPPED="${DIR_OUT}/stopped"
+DIR_RESUMED="${DIR_OUT}/resumed"
+
+# stop first part of run once this many simulations are done
+STOP_AFTER=20
+
+DAYS="$1"
+if ( [ -z "${DAYS}" ] || ( [[ "${DAYS}" != +([0-9]) ]] ) ); then
+  DAYS=3
+else
+  shift;
+fi
+echo "DAYS=${DAYS}"
+
+pushd ${DIR_ROOT}
+git restore settings.ini
+
+scripts/build.sh Release
+
+# HACK: original latitude is giving 1ha fire in current fuel grids
+latitude=52.02
+longitude=-89.024
+dates="[$(seq -s, ${DAYS})]"
+FILE_WX="${DIR_IN}/wx_hourly_in.csv"
+
+run() {
+  dir_out="$1"
+  shift
+  mkdir -p "${dir_out}"
+  # only save checkpoint at end so nothing depends on how long the run takes
+  ./firestarr "${dir_out}" \
+    2017-08-27 \
+    ${latitude} \
+    ${longitude} \
+    12:15 \
+    --ffmc 90 \
+    --dmc 40 \
+    --dc 300 \
+    --apcp_prev 0 \
+    --wx "${FILE_WX}" \
+    --output_date_offsets "${dates}" \
+    --tz -5 \
+    --checkpoint 86400 \
+    $* > "${dir_out}.log" 2>&1
+}
+# number of iterations still needed after each iteration, in order
+runs_left() {
+  grep "Need another [0-9]* iterations" "$1" | sed "s/.*Need another \([0-9]*\) iterations.*/\1/"
+}
+
+rm -rf "${DIR_OUT}"
+run "${DIR_FULL}"
+sed -i "s/^MAXIMUM_SIMULATIONS = .*/MAXIMUM_SIMULATIONS = ${STOP_AFTER}/" settings.ini
+run "${DIR_STOPPED}"
+git restore settings.ini
+run "${DIR_RESUMED}" --resume "${DIR_STOPPED}/checkpoint.fsc"
+
+stopped=$(grep "Saved checkpoint after [0-9]* iterations" "${DIR_STOPPED}.log" \
+  | sed "s/.*Saved checkpoint after \([0-9]*\) iterations.*/\1/" | tail -n1)
+echo "Stopped after ${stopped} iterations"
+# resuming decides again for the last iteration that was done before stopping
+expected=$(runs_left "${DIR_FULL}.log" | tail -n +${stopped})
+actual=$(runs_left "${DIR_RESUMED}.log")
+result=0
+if [ "${expected}" != "${actual}" ]; then
+  echo "Iterations left after resuming don't match"
+  echo "expected: " ${expected}
+  echo "actual:   " ${actual}
+  result=1
+fi
+if ! diff -r -q -x "*.log" -x "checkpoint.fsc*" -x "settings.ini" "${DIR_FULL}" "${DIR_RESUMED}"; then
+  echo "Outputs after resuming don't match"
+  result=1
+fi
+if [ 0 -eq ${result} ]; then
+  echo "Resumed run matches run that wasn't stopped"
+fi
+
+popd
+exit ${result}
@@ -0,0 +1,76 @@
+#!/bin/bash
+# compare number of simulations needed to reach confidence with independent vs stratified thresholds
+IS_PASTED=
+if [[ "$0" =~ "/bash" ]]; then
+  DIR_TEST=`realpath test`
+  IS_PASTED=1
+else
+  set -e
+  DIR_TEST="$(dirname $(realpath "$0"))"
+fi
+DIR_ROOT=$(dirname "${DIR_TEST}")
+DIR_SUB=hourly
+DIR_IN="${DIR_TEST}/input/${DIR_SUB}"
+DIR_OUT="${DIR_TEST}/output/strata"
+
+CONFIDENCE=0.1
+# strata to compare against independent sampling (1)
+STRATA="1 8 16 32"
+# salts to average over since each run is just one sample of how many runs are needed
+SALTS="0 1 2 3 4"
+
+DAYS="$1"
+if ( [ -z "${DAYS}" ] || ( [[ "${DAYS}" != +([0-9]) ]] ) ); then
+  DAYS=3
+else
+  shift;
+fi
+echo "DAYS=${DAYS}"
+
+pushd ${DIR_ROOT}
+git restore settings.ini
+
+scripts/build.sh Release
+
+# HACK: original latitude is giving 1ha fire in current fuel grids
+latitude=52.02
+longitude=-89.024
+dates="[$(seq -s, ${DAYS})]"
+FILE_WX="${DIR_IN}/wx_hourly_in.csv"
+
+printf '# %6s  # %-40s  # %8s\n' "strata" "simulations by salt" "mean"
+for strata in ${STRATA}; do
+  OUT_SIMS=""
+  total=0
+  count=0
+  for salt in ${SALTS}; do
+    rm -rf "${DIR_OUT}"
+    mkdir -p "${DIR_OUT}"
+    output=$(./firestarr "${DIR_OUT}" \
+      2017-08-27 \
+      ${latitude} \
+      ${longitude} \
+      12:15 \
+      --no-intensity \
+      --no-probability \
+      --ffmc 90 \
+      --dmc 40 \
+      --dc 300 \
+      --apcp_prev 0 \
+      --wx "${FILE_WX}" \
+      --output_date_offsets "${dates}" \
+      --tz -5 \
+      --confidence ${CONFIDENCE} \
+      --strata ${strata} \
+      --salt ${salt} \
+      $* 2>&1)
+    sims=$(echo "${output}" | grep "Ran [0-9]* simulations" | sed "s/.*Ran \([0-9]*\) simulations.*/\1/" | tail -n1)
+    OUT_SIMS="${OUT_SIMS}$(printf '%8s' ${sims})"
+    total=$((total + sims))
+    count=$((count + 1))
+  done
+  printf '# %6s  # %-40s  # %8s\n' "${strata}" "${OUT_SIMS}" "$((total / count))"
+done
+rm -rf "${DIR_OUT}"
+
+popd
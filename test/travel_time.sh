@@ -0,0 +1,90 @@
+#!/bin/bash
+# check travel time is refused for probabilistic runs and burns about as much as spreading points
+IS_PASTED=
+if [[ "$0" =~ "/bash" ]]; then
+  DIR_TEST=`realpath test`
+  IS_PASTED=1
+else
+  DIR_TEST="$(dirname $(realpath "$0"))"
+fi
+DIR_ROOT=$(dirname "${DIR_TEST}")
+DIR_SUB=hourly
+DIR_IN="${DIR_TEST}/input/${DIR_SUB}"
+DIR_OUT="${DIR_TEST}/output/travel_time"
+DIR_REFUSED="${DIR_OUT}/refused"
+DIR_POINTS="${DIR_OUT}/points"
+DIR_TRAVEL="${DIR_OUT}/travel"
+
+# fire sizes can differ by this fraction of size from spreading points
+TOLERANCE=0.2
+
+DAYS="$1"
+if ( [ -z "${DAYS}" ] || ( [[ "${DAYS}" != +([0-9]) ]] ) ); then
+  DAYS=3
+else
+  shift;
+fi
+echo "DAYS=${DAYS}"
+
+pushd ${DIR_ROOT}
+git restore settings.ini
+
+scripts/build.sh Release || exit $?
+
+# HACK: original latitude is giving 1ha fire in current fuel grids
+latitude=52.02
+longitude=-89.024
+dates="[$(seq -s, ${DAYS})]"
+FILE_WX="${DIR_IN}/wx_hourly_in.csv"
+
+run() {
+  dir_out="$1"
+  shift
+  mkdir -p "${dir_out}"
+  ./firestarr "${dir_out}" \
+    2017-08-27 \
+    ${latitude} \
+    ${longitude} \
+    12:15 \
+    --ffmc 90 \
+    --dmc 40 \
+    --dc 300 \
+    --apcp_prev 0 \
+    --wx "${FILE_WX}" \
+    --output_date_offsets "${dates}" \
+    --tz -5 \
+    $* > "${dir_out}.log" 2>&1
+}
+# total size of all scenarios for last output date
+total_size() {
+  file_sizes=$(ls -1 "$1"/sizes_*.csv | sort | tail -n1)
+  awk '{ total += $1 } END { printf "%f\n", total }' "${file_sizes}"
+}
+
+rm -rf "${DIR_OUT}"
+result=0
+if run "${DIR_REFUSED}" --travel-time; then
+  echo "Probabilistic run with travel time wasn't refused"
+  result=1
+fi
+time_points=$(date +%s)
+run "${DIR_POINTS}" --deterministic || result=1
+time_travel=$(date +%s)
+run "${DIR_TRAVEL}" --deterministic --travel-time || result=1
+time_done=$(date +%s)
+
+size_points=$(total_size "${DIR_POINTS}")
+size_travel=$(total_size "${DIR_TRAVEL}")
+echo "Spreading points burned ${size_points} ha in $((time_travel - time_points)) s"
+echo "Travel time burned ${size_travel} ha in $((time_done - time_travel)) s"
+if ! awk -v a="${size_points}" -v b="${size_travel}" -v t="${TOLERANCE}" \
+  'BEGIN { d = a - b; if (d < 0) d = -d; exit !(0 < a && d <= t * a) }'; then
+  echo "Travel time size isn't within ${TOLERANCE} of spreading points"
+  result=1
+fi
+if [ 0 -eq ${result} ]; then
+  echo "Travel time matches spreading points"
+fi
+
+popd
+exit ${result}